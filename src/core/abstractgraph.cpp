@@ -18,8 +18,11 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "abstractgraph.h"
 #include "constants.h"
+#include "graphsnapshot.h"
 #include "utils.h"
 
 namespace evoplex {
@@ -36,18 +39,69 @@ AbstractGraph::AbstractGraph(const QString& name)
       m_name(name),
       m_type(Invalid_Type),
       m_lastNodeId(-1),
-      m_lastEdgeId(-1)
+      m_lastEdgeId(-1),
+      m_arena(std::make_shared<Arena>()),
+      m_edgePool(m_arena.get(), &m_edgeHists),
+      m_topologyCache(nullptr)
+{
+    m_edges = Edges(m_arena);
+}
+
+AbstractGraph::~AbstractGraph()
 {
+    // nodes which outlive the graph (e.g., held by the GUI)
+    // take a copy of their attributes back from the column store,
+    // and drop their edges, which are released with the edge pool
+    m_csr.clear();
+    std::vector<NodePtr>().swap(m_rows);
+    for (auto const& p : m_nodes) {
+        if (p.second.use_count() > 1) {
+            p.second->unbind();
+            p.second->clearInEdges();
+            p.second->clearOutEdges();
+        }
+    }
 }
 
-bool AbstractGraph::setup(PRG* prg, const Attributes* attrs, Nodes& nodes, const QString& graphType)
+bool AbstractGraph::setup(PRG* prg, const Attributes* attrs, Nodes& nodes,
+                          const QString& graphType, const AttributesScope& edgeAttrsScope,
+                          const AttributeColumns& nodeAttrs)
 {
     Q_ASSERT_X(nodes.size() < EVOPLEX_MAX_NODES, "setup", "too many nodes! we cannot handle this.");
     if (AbstractPlugin::setup(prg, attrs)) {
         m_nodes = nodes;
+
+        // rows follow the ascending order of the node ids
+        std::vector<int> ids;
+        ids.reserve(nodes.size());
+        for (auto const& p : nodes) {
+            ids.emplace_back(p.first);
+        }
+        std::sort(ids.begin(), ids.end());
+        m_rows.reserve(ids.size());
+        if (nodeAttrs.numRows() > 0) {
+            Q_ASSERT_X(nodeAttrs.numRows() == static_cast<int>(ids.size()), "setup",
+                       "there must be one row of attributes per node");
+            m_nodeColumns = nodeAttrs;
+            for (int id : ids) {
+                const NodePtr& node = m_nodes.at(id);
+                node->bind(&m_nodeColumns, static_cast<int>(m_rows.size()));
+                m_rows.emplace_back(node);
+            }
+        } else {
+            for (int id : ids) {
+                bindNode(m_nodes.at(id));
+            }
+        }
+
+        m_edgeAttrs.resize(edgeAttrsScope.size());
+        for (const AttributeRange* attrRange : edgeAttrsScope) {
+            m_edgeAttrs.replace(attrRange->id(), attrRange->attrName(), attrRange->min());
+        }
+
         m_type = enumFromString(graphType);
         m_typeStr = graphType;
-        m_lastNodeId = static_cast<int>(nodes.size());
+        m_lastNodeId = ids.empty() ? -1 : ids.back();
     }
     return !m_nodes.empty() && m_type != Invalid_Type;
 }
@@ -55,56 +109,152 @@ bool AbstractGraph::setup(PRG* prg, const Attributes* attrs, Nodes& nodes, const
 NodePtr AbstractGraph::addNode(Attributes attr, int x, int y)
 {
     QMutexLocker locker(&m_mutex);
+    m_csr.clear();
     ++m_lastNodeId;
     NodePtr node;
     if (type() == Undirected) {
-        node = std::make_shared<UNode>(m_lastNodeId, attr, x, y);
+        node = makeNode<UNode>(m_arena, m_lastNodeId, attr, x, y);
     } else {
-        node = std::make_shared<DNode>(m_lastNodeId, attr, x, y);
+        node = makeNode<DNode>(m_arena, m_lastNodeId, attr, x, y);
     }
     m_nodes.insert({m_lastNodeId, node});
+    bindNode(node);
     return node;
 }
 
 EdgePtr AbstractGraph::addEdge(const NodePtr& origin, const NodePtr& neighbour, Attributes* attrs)
 {
     QMutexLocker locker(&m_mutex);
+    m_csr.clear();
+    return insertEdge(origin, neighbour, attrs);
+}
+
+void AbstractGraph::addEdges(const EdgeList& edges)
+{
+    QMutexLocker locker(&m_mutex);
+    m_csr.clear();
+    m_edges.reserve(m_edges.size() + edges.size());
+
+    // sizing the maps of the nodes upfront avoids rehashing them over and over
+    std::unordered_map<int, std::pair<int, int>> degrees; // id -> (in, out)
+    for (int i = 0; i < edges.size(); ++i) {
+        ++degrees[edges.origin(i)].second;
+        ++degrees[edges.target(i)].first;
+    }
+    for (auto const& d : degrees) {
+        m_nodes.at(d.first)->reserveEdges(d.second.first, d.second.second);
+    }
+
+    // (attribute id, column of the list)
+    std::vector<std::pair<int, int>> attrCols;
+    for (int id = 0; id < m_edgeAttrs.size(); ++id) {
+        const int col = edges.attrs().indexOf(m_edgeAttrs.name(id));
+        if (col >= 0 && edges.attrs().type(col) == m_edgeAttrs.value(id).type()) {
+            attrCols.emplace_back(id, col);
+        }
+    }
+
+    for (int i = 0; i < edges.size(); ++i) {
+        Attributes* attrs = nullptr;
+        if (!attrCols.empty()) {
+            attrs = new Attributes(m_edgeAttrs);
+            for (auto const& c : attrCols) {
+                attrs->setValue(c.first, edges.attrs().value(i, c.second));
+            }
+        }
+        insertEdge(m_nodes.at(edges.origin(i)), m_nodes.at(edges.target(i)), attrs);
+    }
+}
+
+EdgePtr AbstractGraph::insertEdge(const NodePtr& origin, const NodePtr& neighbour, Attributes* attrs)
+{
     ++m_lastEdgeId;
-    EdgePtr edgeOut = std::make_shared<Edge>(m_lastEdgeId, origin, neighbour, attrs, true);
-    EdgePtr edgeIn = std::make_shared<Edge>(m_lastEdgeId, neighbour, origin, attrs, false);
+    // the edge refers to the nodes stored in m_nodes, which are stable
+    const NodePtr* o = &m_nodes.at(origin->id());
+    const NodePtr* n = &m_nodes.at(neighbour->id());
+    Edge* edge;
+    if (attrs) {
+        edge = m_edgePool.create(m_lastEdgeId, o, n, attrs, true);
+    } else {
+        edge = m_edgePool.create(m_lastEdgeId, o, n,
+                m_edgeAttrs.isEmpty() ? nullptr : &m_edgeAttrs, false);
+    }
+    EdgePtr edgeOut(edge, false);
     origin->addOutEdge(edgeOut);
-    neighbour->addInEdge(edgeIn); // neighbour must be aware of the in-connection
+    neighbour->addInEdge(EdgePtr(edge, true)); // neighbour must be aware of the in-connection
     m_edges.insert({m_lastEdgeId, edgeOut}); // store only the original direction
     return edgeOut;
 }
 
+void AbstractGraph::setEdgeHistogramEnabled(int attrId, bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!enabled) {
+        m_edgeHists.untrack(attrId);
+        return;
+    } else if (m_edgeHists.isTracked(attrId)) {
+        return;
+    }
+    m_edgeHists.track(attrId);
+    for (auto const& p : m_edges) {
+        if (p.second->attrs()) {
+            m_edgeHists.add(attrId, p.second->attr(attrId));
+        }
+    }
+}
+
+bool AbstractGraph::saveToFile(const QString& filePath, QString* errMsg)
+{
+    QMutexLocker locker(&m_mutex);
+    std::vector<NodePtr> nodes;
+    nodes.reserve(m_nodes.size());
+    for (auto const& p : m_nodes) {
+        nodes.emplace_back(p.second);
+    }
+    std::sort(nodes.begin(), nodes.end(),
+              [](const NodePtr& a, const NodePtr& b) { return a->id() < b->id(); });
+
+    std::vector<EdgePtr> edges;
+    edges.reserve(m_edges.size());
+    for (auto const& p : m_edges) {
+        edges.emplace_back(p.second);
+    }
+    return GraphSnapshot::save(filePath, isDirected(), nodes, edges, errMsg);
+}
+
 void AbstractGraph::removeAllEdges()
 {
     QMutexLocker locker(&m_mutex);
+    m_csr.clear();
     for (auto const& p : m_nodes) {
         p.second->clearInEdges();
         p.second->clearOutEdges();
     }
     m_edges.clear();
+    m_edgePool.clear();
 }
 
 void AbstractGraph::removeAllEdges(const NodePtr& node)
 {
     QMutexLocker locker(&m_mutex);
+    m_csr.clear();
     if (type() == Undirected) {
         for (auto const& p : node->outEdges()) {
             p.second->neighbour()->removeInEdge(p.first);
             m_edges.erase(p.first);
+            m_edgePool.destroy(p.second.get());
         }
         node->clearOutEdges();
     } else if (type() == Directed) {
         for (auto const& p : node->outEdges()) {
             p.second->neighbour()->removeInEdge(p.first);
             m_edges.erase(p.first);
+            m_edgePool.destroy(p.second.get());
         }
         for (auto const& p : node->inEdges()) {
             p.second->neighbour()->removeOutEdge(p.first);
             m_edges.erase(p.first);
+            m_edgePool.destroy(p.second.get());
         }
         node->clearInEdges();
         node->clearOutEdges();
@@ -117,31 +267,87 @@ void AbstractGraph::removeNode(const NodePtr& node)
 {
     removeAllEdges(node);
     QMutexLocker locker(&m_mutex);
-    m_nodes.erase(node->id());
+    const int id = node->id();
+    unbindNode(node.get());
+    m_nodes.erase(id);
 }
 
 Nodes::iterator AbstractGraph::removeNode(Nodes::iterator it)
 {
     removeAllEdges((*it).second);
     QMutexLocker locker(&m_mutex);
+    unbindNode((*it).second.get());
     return m_nodes.erase(it);
 }
 
 void AbstractGraph::removeEdge(const EdgePtr& edge)
 {
     QMutexLocker locker(&m_mutex);
-    edge->origin()->removeOutEdge(edge->id());
-    edge->neighbour()->removeInEdge(edge->id());
-    m_edges.erase(edge->id());
+    m_csr.clear();
+    // 'edge' might be seen from the neighbour or be stored in one of the
+    // maps we are about to change, so we take the original direction
+    const EdgePtr e(edge.get(), false);
+    e->origin()->removeOutEdge(e->id());
+    e->neighbour()->removeInEdge(e->id());
+    m_edges.erase(e->id());
+    m_edgePool.destroy(e.get());
 }
 
 Edges::iterator AbstractGraph::removeEdge(Edges::iterator it)
 {
     QMutexLocker locker(&m_mutex);
-    const EdgePtr& edge = (*it).second;
-    edge->origin()->removeOutEdge(edge->id());
-    edge->neighbour()->removeInEdge(edge->id());
-    return m_edges.erase(it);
+    m_csr.clear();
+    const EdgePtr e = (*it).second;
+    e->origin()->removeOutEdge(e->id());
+    e->neighbour()->removeInEdge(e->id());
+    it = m_edges.erase(it);
+    m_edgePool.destroy(e.get());
+    return it;
+}
+
+EdgeListPtr AbstractGraph::readEdgeList(const QString& filePath, QString* errMsg) const
+{
+    if (m_topologyCache) {
+        return m_topologyCache->edges(filePath, m_type, numNodes(), errMsg);
+    }
+
+    QString error;
+    EdgeListPtr edges = std::make_shared<const EdgeList>(
+                EdgeList::fromFile(filePath, numNodes(), &error));
+    if (!error.isEmpty()) {
+        if (errMsg) {
+            *errMsg = error;
+        }
+        return EdgeListPtr();
+    }
+    return edges;
+}
+
+void AbstractGraph::freeze()
+{
+    QMutexLocker locker(&m_mutex);
+    m_csr.build(m_rows, isDirected());
+}
+
+void AbstractGraph::bindNode(const NodePtr& node)
+{
+    node->bind(&m_nodeColumns);
+    Q_ASSERT(node->m_row == static_cast<int>(m_rows.size()));
+    m_rows.emplace_back(node);
+}
+
+void AbstractGraph::unbindNode(Node* node)
+{
+    m_csr.clear();
+    const int row = node->m_row;
+    const int last = static_cast<int>(m_rows.size()) - 1;
+    node->unbind();
+    m_nodeColumns.removeRow(row);
+    if (row != last) {
+        m_rows[row] = std::move(m_rows[last]);
+        m_rows[row]->m_row = row;
+    }
+    m_rows.pop_back();
 }
 
 } // evoplex
@@ -0,0 +1,91 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdint>
+
+#include "arena.h"
+
+namespace evoplex {
+
+const size_t Arena::kMinBlockSize;
+const size_t Arena::kMaxBlockSize;
+const size_t Arena::kGranularity;
+const size_t Arena::kNumFreeLists;
+
+Arena::~Arena()
+{
+    for (char* block : m_blocks) {
+        ::operator delete(block);
+    }
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment)
+{
+    bytes = std::max(bytes, kGranularity);
+    QMutexLocker locker(&m_mutex);
+    const size_t cls = (bytes - 1) / kGranularity;
+    if (cls < kNumFreeLists) {
+        // the free blocks are only aligned to the granularity
+        FreeBlock* b = alignment <= kGranularity ? m_freeLists[cls] : nullptr;
+        if (b) {
+            m_freeLists[cls] = b->next;
+            return b;
+        }
+        // rounded up to the size of its class, as deallocate() puts it there
+        return allocateFromBlock((cls + 1) * kGranularity, std::max(alignment, kGranularity));
+    }
+    return allocateFromBlock(bytes, alignment);
+}
+
+void Arena::deallocate(void* p, size_t bytes)
+{
+    // larger blocks are only freed with the arena
+    bytes = std::max(bytes, kGranularity);
+    const size_t cls = (bytes - 1) / kGranularity;
+    if (p && cls < kNumFreeLists) {
+        QMutexLocker locker(&m_mutex);
+        FreeBlock* b = static_cast<FreeBlock*>(p);
+        b->next = m_freeLists[cls];
+        m_freeLists[cls] = b;
+    }
+}
+
+void* Arena::allocateFromBlock(size_t bytes, size_t alignment)
+{
+    std::uintptr_t p = reinterpret_cast<std::uintptr_t>(m_head);
+    p = (p + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    if (!m_head || p + bytes > reinterpret_cast<std::uintptr_t>(m_end)) {
+        // blocks grow geometrically; a large request gets a block of its own
+        const size_t size = std::max(m_nextBlockSize, bytes + alignment);
+        m_nextBlockSize = std::min(m_nextBlockSize * 2, kMaxBlockSize);
+        char* block = static_cast<char*>(::operator new(size));
+        m_blocks.emplace_back(block);
+        m_bytes += size;
+        m_head = block;
+        m_end = block + size;
+        p = reinterpret_cast<std::uintptr_t>(m_head);
+        p = (p + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    }
+    m_head = reinterpret_cast<char*>(p + bytes);
+    return reinterpret_cast<void*>(p);
+}
+
+} // evoplex
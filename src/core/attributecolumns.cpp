@@ -0,0 +1,252 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtDebug>
+#include <cstring>
+
+#include "attributecolumns.h"
+
+namespace evoplex {
+
+int AttributeColumns::appendRow(const Attributes& attrs)
+{
+    if (m_numRows == 0) {
+        m_names = attrs.names();
+        m_index.clear();
+        m_utf8Index.clear();
+        for (int col = 0; col < attrs.size(); ++col) {
+            m_index.insert(m_names[col], col);
+            m_utf8Index.insert(m_names[col].toUtf8(), col);
+        }
+        if (numColumns() != attrs.size()) {
+            m_hists.clear();
+        }
+        m_columns.clear();
+        m_columns.resize(attrs.size());
+        for (int col = 0; col < attrs.size(); ++col) {
+            Column& c = m_columns[col];
+            c.type = attrs.value(col).type();
+            c.doubleBuffered = false;
+            c.bytes = std::make_shared<std::vector<char>>();
+            c.mappedSize = 0;
+            c.values = std::make_shared<Values>();
+            switch (c.type) {
+            case Value::BOOL: c.width = sizeof(bool); break;
+            case Value::CHAR: c.width = sizeof(char); break;
+            case Value::INT: c.width = sizeof(int); break;
+            case Value::DOUBLE: c.width = sizeof(double); break;
+            default: c.width = 0;
+            }
+        }
+    }
+
+    Q_ASSERT_X(attrs.size() == numColumns(), "AttributeColumns::appendRow",
+               "all rows must have the same number of attributes");
+
+    const int row = m_numRows++;
+    for (int col = 0; col < numColumns(); ++col) {
+        Column& c = m_columns[col];
+        if (c.width) {
+            std::vector<char>& b = bytes(c);
+            b.resize(b.size() + c.width);
+            write(row, col, attrs.value(col));
+            if (c.doubleBuffered) {
+                c.back.insert(c.back.end(), b.end() - c.width, b.end());
+            }
+        } else {
+            values(c).emplace_back(attrs.value(col));
+        }
+        if (m_hists.isTracked(col)) {
+            m_hists.add(col, value(row, col));
+        }
+    }
+    return row;
+}
+
+AttributeColumns::Column& AttributeColumns::addColumn(const QString& name,
+                                                     Value::Type type, int numRows)
+{
+    Q_ASSERT_X(!m_index.contains(name), "AttributeColumns::appendColumn",
+               "the columns must have unique names");
+    Q_ASSERT_X(m_columns.empty() || numRows == m_numRows, "AttributeColumns::appendColumn",
+               "all columns must have the same number of rows");
+    m_numRows = numRows;
+    m_index.insert(name, numColumns());
+    m_utf8Index.insert(name.toUtf8(), numColumns());
+    m_names.emplace_back(name);
+    m_columns.emplace_back();
+
+    Column& c = m_columns.back();
+    c.type = type;
+    c.doubleBuffered = false;
+    c.bytes = std::make_shared<std::vector<char>>();
+    c.values = std::make_shared<Values>();
+    c.mappedSize = 0;
+    switch (c.type) {
+    case Value::BOOL: c.width = sizeof(bool); break;
+    case Value::CHAR: c.width = sizeof(char); break;
+    case Value::INT: c.width = sizeof(int); break;
+    case Value::DOUBLE: c.width = sizeof(double); break;
+    default: c.width = 0;
+    }
+    return c;
+}
+
+void AttributeColumns::appendColumn(const QString& name, Value::Type type, const char* rows,
+                                    int numRows, const std::shared_ptr<const void>& owner)
+{
+    Column& c = addColumn(name, type, numRows);
+    Q_ASSERT_X(c.width, "AttributeColumns::appendColumn",
+               "only fixed-width columns can be read in place");
+    // shares the ownership of 'owner', but points to 'rows'
+    c.mapped = std::shared_ptr<const char>(owner, rows);
+    c.mappedSize = numRows * c.width;
+}
+
+void AttributeColumns::appendColumn(const QString& name, Value::Type type, const Values& values)
+{
+    const int numRows = static_cast<int>(values.size());
+    Column& c = addColumn(name, type, numRows);
+    if (!c.width) {
+        *c.values = values;
+        return;
+    }
+    c.bytes->resize(numRows * c.width);
+    const int col = numColumns() - 1;
+    for (int row = 0; row < numRows; ++row) {
+        write(row, col, values[row]);
+    }
+}
+
+void AttributeColumns::appendColumn(const AttributeColumns& other, int col)
+{
+    const Column& o = other.m_columns.at(col);
+    Column& c = addColumn(other.name(col), o.type, other.numRows());
+    c.bytes = o.bytes;
+    c.values = o.values;
+    c.mapped = o.mapped;
+    c.mappedSize = o.mappedSize;
+}
+
+void AttributeColumns::removeRow(int row)
+{
+    Q_ASSERT_X(row >= 0 && row < m_numRows, "AttributeColumns::removeRow", "row out of range");
+    for (int col : m_hists.tracked()) {
+        m_hists.remove(col, value(row, col));
+    }
+
+    const int last = --m_numRows;
+    for (Column& c : m_columns) {
+        if (c.width) {
+            std::vector<char>& b = bytes(c);
+            if (row != last) {
+                std::memcpy(b.data() + row * c.width, b.data() + last * c.width, c.width);
+            }
+            b.resize(last * c.width);
+            if (c.doubleBuffered) {
+                if (row != last) {
+                    std::memcpy(c.back.data() + row * c.width,
+                                c.back.data() + last * c.width, c.width);
+                }
+                c.back.resize(last * c.width);
+            }
+        } else {
+            Values& v = values(c);
+            if (row != last) {
+                v[row] = v[last];
+            }
+            v.pop_back();
+        }
+    }
+}
+
+void AttributeColumns::setDoubleBuffered(int col, bool enabled)
+{
+    Column& c = m_columns.at(col);
+    if (!enabled) {
+        std::vector<char>().swap(c.back);
+    } else if (!c.doubleBuffered) {
+        Q_ASSERT_X(c.width, "AttributeColumns::setDoubleBuffered",
+                   "only fixed-width columns can be double-buffered");
+        c.back.assign(constBytes(c), constBytes(c) + m_numRows * c.width);
+    }
+    c.doubleBuffered = enabled && c.width;
+}
+
+void AttributeColumns::swapBuffers()
+{
+    for (int col = 0; col < numColumns(); ++col) {
+        Column& c = m_columns[col];
+        if (c.doubleBuffered) {
+            bytes(c).swap(c.back);
+            if (m_hists.isTracked(col)) {
+                m_hists.setStale(col);
+            }
+        }
+    }
+}
+
+void AttributeColumns::setHistogramEnabled(int col, bool enabled)
+{
+    Q_ASSERT_X(col >= 0 && col < numColumns(), "AttributeColumns::setHistogramEnabled",
+               "column out of range");
+    if (!enabled) {
+        m_hists.untrack(col);
+    } else if (!m_hists.isTracked(col)) {
+        m_hists.track(col);
+        rebuildHistogram(col);
+    }
+}
+
+void AttributeColumns::rebuildHistogram(int col) const
+{
+    m_hists.reset(col);
+    for (int row = 0; row < m_numRows; ++row) {
+        m_hists.add(col, value(row, col));
+    }
+}
+
+void AttributeColumns::clear()
+{
+    m_names.clear();
+    m_index.clear();
+    m_utf8Index.clear();
+    m_columns.clear();
+    m_hists.clear();
+    m_numRows = 0;
+}
+
+Attributes AttributeColumns::row(int row) const
+{
+    Attributes attrs;
+    attrs.reserve(numColumns());
+    for (int col = 0; col < numColumns(); ++col) {
+        attrs.push_back(m_names[col], value(row, col));
+    }
+    return attrs;
+}
+
+void AttributeColumns::warnInvalidWrite(int col, const Value& value) const
+{
+    qWarning() << "unable to write a value of type" << value.type() << "to the column"
+               << m_names.at(col) << "of type" << m_columns.at(col).type;
+}
+
+} // evoplex
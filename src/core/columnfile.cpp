@@ -0,0 +1,529 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtEndian>
+#include <cstring>
+
+#include "columnfile.h"
+
+namespace evoplex {
+
+namespace {
+
+const char kFileMagic[] = "EVPXCOL1";
+const char kIndexMagic[] = "EVPXIDX1";
+const int kMagicSize = 8;
+const int kFileHeaderSize = kMagicSize + 8;   // magic, flags, header size
+const int kTrailerSize = 8 + kMagicSize;       // index offset, magic
+const int kIndexEntrySize = 8 + 4 + 4 + 4;
+const int kCompressionLevel = 1;               // favours speed over size
+
+template <typename T>
+inline void put(QByteArray& buf, T v)
+{
+    v = qToLittleEndian(v);
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+inline void putDouble(QByteArray& buf, double d)
+{
+    quint64 u;
+    std::memcpy(&u, &d, sizeof(d));
+    put<quint64>(buf, u);
+}
+
+// reads a T and moves 'p' forward; false if there are not enough bytes
+template <typename T>
+inline bool get(const char*& p, const char* end, T& v)
+{
+    if (end - p < static_cast<qint64>(sizeof(T))) {
+        return false;
+    }
+    std::memcpy(&v, p, sizeof(T));
+    v = qFromLittleEndian(v);
+    p += sizeof(T);
+    return true;
+}
+
+inline ColumnFile::ColumnType columnType(const Value& v)
+{
+    switch (v.type()) {
+    case Value::INT: return ColumnFile::Int;
+    case Value::DOUBLE: return ColumnFile::Double;
+    case Value::BOOL: return ColumnFile::Bool;
+    case Value::CHAR: return ColumnFile::Char;
+    case Value::STRING: return ColumnFile::String;
+    default: return ColumnFile::Empty;
+    }
+}
+
+inline QByteArray stringOf(const Value& v)
+{
+    return v.type() == Value::STRING ? QByteArray(v.toString()) : v.toQString().toUtf8();
+}
+
+} // namespace
+
+void ColumnFile::appendText(QByteArray& buf, const Value& v)
+{
+    switch (v.type()) {
+    case Value::INT: {
+        // formatted in place, as QByteArray::number() allocates
+        char digits[12];
+        char* p = digits + sizeof(digits);
+        const int i = v.toInt();
+        unsigned u = i < 0 ? 0u - static_cast<unsigned>(i) : static_cast<unsigned>(i);
+        do {
+            *--p = static_cast<char>('0' + u % 10);
+            u /= 10;
+        } while (u);
+        if (i < 0) {
+            *--p = '-';
+        }
+        buf.append(p, static_cast<int>(digits + sizeof(digits) - p));
+        break;
+    }
+    case Value::DOUBLE: buf.append(QByteArray::number(v.toDouble(), 'g', 8)); break;
+    case Value::BOOL: buf.append(v.toBool() ? '1' : '0'); break;
+    case Value::CHAR: buf.append(v.toChar()); break;
+    case Value::STRING: buf.append(v.toString()); break;
+    case Value::INVALID: break; // empty cell
+    }
+}
+
+/*******************************************************/
+/*******************************************************/
+
+ColumnFileWriter::ColumnFileWriter(bool compressed)
+    : m_compressed(compressed),
+      m_offset(0)
+{
+}
+
+QByteArray ColumnFileWriter::begin(const QByteArray& header)
+{
+    QByteArray buf(kFileMagic, kMagicSize);
+    put<quint32>(buf, m_compressed ? ColumnFile::Compressed : 0);
+    put<quint32>(buf, static_cast<quint32>(header.size()));
+    buf.append(header);
+    m_offset = buf.size();
+    m_index.clear();
+    return buf;
+}
+
+QByteArray ColumnFileWriter::chunk(int numCols, const std::vector<int>& steps, const Values& cells)
+{
+    Q_ASSERT_X(cells.size() == steps.size() * static_cast<size_t>(numCols),
+               "ColumnFileWriter", "the chunk must have 'numCols' cells per step");
+    const int numRows = static_cast<int>(steps.size());
+
+    QByteArray data;
+    data.reserve(8 + numRows * (4 + numCols * 8));
+    put<quint32>(data, static_cast<quint32>(numRows));
+    put<quint32>(data, static_cast<quint32>(numCols));
+    for (int step : steps) {
+        put<qint32>(data, step);
+    }
+
+    QByteArray bitmap;
+    for (int col = 0; col < numCols; ++col) {
+        // a column has a single type; mixed types are stored as strings
+        ColumnFile::ColumnType type = ColumnFile::Empty;
+        bool hasEmpty = false;
+        bitmap.fill(0, (numRows + 7) / 8);
+        for (int row = 0; row < numRows; ++row) {
+            const Value& v = cells[row * numCols + col];
+            if (!v.isValid()) {
+                hasEmpty = true;
+                continue;
+            }
+            bitmap[row / 8] = static_cast<char>(bitmap[row / 8] | (1 << (row % 8)));
+            const ColumnFile::ColumnType t = columnType(v);
+            if (type == ColumnFile::Empty) {
+                type = t;
+            } else if (type != t) {
+                type = ColumnFile::String;
+            }
+        }
+
+        data.append(static_cast<char>(type));
+        data.append(static_cast<char>(hasEmpty));
+        if (type == ColumnFile::Empty) {
+            continue;
+        }
+        if (hasEmpty) {
+            data.append(bitmap);
+        }
+
+        // empty cells are zeros, so that the cells have a fixed width
+        switch (type) {
+        case ColumnFile::Int:
+            for (int row = 0; row < numRows; ++row) {
+                const Value& v = cells[row * numCols + col];
+                put<qint32>(data, v.isValid() ? v.toInt() : 0);
+            }
+            break;
+        case ColumnFile::Double:
+            for (int row = 0; row < numRows; ++row) {
+                const Value& v = cells[row * numCols + col];
+                putDouble(data, v.isValid() ? v.toDouble() : 0.0);
+            }
+            break;
+        case ColumnFile::Bool:
+            for (int row = 0; row < numRows; ++row) {
+                const Value& v = cells[row * numCols + col];
+                data.append(static_cast<char>(v.isValid() && v.toBool()));
+            }
+            break;
+        case ColumnFile::Char:
+            for (int row = 0; row < numRows; ++row) {
+                const Value& v = cells[row * numCols + col];
+                data.append(v.isValid() ? v.toChar() : '\0');
+            }
+            break;
+        case ColumnFile::String: {
+            std::vector<QByteArray> strs;
+            strs.reserve(numRows);
+            for (int row = 0; row < numRows; ++row) {
+                const Value& v = cells[row * numCols + col];
+                strs.emplace_back(v.isValid() ? stringOf(v) : QByteArray());
+                put<quint32>(data, static_cast<quint32>(strs.back().size()));
+            }
+            for (const QByteArray& s : strs) {
+                data.append(s);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    if (m_compressed) {
+        data = qCompress(data, kCompressionLevel);
+    }
+
+    ColumnFile::ChunkInfo info;
+    info.offset = m_offset;
+    info.numRows = numRows;
+    info.firstStep = numRows > 0 ? steps.front() : 0;
+    info.lastStep = numRows > 0 ? steps.back() : 0;
+    m_index.emplace_back(info);
+
+    QByteArray buf;
+    buf.reserve(4 + data.size());
+    put<quint32>(buf, static_cast<quint32>(data.size()));
+    buf.append(data);
+    m_offset += buf.size();
+    return buf;
+}
+
+QByteArray ColumnFileWriter::end()
+{
+    QByteArray buf;
+    buf.reserve(4 + static_cast<int>(m_index.size()) * kIndexEntrySize + kTrailerSize);
+    put<quint32>(buf, static_cast<quint32>(m_index.size()));
+    for (const ColumnFile::ChunkInfo& info : m_index) {
+        put<quint64>(buf, static_cast<quint64>(info.offset));
+        put<quint32>(buf, static_cast<quint32>(info.numRows));
+        put<qint32>(buf, info.firstStep);
+        put<qint32>(buf, info.lastStep);
+    }
+    put<quint64>(buf, static_cast<quint64>(m_offset));
+    buf.append(kIndexMagic, kMagicSize);
+    m_offset += buf.size();
+    return buf;
+}
+
+/*******************************************************/
+/*******************************************************/
+
+bool ColumnFileReader::open(const QString& fpath, QString& error)
+{
+    m_file.close();
+    m_index.clear();
+    m_file.setFileName(fpath);
+    if (!m_file.open(QFile::ReadOnly)) {
+        error = "unable to open the file " + fpath;
+        return false;
+    }
+
+    const QByteArray fileHeader = m_file.read(kFileHeaderSize);
+    if (fileHeader.size() != kFileHeaderSize
+            || std::memcmp(fileHeader.constData(), kFileMagic, kMagicSize) != 0) {
+        error = "this is not a binary output file of Evoplex: " + fpath;
+        return false;
+    }
+    const char* p = fileHeader.constData() + kMagicSize;
+    const char* end = fileHeader.constData() + fileHeader.size();
+    quint32 headerSize;
+    get<quint32>(p, end, m_flags);
+    get<quint32>(p, end, headerSize);
+
+    const QByteArray header = m_file.read(headerSize);
+    if (header.size() != static_cast<int>(headerSize)) {
+        error = "the file is truncated: " + fpath;
+        return false;
+    }
+    m_header = QString::fromUtf8(header.constData(), header.size());
+
+    const qint64 firstChunk = kFileHeaderSize + headerSize;
+    return readIndex(firstChunk, error) || scanChunks(firstChunk, error);
+}
+
+qint64 ColumnFileReader::numRows() const
+{
+    qint64 n = 0;
+    for (const ColumnFile::ChunkInfo& info : m_index) {
+        n += info.numRows;
+    }
+    return n;
+}
+
+bool ColumnFileReader::readIndex(qint64 firstChunk, QString& error)
+{
+    const qint64 size = m_file.size();
+    if (size < firstChunk + 4 + kTrailerSize || !m_file.seek(size - kTrailerSize)) {
+        return false;
+    }
+    const QByteArray trailer = m_file.read(kTrailerSize);
+    if (trailer.size() != kTrailerSize
+            || std::memcmp(trailer.constData() + 8, kIndexMagic, kMagicSize) != 0) {
+        return false;
+    }
+    const char* p = trailer.constData();
+    quint64 indexOffset;
+    get<quint64>(p, p + 8, indexOffset);
+    if (indexOffset < static_cast<quint64>(firstChunk)
+            || indexOffset > static_cast<quint64>(size - kTrailerSize)
+            || !m_file.seek(static_cast<qint64>(indexOffset))) {
+        return false;
+    }
+
+    const QByteArray index = m_file.read(size - kTrailerSize - static_cast<qint64>(indexOffset));
+    p = index.constData();
+    const char* end = p + index.size();
+    quint32 numChunks;
+    if (!get<quint32>(p, end, numChunks) || end - p != static_cast<qint64>(numChunks) * kIndexEntrySize) {
+        return false;
+    }
+    m_index.resize(numChunks);
+    for (ColumnFile::ChunkInfo& info : m_index) {
+        quint64 offset;
+        quint32 numRows;
+        get<quint64>(p, end, offset);
+        get<quint32>(p, end, numRows);
+        get<qint32>(p, end, info.firstStep);
+        get<qint32>(p, end, info.lastStep);
+        info.offset = static_cast<qint64>(offset);
+        info.numRows = static_cast<int>(numRows);
+    }
+    error.clear();
+    return true;
+}
+
+bool ColumnFileReader::scanChunks(qint64 firstChunk, QString& error)
+{
+    // there is no index, e.g., the file was not closed properly
+    m_index.clear();
+    const qint64 size = m_file.size();
+    qint64 offset = firstChunk;
+    while (offset + 4 <= size && m_file.seek(offset)) {
+        const QByteArray sizeBytes = m_file.read(4);
+        const char* p = sizeBytes.constData();
+        quint32 chunkSize;
+        if (!get<quint32>(p, p + sizeBytes.size(), chunkSize) || offset + 4 + chunkSize > size) {
+            break; // truncated
+        }
+        QByteArray data = m_file.read(chunkSize);
+        if (isCompressed()) {
+            data = qUncompress(data);
+        }
+        p = data.constData();
+        const char* end = p + data.size();
+        quint32 numRows, numCols;
+        ColumnFile::ChunkInfo info;
+        info.offset = offset;
+        if (!get<quint32>(p, end, numRows) || !get<quint32>(p, end, numCols)
+                || end - p < static_cast<qint64>(numRows) * 4) {
+            break; // not a chunk
+        }
+        info.numRows = static_cast<int>(numRows);
+        info.firstStep = info.lastStep = 0;
+        if (numRows > 0) {
+            get<qint32>(p, end, info.firstStep);
+            p += (numRows - 1) * 4 - 4;
+            get<qint32>(p, end, info.lastStep);
+        }
+        m_index.emplace_back(info);
+        offset += 4 + chunkSize;
+    }
+    error.clear();
+    return true;
+}
+
+bool ColumnFileReader::readChunk(int i, int& numCols, std::vector<int>& steps,
+                                 Values& cells, QString& error)
+{
+    const ColumnFile::ChunkInfo& info = m_index.at(i);
+    error = QString("chunk %1 is corrupted").arg(i);
+    if (!m_file.seek(info.offset)) {
+        return false;
+    }
+    const QByteArray sizeBytes = m_file.read(4);
+    const char* p = sizeBytes.constData();
+    quint32 chunkSize;
+    if (!get<quint32>(p, p + sizeBytes.size(), chunkSize)) {
+        return false;
+    }
+    QByteArray data = m_file.read(chunkSize);
+    if (data.size() != static_cast<int>(chunkSize)) {
+        return false;
+    }
+    if (isCompressed()) {
+        data = qUncompress(data);
+    }
+
+    p = data.constData();
+    const char* end = p + data.size();
+    quint32 numRows, nCols;
+    if (!get<quint32>(p, end, numRows) || !get<quint32>(p, end, nCols)) {
+        return false;
+    }
+    numCols = static_cast<int>(nCols);
+    const int n = static_cast<int>(numRows);
+    steps.resize(n);
+    for (int& step : steps) {
+        if (!get<qint32>(p, end, step)) {
+            return false;
+        }
+    }
+
+    cells.assign(static_cast<size_t>(n) * numCols, Value());
+    const int bitmapSize = (n + 7) / 8;
+    for (int col = 0; col < numCols; ++col) {
+        quint8 type, hasEmpty;
+        if (!get<quint8>(p, end, type) || !get<quint8>(p, end, hasEmpty)) {
+            return false;
+        }
+        if (type == ColumnFile::Empty) {
+            continue;
+        }
+        const char* bitmap = nullptr;
+        if (hasEmpty) {
+            if (end - p < bitmapSize) {
+                return false;
+            }
+            bitmap = p;
+            p += bitmapSize;
+        }
+        auto isEmpty = [bitmap](int row) {
+            return bitmap && !(bitmap[row / 8] & (1 << (row % 8)));
+        };
+
+        switch (type) {
+        case ColumnFile::Int:
+            for (int row = 0; row < n; ++row) {
+                qint32 v;
+                if (!get<qint32>(p, end, v)) return false;
+                if (!isEmpty(row)) cells[row * numCols + col] = Value(static_cast<int>(v));
+            }
+            break;
+        case ColumnFile::Double:
+            for (int row = 0; row < n; ++row) {
+                quint64 u;
+                if (!get<quint64>(p, end, u)) return false;
+                double d;
+                std::memcpy(&d, &u, sizeof(d));
+                if (!isEmpty(row)) cells[row * numCols + col] = Value(d);
+            }
+            break;
+        case ColumnFile::Bool:
+            for (int row = 0; row < n; ++row) {
+                quint8 v;
+                if (!get<quint8>(p, end, v)) return false;
+                if (!isEmpty(row)) cells[row * numCols + col] = Value(v != 0);
+            }
+            break;
+        case ColumnFile::Char:
+            for (int row = 0; row < n; ++row) {
+                char v;
+                if (!get<char>(p, end, v)) return false;
+                if (!isEmpty(row)) cells[row * numCols + col] = Value(v);
+            }
+            break;
+        case ColumnFile::String: {
+            std::vector<quint32> sizes(n);
+            for (quint32& s : sizes) {
+                if (!get<quint32>(p, end, s)) return false;
+            }
+            std::string str;
+            for (int row = 0; row < n; ++row) {
+                if (end - p < static_cast<qint64>(sizes[row])) return false;
+                str.assign(p, sizes[row]);
+                p += sizes[row];
+                if (!isEmpty(row)) cells[row * numCols + col] = Value(str.c_str());
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    error.clear();
+    return true;
+}
+
+bool ColumnFileReader::toCsv(const QString& csvPath, QString& error)
+{
+    QFile csv(csvPath);
+    if (!csv.open(QFile::WriteOnly | QFile::Truncate)) {
+        error = "unable to write in " + csvPath;
+        return false;
+    }
+
+    QByteArray buf = "step," + m_header.toUtf8() + "\n";
+    int numCols;
+    std::vector<int> steps;
+    Values cells;
+    for (int i = 0; i < numChunks(); ++i) {
+        if (!readChunk(i, numCols, steps, cells, error)) {
+            return false;
+        }
+        const Value* cell = cells.data();
+        for (int step : steps) {
+            buf.append(QByteArray::number(step));
+            for (int col = 0; col < numCols; ++col, ++cell) {
+                buf.append(',');
+                ColumnFile::appendText(buf, *cell);
+            }
+            buf.append('\n');
+        }
+        if (csv.write(buf) != buf.size()) {
+            error = "unable to write in " + csvPath;
+            return false;
+        }
+        buf.clear();
+    }
+    return true;
+}
+
+} // evoplex
@@ -0,0 +1,96 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "csr.h"
+
+namespace evoplex {
+
+void CSR::build(const std::vector<NodePtr>& rows, bool isDirected)
+{
+    clear();
+    m_isDirected = isDirected;
+    if (rows.empty()) {
+        return;
+    }
+    m_nodes = &rows;
+
+    int maxId = 0;
+    for (const NodePtr& node : rows) {
+        maxId = std::max(maxId, node->id());
+    }
+    m_rowOf.assign(maxId + 1, -1);
+    for (size_t r = 0; r < rows.size(); ++r) {
+        m_rowOf[rows[r]->id()] = static_cast<int>(r);
+    }
+
+    buildRows(m_out, true);
+    if (m_isDirected) {
+        buildRows(m_in, false);
+    }
+}
+
+void CSR::buildRows(Rows& rows, bool outward)
+{
+    const std::vector<NodePtr>& nodes = *m_nodes;
+    rows.offsets.resize(nodes.size() + 1);
+    rows.offsets[0] = 0;
+    for (size_t r = 0; r < nodes.size(); ++r) {
+        const Edges& edges = outward ? nodes[r]->outEdges() : nodes[r]->inEdges();
+        rows.offsets[r+1] = rows.offsets[r] + static_cast<int>(edges.size());
+    }
+
+    rows.neighbours.resize(rows.offsets.back());
+    rows.edges.resize(rows.offsets.back());
+
+    std::vector<std::pair<int, EdgePtr>> buf;
+    for (size_t r = 0; r < nodes.size(); ++r) {
+        const Edges& edges = outward ? nodes[r]->outEdges() : nodes[r]->inEdges();
+        buf.clear();
+        for (auto const& p : edges) {
+            buf.emplace_back(row(p.second->neighbour()->id()), p.second);
+        }
+        // sorting keeps the iteration order deterministic and the memory
+        // accesses to the neighbours' data as sequential as possible
+        std::sort(buf.begin(), buf.end(),
+            [](const std::pair<int, EdgePtr>& a, const std::pair<int, EdgePtr>& b) {
+                return a.first < b.first || (a.first == b.first && a.second.id() < b.second.id());
+            });
+
+        int pos = rows.offsets[r];
+        for (auto const& nb : buf) {
+            rows.neighbours[pos] = nb.first;
+            rows.edges[pos] = nb.second;
+            ++pos;
+        }
+    }
+}
+
+void CSR::clear()
+{
+    m_nodes = nullptr;
+    std::vector<int>().swap(m_rowOf);
+    m_out = Rows();
+    m_in = Rows();
+}
+
+} // evoplex
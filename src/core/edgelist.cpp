@@ -0,0 +1,191 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "edgelist.h"
+#include "graphsnapshot.h"
+#include "parallelfor.h"
+#include "textfile.h"
+
+namespace evoplex {
+
+namespace {
+
+// big enough to make the overhead of a task negligible
+const qint64 kChunkSize = 4 << 20;
+
+struct Chunk {
+    std::vector<int> origins;
+    std::vector<int> targets;
+    int numRows = 0;
+    int errorRow = -1; // local row of the first invalid row
+    QString error;
+};
+
+inline bool equals(const Span<char>& s, const char* str)
+{
+    const size_t n = std::strlen(str);
+    return static_cast<size_t>(s.size()) == n && std::memcmp(s.data(), str, n) == 0;
+}
+
+void parseChunk(const Span<char>& text, int numCols, int numNodes, Chunk& chunk)
+{
+    // a rough guess, as lines are usually alike
+    const size_t guess = static_cast<size_t>(text.size() / 12);
+    chunk.origins.reserve(guess);
+    chunk.targets.reserve(guess);
+
+    const char* p = text.begin();
+    while (p < text.end()) {
+        const Span<char> line = TextFile::readLine(p, text.end());
+        const char* c = line.begin();
+        int originId, targetId;
+        if (!TextFile::parseInt(c, line.end(), originId) || c == line.end() || *c++ != ','
+                || !TextFile::parseInt(c, line.end(), targetId)
+                || (c != line.end() && *c != ',')) {
+            chunk.error = "invalid values. The values for 'origin' and 'target' must be integers.";
+        } else if (1 + std::count(c, line.end(), ',') + 1 != numCols) {
+            chunk.error = "rows must have the same number of columns!";
+        } else if (originId < 0 || originId >= numNodes || targetId < 0 || targetId >= numNodes) {
+            chunk.error = "invalid values. 'origin' or 'target' are not in the set of nodes.";
+        }
+        if (!chunk.error.isEmpty()) {
+            chunk.errorRow = chunk.numRows;
+            return;
+        }
+        chunk.origins.emplace_back(originId);
+        chunk.targets.emplace_back(targetId);
+        ++chunk.numRows;
+    }
+}
+
+} // namespace
+
+EdgeList EdgeList::fromFile(const QString& filePath, int numNodes, QString* errMsg)
+{
+    if (GraphSnapshot::isSnapshot(filePath)) {
+        return fromSnapshot(filePath, numNodes, errMsg);
+    }
+
+    auto fail = [errMsg, &filePath](const QString& msg) {
+        if (errMsg) {
+            *errMsg = msg + "\n" + filePath;
+        }
+        return EdgeList();
+    };
+
+    TextFile file;
+    if (!file.open(filePath)) {
+        return fail("unable to read csv file with the set of edges.");
+    }
+
+    // read and validate header
+    const char* p = file.begin();
+    const Span<char> header = TextFile::readLine(p, file.end());
+    const char* comma = std::find(header.begin(), header.end(), ',');
+    const int numCols = 1 + static_cast<int>(std::count(header.begin(), header.end(), ','));
+    if (numCols < 2 || !equals(Span<char>(header.begin(), comma), "origin")
+            || !equals(Span<char>(comma + 1, std::find(comma + 1, header.end(), ',')), "target")) {
+        return fail("the header is invalid. It should have at least two columns: 'origin' and 'target'.");
+    }
+
+    const std::vector<Span<char>> texts = file.chunks(p, kChunkSize);
+    std::vector<Chunk> chunks(texts.size());
+    ParallelFor::run(static_cast<int>(texts.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            parseChunk(texts[i], numCols, numNodes, chunks[i]);
+        }
+    }, 1);
+
+    EdgeList edges;
+    size_t total = 0;
+    for (const Chunk& chunk : chunks) {
+        if (chunk.errorRow >= 0) {
+            const int row = static_cast<int>(total) + chunk.errorRow;
+            return fail(chunk.error + QString(" Row: %1").arg(row));
+        }
+        total += chunk.origins.size();
+    }
+
+    edges.m_origins.reserve(total);
+    edges.m_targets.reserve(total);
+    for (Chunk& chunk : chunks) {
+        edges.m_origins.insert(edges.m_origins.end(), chunk.origins.begin(), chunk.origins.end());
+        edges.m_targets.insert(edges.m_targets.end(), chunk.targets.begin(), chunk.targets.end());
+        std::vector<int>().swap(chunk.origins);
+        std::vector<int>().swap(chunk.targets);
+    }
+    return edges;
+}
+
+EdgeList EdgeList::fromSnapshot(const QString& filePath, int numNodes, QString* errMsg)
+{
+    QString error;
+    const GraphSnapshotPtr snapshot = GraphSnapshot::open(filePath, &error);
+    if (!snapshot) {
+        if (errMsg) {
+            *errMsg = error;
+        }
+        return EdgeList();
+    }
+
+    if (snapshot->numNodes() > numNodes) {
+        if (errMsg) {
+            *errMsg = QString("the snapshot has %1 nodes, but the graph has only %2.\n")
+                    .arg(snapshot->numNodes()).arg(numNodes) + filePath;
+        }
+        return EdgeList();
+    }
+
+    // the topology was validated by the snapshot; as in Nodes::fromSnapshot(),
+    // the ids of the nodes are their rows
+    EdgeList edges;
+    edges.m_origins.reserve(snapshot->numEdges());
+    edges.m_targets.reserve(snapshot->numEdges());
+    const Span<int> offsets = snapshot->edgeOffsets();
+    const Span<int> targets = snapshot->edgeTargets();
+    for (int row = 0; row < snapshot->numNodes(); ++row) {
+        for (int i = offsets[row]; i < offsets[row+1]; ++i) {
+            edges.m_origins.emplace_back(row);
+            edges.m_targets.emplace_back(targets[i]);
+        }
+    }
+    edges.m_attrs = snapshot->edgeAttrs();
+    return edges;
+}
+
+void EdgeList::add(int origin, int target)
+{
+    Q_ASSERT_X(m_attrs.numColumns() == 0, "EdgeList::add",
+               "edges cannot be added to a list with attributes");
+    m_origins.emplace_back(origin);
+    m_targets.emplace_back(target);
+}
+
+void EdgeList::clear()
+{
+    std::vector<int>().swap(m_origins);
+    std::vector<int>().swap(m_targets);
+    m_attrs.clear();
+}
+
+} // evoplex
@@ -0,0 +1,81 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <new>
+
+#include "edgepool.h"
+
+namespace evoplex {
+
+Edge* EdgePool::create(int id, const NodePtr* origin, const NodePtr* neighbour,
+                       Attributes* attrs, bool ownsAttrs)
+{
+    Edge* edge;
+    if (!m_free.empty()) {
+        edge = m_free.back();
+        m_free.pop_back();
+    } else {
+        if (m_next == m_chunks.size() * kChunkSize) {
+            Edge* chunk = static_cast<Edge*>(m_arena->allocate(sizeof(Edge) * kChunkSize, alignof(Edge)));
+            for (size_t i = 0; i < kChunkSize; ++i) {
+                new (chunk + i) Edge();
+            }
+            m_chunks.emplace_back(chunk);
+        }
+        edge = &m_chunks[m_next / kChunkSize][m_next % kChunkSize];
+        ++m_next;
+    }
+    edge->reset(id, origin, neighbour, attrs, ownsAttrs, m_hists);
+    if (m_hists && attrs) {
+        for (int attrId : m_hists->tracked()) {
+            m_hists->add(attrId, attrs->value(attrId));
+        }
+    }
+    ++m_size;
+    return edge;
+}
+
+void EdgePool::destroy(Edge* edge)
+{
+    if (m_hists && edge->m_attrs) {
+        for (int attrId : m_hists->tracked()) {
+            m_hists->remove(attrId, edge->m_attrs->value(attrId));
+        }
+    }
+    edge->release();
+    m_free.emplace_back(edge);
+    --m_size;
+}
+
+void EdgePool::clear()
+{
+    // the chunks belong to the arena; Edge is trivially destructible
+    for (size_t i = 0; i < m_next; ++i) {
+        m_chunks[i / kChunkSize][i % kChunkSize].release();
+    }
+    m_free.clear();
+    m_next = 0;
+    m_size = 0;
+    if (m_hists) {
+        m_hists->reset();
+    }
+}
+
+} // evoplex
@@ -20,12 +20,15 @@
 
 #include <QDebug>
 #include <QElapsedTimer>
-#include <QFile>
 #include <QFileInfo>
 #include <QThread>
+#include <algorithm>
+#include <limits>
 
 #include "experiment.h"
 #include "attrsgenerator.h"
+#include "filewriter.h"
+#include "graphsnapshot.h"
 #include "node.h"
 #include "project.h"
 
@@ -37,6 +40,8 @@ Experiment::Experiment(MainApp* mainApp, ExpInputs* inputs, ProjectPtr project)
     , m_id(inputs->general(GENERAL_ATTRIBUTE_EXPID).toInt())
     , m_project(project)
     , m_inputs(nullptr)
+    , m_fileHasSteps(false)
+    , m_fileFormat(FileWriter::CSV)
     , m_expStatus(INVALID)
 {
     QString error;
@@ -49,6 +54,7 @@ Experiment::~Experiment()
     Q_ASSERT_X(m_expStatus != RUNNING && m_expStatus != QUEUED,
                "~Experiment", "tried to delete a running experiment");
     deleteTrials();
+    m_planner.clear();
     m_outputs.clear();
     delete m_inputs;
     m_project.clear();
@@ -69,7 +75,16 @@ bool Experiment::init(ExpInputs* inputs, QString& error)
 
     m_filePathPrefix.clear();
     m_fileHeader.clear();
+    m_fileHasSteps = false;
+    m_fileFormat = FileWriter::CSV;
     if (!m_inputs->fileCaches().empty()) {
+        const QString format = m_inputs->general(OUTPUT_FORMAT).toQString();
+        if (format == "bin") {
+            m_fileFormat = FileWriter::Binary;
+        } else if (format == "binz") {
+            m_fileFormat = FileWriter::CompressedBinary;
+        }
+
         m_filePathPrefix = QString("%1/%2_e%3_t")
                 .arg(m_inputs->general(OUTPUT_DIR).toQString())
                 .arg(m_project->name())
@@ -79,10 +94,18 @@ bool Experiment::init(ExpInputs* inputs, QString& error)
             Q_ASSERT_X(cache->inputs().size() > 0, "Experiment::init", "a file cache must have inputs");
             m_fileHeader += cache->printableHeader(',', false) + ",";
             m_outputs.insert(cache->output());
+            m_fileHasSteps |= cache->output()->sampling() != Sampling();
         }
         m_fileHeader.chop(1);
-        m_fileHeader += "\n";
+        // binary files always hold the steps, and not as a column
+        if (m_fileFormat == FileWriter::CSV) {
+            if (m_fileHasSteps) {
+                m_fileHeader.prepend("step,");
+            }
+            m_fileHeader += "\n";
+        }
     }
+    m_planner.plan(m_outputs);
 
     m_numTrials = m_inputs->general(GENERAL_ATTRIBUTE_TRIALS).toInt();
     m_autoDeleteTrials = m_inputs->general(GENERAL_ATTRIBUTE_AUTODELETE).toBool();
@@ -126,12 +149,21 @@ void Experiment::deleteTrials()
 {
     QMutexLocker locker(&m_mutex);
 
+    // the experiments are deleted later on, so the FileWriter may be gone
+    // already; if so, it has closed the files of the unfinished trials
+    FileWriter* fileWriter = m_filePathPrefix.isEmpty() ? nullptr : m_mainApp->fileWriter();
     for (auto& trial : m_trials) {
+        if (fileWriter) {
+            // the files of unfinished trials are still open
+            fileWriter->close(filePath(trial.first));
+        }
         delete trial.second;
     }
     m_trials.clear();
 
     m_clonableNodes.clear();
+    m_initialAttrs.clear();
+    m_topologyCache.clear();
 }
 
 void Experiment::updateProgressValue()
@@ -208,12 +240,15 @@ void Experiment::processTrial(const quint16 trialId)
     t.start();
 
     bool algorithmConverged = false;
+    const int firstStep = trial->m_currStep;
+    int passes = 0; // over the nodes/edges to evaluate the outputs
     while (trial->m_currStep < m_pauseAt && !algorithmConverged) {
         algorithmConverged = trial->algorithmStep();
+        trial->graph()->nodeColumns().swapBuffers();
         ++trial->m_currStep;
 
-        for (const OutputPtr& output : m_outputs)
-            output->doOperation(trialId, trial);
+        const bool isFinal = algorithmConverged || trial->m_currStep >= m_stopAt;
+        passes += m_planner.doOperation(trialId, trial, isFinal);
 
         if (m_inputs->fileCaches().size()
                 && trial->m_currStep % m_mainApp->stepsToFlush() == 0
@@ -228,12 +263,16 @@ void Experiment::processTrial(const quint16 trialId)
             QThread::msleep(m_delay);
     }
 
-    qDebug() << QString("%1 (E%2:T%3) - %4s")
+    const int steps = trial->m_currStep - firstStep;
+    qDebug() << QString("%1 (E%2:T%3) - %4s; output passes per step: %5")
                 .arg(m_project->name()).arg(m_id).arg(trialId)
-                .arg(t.elapsed() / 1000);
+                .arg(t.elapsed() / 1000)
+                .arg(steps > 0 ? static_cast<double>(passes) / steps : 0.0);
 
     if (trial->m_currStep >= m_stopAt || algorithmConverged) {
-        if (writeCachedSteps(trialId)) {
+        // it waits for the rows of the trial to reach the disk
+        if (writeCachedSteps(trialId) && (m_filePathPrefix.isEmpty()
+                || m_mainApp->fileWriter()->close(filePath(trialId)))) {
             trial->m_status = FINISHED;
         } else {
             trial->m_status = INVALID;
@@ -260,17 +299,26 @@ AbstractModel* Experiment::createTrial(const quint16 trialId)
         qFatal("%s", qPrintable(e));
     }
 
+    AbstractGraph* graphObj = m_graphPlugin->create();
+    if (graphObj) {
+        graphObj->m_topologyCache = &m_topologyCache;
+    }
     const QString& gType = m_inputs->general(GENERAL_ATTRIBUTE_GRAPHTYPE).toString();
-    Nodes nodes = createNodes(AbstractGraph::enumFromString(gType));
+    // the nodes of the trial share the graph's arena
+    AttributeColumns nodeAttrs;
+    Nodes nodes = createNodes(AbstractGraph::enumFromString(gType),
+                              graphObj ? graphObj->m_arena : ArenaPtr(), nodeAttrs);
     if (nodes.empty()) {
+        delete graphObj;
         return nullptr;
     }
 
     const quint16 seed = static_cast<quint16>(m_inputs->general(GENERAL_ATTRIBUTE_SEED).toInt());
-    PRG* prg = new PRG(seed + trialId);
+    // each trial draws from an independent stream of the experiment's seed
+    PRG* prg = new PRG(PRG(seed).split(trialId));
 
-    AbstractGraph* graphObj = m_graphPlugin->create();
-    if (!graphObj || !graphObj->setup(prg, m_inputs->graph(), nodes, gType) || !graphObj->init()) {
+    if (!graphObj || !graphObj->setup(prg, m_inputs->graph(), nodes, gType,
+                                      m_modelPlugin->edgeAttrsScope(), nodeAttrs) || !graphObj->init()) {
         qWarning() << "unable to create the trials."
                    << "The graph could not be initialized."
                    << "Project:" << m_project->name() << "Experiment:" << m_id;
@@ -279,6 +327,7 @@ AbstractModel* Experiment::createTrial(const quint16 trialId)
         return nullptr;
     }
     graphObj->reset();
+    graphObj->freeze();
 
     AbstractModel* modelObj = m_modelPlugin->create();
     if (!modelObj || !modelObj->setup(prg, m_inputs->model(), graphObj) || !modelObj->init()) {
@@ -290,22 +339,15 @@ AbstractModel* Experiment::createTrial(const quint16 trialId)
     }
 
     if (!m_inputs->fileCaches().empty()) {
-        const QString fpath = m_filePathPrefix + QString("%4.csv").arg(trialId);
-        QFile file(fpath);
-        if (file.open(QFile::WriteOnly | QFile::Truncate)) {
-            QTextStream stream(&file);
-            stream << m_fileHeader;
-            file.close();
-        } else {
+        const QString fpath = filePath(trialId);
+        if (!m_mainApp->fileWriter()->create(fpath, m_fileHeader.toUtf8(), m_fileFormat)) {
             qWarning() << "unable to create the trials. Could not write in " << fpath;
             delete modelObj;
             return nullptr;
         }
 
         // write this initial step to file
-        for (OutputPtr output : m_outputs) {
-            output->doOperation(trialId, modelObj);
-        }
+        m_planner.doOperation(trialId, modelObj, false);
         writeCachedSteps(trialId);
     }
 
@@ -313,17 +355,20 @@ AbstractModel* Experiment::createTrial(const quint16 trialId)
     return modelObj;
 }
 
-Nodes Experiment::createNodes(const AbstractGraph::GraphType gType)
+Nodes Experiment::createNodes(const AbstractGraph::GraphType gType, const ArenaPtr& arena,
+                              AttributeColumns& nodeAttrs)
 {
     if (m_expStatus == INVALID || gType == AbstractGraph::Invalid_Type) {
         return Nodes();
     } else if (!m_clonableNodes.empty()) {
+        nodeAttrs = m_initialAttrs;
         if (static_cast<int>(m_trials.size()) == m_numTrials - 1) {
             Nodes nodes = m_clonableNodes;
             Nodes().swap(m_clonableNodes);
+            m_initialAttrs.clear();
             return nodes;
         }
-        return Utils::clone(m_clonableNodes);
+        return Utils::clone(m_clonableNodes, arena);
     }
 
     Q_ASSERT_X(m_trials.empty(), "Experiment::createNodes",
@@ -331,7 +376,12 @@ Nodes Experiment::createNodes(const AbstractGraph::GraphType gType)
 
     QString errMsg;
     const QString& cmd = m_inputs->general(GENERAL_ATTRIBUTE_NODES).toQString();
-    Nodes nodes = Nodes::fromCmd(cmd, m_modelPlugin->nodeAttrsScope(), gType, &errMsg);
+    // the attributes of a snapshot are read in place, straight into columns
+    AttributeColumns snapshotAttrs;
+    const bool isSnapshot = GraphSnapshot::isSnapshot(cmd) && QFileInfo::exists(cmd);
+    Nodes nodes = isSnapshot
+            ? Nodes::fromSnapshot(cmd, m_modelPlugin->nodeAttrsScope(), gType, snapshotAttrs, &errMsg)
+            : Nodes::fromCmd(cmd, m_modelPlugin->nodeAttrsScope(), gType, &errMsg);
     if (!errMsg.isEmpty() || nodes.empty()) {
         errMsg = QString("unable to create the trials."
                          "The set of nodes could not be created.\n %1 \n"
@@ -341,8 +391,33 @@ Nodes Experiment::createNodes(const AbstractGraph::GraphType gType)
         return Nodes();
     }
 
-    if (m_numTrials > 1) {
-        m_clonableNodes = Utils::clone(nodes);
+    if (isSnapshot) {
+        // the nodes hold only their ids and coordinates already
+        if (m_numTrials > 1) {
+            m_clonableNodes = nodes;
+            m_initialAttrs = snapshotAttrs;
+            nodes = Utils::clone(m_clonableNodes, arena);
+        }
+        nodeAttrs = snapshotAttrs;
+    } else if (m_numTrials > 1) {
+        std::vector<int> ids;
+        ids.reserve(nodes.size());
+        for (auto const& p : nodes) {
+            ids.emplace_back(p.first);
+        }
+        std::sort(ids.begin(), ids.end());
+
+        m_clonableNodes.reserve(nodes.size());
+        for (int id : ids) {
+            const NodePtr& node = nodes.at(id);
+            m_initialAttrs.appendRow(node->attrs());
+            NodePtr n = gType == AbstractGraph::Undirected
+                    ? makeNode<UNode>(ArenaPtr(), id, Attributes(), node->x(), node->y())
+                    : makeNode<DNode>(ArenaPtr(), id, Attributes(), node->x(), node->y());
+            m_clonableNodes.insert({id, n});
+        }
+        nodes = Utils::clone(m_clonableNodes, arena);
+        nodeAttrs = m_initialAttrs;
     }
     return nodes;
 }
@@ -357,36 +432,46 @@ AbstractModel* Experiment::trial(int trialId) const
 
 bool Experiment::writeCachedSteps(const int trialId)
 {
-    if (m_inputs->fileCaches().empty() || m_inputs->fileCaches().front()->isEmpty(trialId)) {
+    const std::vector<Cache*>& caches = m_inputs->fileCaches();
+    auto hasRows = [trialId](const Cache* c) { return !c->isEmpty(trialId); };
+    if (std::none_of(caches.cbegin(), caches.cend(), hasRows)) {
         return true;
     }
 
-    const QString fpath = m_filePathPrefix + QString("%1.csv").arg(trialId);
-    QFile file(fpath);
-    if (!file.open(QFile::WriteOnly | QFile::Append)) {
-        qWarning() << "unable to create the trials. Could not write in " << fpath;
-        return false;
+    // The rows are handed off to the FileWriter, which formats and writes
+    // them in its own thread.
+    FileWriter::Block block;
+    block.hasSteps = m_fileHasSteps;
+    for (const Cache* cache : caches) {
+        block.numCols += static_cast<int>(cache->inputs().size());
     }
 
-    QTextStream stream(&file);
+    // The caches are filled by this thread, so all of them hold the rows up
+    // to the current step. Rows are merged by step, as sampled outputs
+    // might not have a row at every step.
     do {
-        QString row;
-        for (Cache* cache : m_inputs->fileCaches()) {
-            Values vals = cache->readFrontRow(trialId).second;
-            cache->flushFrontRow(trialId);
-            for (Value val : vals) {
-                row += val.toQString() + ",";
+        int step = std::numeric_limits<int>::max();
+        for (const Cache* cache : caches) {
+            if (!cache->isEmpty(trialId)) {
+                step = std::min(step, cache->readFrontRow(trialId).step());
             }
         }
-        row.chop(1);
-        stream << row << "\n";
 
-    // we synchronously flush all the io stuff. So, it's safe to say
-    // that if the front Output is empty, then all others are also empty.
-    } while (!m_inputs->fileCaches().front()->isEmpty(trialId));
+        block.steps.emplace_back(step);
+        for (Cache* cache : caches) {
+            if (cache->isEmpty(trialId) || cache->readFrontRow(trialId).step() != step) {
+                block.cells.insert(block.cells.end(), cache->inputs().size(), Value()); // empty cells
+                continue;
+            }
+            const Cache::Row cachedRow = cache->readFrontRow(trialId);
+            for (int col = 0; col < cachedRow.size(); ++col) {
+                block.cells.emplace_back(cachedRow.at(col));
+            }
+            cache->flushFrontRow(trialId);
+        }
+    } while (std::any_of(caches.cbegin(), caches.cend(), hasRows));
 
-    file.close();
-    return true;
+    return m_mainApp->fileWriter()->write(filePath(trialId), std::move(block));
 }
 
 bool Experiment::removeOutput(OutputPtr output)
@@ -408,6 +493,7 @@ bool Experiment::removeOutput(OutputPtr output)
     }
 
     m_outputs.erase(it);
+    m_planner.plan(m_outputs);
     return true;
 }
 
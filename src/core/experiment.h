@@ -31,6 +31,7 @@
 
 #include "expinputs.h"
 #include "experimentsmgr.h"
+#include "filewriter.h"
 #include "mainapp.h"
 #include "constants.h"
 #include "output.h"
@@ -98,7 +99,7 @@ public:
     inline void setAutoDeleteTrials(bool b) { m_autoDeleteTrials = b; }
 
     inline bool hasOutputs() const { return !m_outputs.empty(); }
-    inline void addOutput(OutputPtr output) { m_outputs.insert(output); }
+    inline void addOutput(OutputPtr output) { m_outputs.insert(output); m_planner.plan(m_outputs); }
     bool removeOutput(OutputPtr output);
     OutputPtr searchOutput(const OutputPtr find);
 
@@ -138,8 +139,11 @@ private:
     int m_stopAt;
 
     QString m_fileHeader;   // file header is the same for all trials; let's save it then
+    bool m_fileHasSteps;    // true if any file output is sampled, i.e., rows are not every step
+    FileWriter::Format m_fileFormat;
     QString m_filePathPrefix;
     std::unordered_set<OutputPtr> m_outputs;
+    OutputPlanner m_planner; // evaluates m_outputs; replanned when they change
 
     int m_pauseAt;
     Status m_expStatus;
@@ -155,8 +159,16 @@ private:
 
     // It holds the initial population for further use (internal only).
     // If this experiment has only one trial, then it won't be used anyway.
-    // If the experiment has 2 or more trials, it'll be used in the last trial.
+    // Otherwise, the attributes are stored only once in 'm_initialAttrs'
+    // (one row per node, in ascending order of id), which the trials share
+    // until they change them (copy-on-write), and the nodes in
+    // 'm_clonableNodes' hold only their ids and coordinates.
     Nodes m_clonableNodes;
+    AttributeColumns m_initialAttrs;
+
+    // The topologies read from files by the graphs of the trials, which
+    // are parsed only once and then shared by all trials.
+    TopologyCache m_topologyCache;
 
     // Here is where the actual simulation is performed.
     // This method will run in a worker thread until it reaches the max
@@ -171,14 +183,24 @@ private:
     // The trials are meant to have the same initial population.
     // So, considering that it might be a very expensive operation (eg, I/O),
     // this method will try to do the heavy stuff only once, storing the
-    // initial population in the 'm_clonableNodes' container. Except when
-    // the experiment has only one trial.
+    // initial population in the 'm_clonableNodes' and 'm_initialAttrs'
+    // containers. Except when the experiment has only one trial.
+    // The clones of the nodes take their memory from the arena, if any, and
+    // 'nodeAttrs' gets a shared copy of the initial attributes, if any.
     // This method is NOT thread-safe.
-    Nodes createNodes(const AbstractGraph::GraphType gType);
+    Nodes createNodes(const AbstractGraph::GraphType gType, const ArenaPtr& arena,
+                      AttributeColumns& nodeAttrs);
 
     void deleteTrials();
 
+    // Hands off the cached rows of the file outputs to the FileWriter, one
+    // line per step. If the outputs have different samplings, the cells of
+    // the outputs which have no row at a step are left empty.
+    // Returns false if writing to the file of the trial has failed.
     bool writeCachedSteps(const int trialId);
+
+    inline QString filePath(const int trialId) const
+    { return m_filePathPrefix + QString(m_fileFormat == FileWriter::CSV ? "%1.csv" : "%1.evb").arg(trialId); }
 };
 }
 
@@ -24,6 +24,7 @@
 
 #include "experimentsmgr.h"
 #include "experiment.h"
+#include "parallelfor.h"
 
 namespace evoplex {
 
@@ -38,6 +39,9 @@ ExperimentsMgr::ExperimentsMgr()
     m_threadPool.setMaxThreadCount(m_threads);
     qDebug() << "setting the max number of threads to" << m_threads;
 
+    // idle threads are also used to parallelize the steps of the trials
+    ParallelFor::setThreadPool(&m_threadPool);
+
     m_timerDestroy->setSingleShot(true);
     m_timerProgress->setSingleShot(true);
     connect(m_timerDestroy, SIGNAL(timeout()), SLOT(destroyExperiments()));
@@ -53,6 +57,7 @@ ExperimentsMgr::~ExperimentsMgr()
 {
     m_threadPool.clear();
     m_threadPool.waitForDone();
+    ParallelFor::setThreadPool(nullptr);
     delete m_timerProgress;
     delete m_timerDestroy;
 }
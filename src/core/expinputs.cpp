@@ -84,6 +84,11 @@ ExpInputs* ExpInputs::parse(const MainApp* mainApp, const QStringList& header,
 
     QStringList failedAttrs;
     parseAttrs(mainApp, plugins, header, values, ei, failedAttrs);
+    // the format was introduced later; experiments without it are saved in csv
+    if (!ei->m_generalAttrs->contains(OUTPUT_FORMAT)) {
+        const AttributeRange* format = mainApp->generalAttrsScope().value(OUTPUT_FORMAT);
+        ei->m_generalAttrs->replace(format->id(), OUTPUT_FORMAT, Value("csv"));
+    }
     parseFileCache(plugins.second, ei, failedAttrs, errMsg);
 
     // make sure all attributes exist
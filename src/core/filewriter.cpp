@@ -0,0 +1,272 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtDebug>
+
+#include "filewriter.h"
+
+namespace evoplex {
+
+FileWriter::FileWriter(int capacity)
+    : m_capacity(capacity),
+      m_queuedCells(0),
+      m_lastTicket(0),
+      m_doneTicket(0),
+      m_stop(false)
+{
+    Q_ASSERT_X(capacity > 0, "FileWriter", "the capacity must be positive");
+    start();
+}
+
+FileWriter::~FileWriter()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stop = true;
+        m_notEmpty.wakeAll();
+    }
+    wait();
+}
+
+bool FileWriter::create(const QString& fpath, const QByteArray& header, Format format)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_failed.remove(fpath);
+    }
+    Task task;
+    task.op = Task::Create;
+    task.fpath = fpath;
+    task.header = header;
+    task.format = format;
+    waitFor(enqueue(std::move(task)));
+
+    QMutexLocker locker(&m_mutex);
+    return !m_failed.contains(fpath);
+}
+
+bool FileWriter::write(const QString& fpath, Block&& block)
+{
+    Q_ASSERT_X(block.cells.size() == block.steps.size() * static_cast<size_t>(block.numCols),
+               "FileWriter::write", "the block must have 'numCols' cells per row");
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_failed.contains(fpath)) {
+            return false;
+        }
+    }
+    if (block.isEmpty()) {
+        return true;
+    }
+
+    Task task;
+    task.op = Task::Write;
+    task.fpath = fpath;
+    task.block = std::move(block);
+    enqueue(std::move(task));
+    return true;
+}
+
+bool FileWriter::close(const QString& fpath)
+{
+    Task task;
+    task.op = Task::Close;
+    task.fpath = fpath;
+    waitFor(enqueue(std::move(task)));
+
+    QMutexLocker locker(&m_mutex);
+    return !m_failed.remove(fpath);
+}
+
+quint64 FileWriter::enqueue(Task&& task)
+{
+    QMutexLocker locker(&m_mutex);
+    const int cells = static_cast<int>(task.block.cells.size());
+    // a block larger than the capacity is only accepted by an empty queue
+    while (m_queuedCells > 0 && m_queuedCells + cells > m_capacity) {
+        m_notFull.wait(&m_mutex);
+    }
+    task.ticket = ++m_lastTicket;
+    m_queuedCells += cells;
+    m_queue.emplace_back(std::move(task));
+    m_notEmpty.wakeOne();
+    return m_lastTicket;
+}
+
+void FileWriter::waitFor(quint64 ticket)
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_doneTicket < ticket) {
+        m_done.wait(&m_mutex);
+    }
+}
+
+void FileWriter::run()
+{
+    QByteArray buf;
+    std::deque<Task> batch;
+    QSet<QString> written;
+    forever {
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.empty() && !m_stop) {
+                m_notEmpty.wait(&m_mutex);
+            }
+            if (m_queue.empty()) {
+                break; // stopped and there is nothing else to write
+            }
+            batch.swap(m_queue);
+        }
+
+        for (const Task& task : batch) {
+            bool ok = true;
+            switch (task.op) {
+            case Task::Create:
+                ok = doCreate(task);
+                break;
+            case Task::Write:
+                ok = doWrite(task, buf);
+                written.insert(task.fpath);
+                break;
+            case Task::Close:
+                ok = doClose(task.fpath);
+                written.remove(task.fpath);
+                break;
+            }
+            if (!ok) {
+                setFailed(task.fpath);
+            }
+            if (!task.block.cells.empty()) {
+                // the cells leave the queue only once they are written
+                QMutexLocker locker(&m_mutex);
+                m_queuedCells -= static_cast<int>(task.block.cells.size());
+                m_notFull.wakeAll();
+            }
+        }
+
+        // one flush per file per batch
+        for (const QString& fpath : written) {
+            QFile* file = m_files.value(fpath, nullptr);
+            if (file && !file->flush()) {
+                setFailed(fpath);
+            }
+        }
+        written.clear();
+
+        QMutexLocker locker(&m_mutex);
+        m_doneTicket = batch.back().ticket;
+        m_done.wakeAll();
+        batch.clear();
+    }
+
+    for (const QString& fpath : m_files.keys()) {
+        doClose(fpath);
+    }
+}
+
+bool FileWriter::doCreate(const Task& task)
+{
+    doClose(task.fpath);
+
+    QFile* file = new QFile(task.fpath);
+    if (!file->open(QFile::WriteOnly | QFile::Truncate)) {
+        qWarning() << "unable to create the file" << task.fpath;
+        delete file;
+        return false;
+    }
+    m_files.insert(task.fpath, file);
+
+    QByteArray header = task.header;
+    if (task.format != CSV) {
+        ColumnFileWriter* columns = new ColumnFileWriter(task.format == CompressedBinary);
+        m_binaryFiles.insert(task.fpath, columns);
+        header = columns->begin(task.header);
+    }
+    return file->write(header) == header.size();
+}
+
+bool FileWriter::doWrite(const Task& task, QByteArray& buf)
+{
+    QFile* file = m_files.value(task.fpath, nullptr);
+    if (!file) {
+        qWarning() << "tried to write in a file which is not open" << task.fpath;
+        return false;
+    }
+
+    const Block& block = task.block;
+    ColumnFileWriter* columns = m_binaryFiles.value(task.fpath, nullptr);
+    if (columns) {
+        buf = columns->chunk(block.numCols, block.steps, block.cells);
+        if (file->write(buf) != buf.size()) {
+            qWarning() << "unable to write in the file" << task.fpath;
+            return false;
+        }
+        return true;
+    }
+
+    const Value* cell = block.cells.data();
+    buf.clear();
+    for (int row = 0; row < block.numRows(); ++row) {
+        if (block.hasSteps) {
+            buf.append(QByteArray::number(block.steps[row]));
+            buf.append(',');
+        }
+        for (int col = 0; col < block.numCols; ++col, ++cell) {
+            if (col > 0) {
+                buf.append(',');
+            }
+            ColumnFile::appendText(buf, *cell);
+        }
+        buf.append('\n');
+    }
+
+    if (file->write(buf) != buf.size()) {
+        qWarning() << "unable to write in the file" << task.fpath;
+        return false;
+    }
+    return true;
+}
+
+bool FileWriter::doClose(const QString& fpath)
+{
+    QFile* file = m_files.take(fpath);
+    if (!file) {
+        return true;
+    }
+    bool ok = true;
+    ColumnFileWriter* columns = m_binaryFiles.take(fpath);
+    if (columns) {
+        const QByteArray index = columns->end();
+        ok = file->write(index) == index.size();
+        delete columns;
+    }
+    ok = file->flush() && ok;
+    file->close();
+    delete file;
+    return ok;
+}
+
+void FileWriter::setFailed(const QString& fpath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_failed.insert(fpath);
+}
+
+} // evoplex
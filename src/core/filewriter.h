@@ -0,0 +1,144 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FILEWRITER_H
+#define FILEWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+#include <deque>
+#include <vector>
+
+#include "columnfile.h"
+#include "value.h"
+
+namespace evoplex {
+
+/**
+ *  @brief Writes the output files of the experiments in a dedicated thread.
+ *
+ *  The trials hand off blocks of rows (i.e., Values, not text), which are
+ *  queued and then formatted and written by this thread, so a trial never
+ *  waits for the disk. The files are kept open until they are closed, and
+ *  all the blocks taken from the queue at once are written before the
+ *  files are flushed.
+ *
+ *  The queue is bounded by the number of cells it holds. When it is full,
+ *  write() blocks until the writer catches up (backpressure), that is, a
+ *  slow disk slows the trials down instead of exhausting the memory.
+ *
+ *  The files are written either as CSV or as a binary ColumnFile, in
+ *  which case each block is encoded as a chunk.
+ *
+ *  The files are identified by their paths. All methods are thread-safe,
+ *  but the blocks of a file must be written by a single thread at a time.
+ */
+class FileWriter : public QThread
+{
+public:
+    enum Format {
+        CSV,
+        Binary,           // ColumnFile
+        CompressedBinary  // ColumnFile with compressed chunks
+    };
+
+    // A block of rows; each row has a step and 'numCols' cells.
+    // Invalid Values are written as empty cells.
+    struct Block {
+        int numCols = 0;
+        bool hasSteps = false;   // if true, the step is the first column (CSV only)
+        std::vector<int> steps;  // one per row
+        Values cells;            // row-major
+
+        inline int numRows() const { return static_cast<int>(steps.size()); }
+        inline bool isEmpty() const { return steps.empty(); }
+    };
+
+    // 'capacity' is the max number of cells waiting in the queue
+    explicit FileWriter(int capacity = 1 << 20);
+    // writes everything that is still in the queue and closes the files
+    ~FileWriter();
+
+    // Creates (or truncates) the file and writes the header, which is
+    // the first line of CSV files, or the column names of binary files.
+    // It blocks until the file is open; returns false if it fails.
+    bool create(const QString& fpath, const QByteArray& header, Format format = CSV);
+
+    // Queues a block of rows to be appended to the file, which must have
+    // been created. It blocks only while the queue is full.
+    // Returns false if a previous operation on the file has failed.
+    bool write(const QString& fpath, Block&& block);
+
+    // Blocks until all the rows queued for the file are written and
+    // closes it. Returns false if anything failed since it was created.
+    // It does nothing if the file is not open.
+    bool close(const QString& fpath);
+
+    inline int capacity() const { return m_capacity; }
+
+protected:
+    void run() override;
+
+private:
+    struct Task {
+        enum Op { Create, Write, Close } op;
+        QString fpath;
+        QByteArray header;
+        Format format = CSV;
+        Block block;
+        quint64 ticket;
+    };
+
+    const int m_capacity;
+
+    QMutex m_mutex;
+    QWaitCondition m_notEmpty;
+    QWaitCondition m_notFull;
+    QWaitCondition m_done;
+    std::deque<Task> m_queue;
+    int m_queuedCells;
+    quint64 m_lastTicket;   // of the last queued task
+    quint64 m_doneTicket;   // of the last task carried out
+    bool m_stop;
+    QSet<QString> m_failed;
+
+    // used by the writer thread only
+    QHash<QString, QFile*> m_files;
+    QHash<QString, ColumnFileWriter*> m_binaryFiles;
+
+    // queues a task and returns its ticket; blocks while the queue is full
+    quint64 enqueue(Task&& task);
+    // blocks until the task is carried out
+    void waitFor(quint64 ticket);
+
+    bool doCreate(const Task& task);
+    bool doWrite(const Task& task, QByteArray& buf);
+    bool doClose(const QString& fpath);
+    void setFailed(const QString& fpath);
+};
+
+} // evoplex
+#endif // FILEWRITER_H
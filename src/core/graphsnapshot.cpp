@@ -0,0 +1,468 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QtGlobal>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+
+#include "graphsnapshot.h"
+
+namespace evoplex {
+
+namespace {
+
+const char kMagic[] = "EVPXGRPH"; // 8 bytes, without the '\0'
+const int kHeaderSize = 64;
+
+static_assert(sizeof(bool) == 1 && sizeof(int) == 4 && sizeof(double) == 8,
+              "the cells of the columns are mapped in place");
+
+inline bool isLittleEndianHost()
+{ return Q_BYTE_ORDER == Q_LITTLE_ENDIAN; }
+
+template <typename T>
+inline void appendRaw(QByteArray& buf, const T& v)
+{ buf.append(reinterpret_cast<const char*>(&v), sizeof(T)); }
+
+inline void appendInts(QByteArray& buf, const std::vector<int>& v)
+{ buf.append(reinterpret_cast<const char*>(v.data()), static_cast<int>(v.size() * sizeof(int))); }
+
+// Encodes a column of 'numRows' cells, in which 'cell(row)' returns the
+// Value of a row. Returns false if a cell is not of the type 'type'.
+template <typename F>
+bool encodeColumn(Value::Type type, int numRows, F cell, QByteArray& buf, int& badRow)
+{
+    if (type == Value::STRING) {
+        std::vector<quint32> offsets(numRows + 1, 0);
+        QByteArray text;
+        for (int row = 0; row < numRows; ++row) {
+            const Value v = cell(row);
+            if (v.type() != type) {
+                badRow = row;
+                return false;
+            }
+            text.append(v.toString());
+            offsets[row+1] = static_cast<quint32>(text.size());
+        }
+        buf.append(reinterpret_cast<const char*>(offsets.data()),
+                   static_cast<int>(offsets.size() * sizeof(quint32)));
+        buf.append(text);
+        return true;
+    }
+
+    for (int row = 0; row < numRows; ++row) {
+        const Value v = cell(row);
+        if (v.type() != type) {
+            badRow = row;
+            return false;
+        }
+        switch (type) {
+        case Value::BOOL: appendRaw(buf, v.toBool()); break;
+        case Value::CHAR: appendRaw(buf, v.toChar()); break;
+        case Value::INT: appendRaw(buf, v.toInt()); break;
+        case Value::DOUBLE: appendRaw(buf, v.toDouble()); break;
+        default: badRow = row; return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+GraphSnapshot::GraphSnapshot()
+    : m_isDirected(false),
+      m_numNodes(0),
+      m_numEdges(0)
+{
+}
+
+bool GraphSnapshot::save(const QString& filePath, bool isDirected,
+                         const std::vector<NodePtr>& nodes,
+                         const std::vector<EdgePtr>& edges, QString* errMsg)
+{
+    QString error;
+    auto fail = [&error, errMsg]() {
+        if (errMsg) {
+            *errMsg = error;
+        }
+        return false;
+    };
+
+    if (!isLittleEndianHost()) {
+        error = "graph snapshots are only supported on little-endian hosts.";
+        return fail();
+    }
+
+    const int numNodes = static_cast<int>(nodes.size());
+    const int numEdges = static_cast<int>(edges.size());
+    // a deque, as the payloads are filled through references
+    std::deque<std::pair<Section, QByteArray>> sections;
+    auto addSection = [&sections](SectionKind kind, quint32 column, quint8 type) -> QByteArray& {
+        Section s;
+        std::memset(&s, 0, sizeof(Section));
+        s.kind = kind;
+        s.column = column;
+        s.type = type;
+        sections.emplace_back(s, QByteArray());
+        return sections.back().second;
+    };
+
+    // nodes
+    std::vector<int> ids(numNodes), xs(numNodes), ys(numNodes);
+    std::unordered_map<int, int> rowOf; // node id -> row
+    rowOf.reserve(nodes.size());
+    for (int row = 0; row < numNodes; ++row) {
+        ids[row] = nodes[row]->id();
+        xs[row] = nodes[row]->x();
+        ys[row] = nodes[row]->y();
+        rowOf.insert({ids[row], row});
+        Q_ASSERT_X(row == 0 || ids[row-1] < ids[row], "GraphSnapshot::save",
+                   "the nodes must be sorted by id");
+    }
+    appendInts(addSection(NodeIds, 0, 0), ids);
+    appendInts(addSection(NodeX, 0, 0), xs);
+    appendInts(addSection(NodeY, 0, 0), ys);
+
+    QByteArray& names = addSection(Names, 0, 0);
+    auto appendName = [&names](const QString& name) {
+        const QByteArray utf8 = name.toUtf8();
+        appendRaw(names, static_cast<quint32>(utf8.size()));
+        names.append(utf8);
+    };
+
+    const Attributes nodeHeader = nodes.empty() ? Attributes() : nodes.front()->attrs();
+    for (int col = 0; col < nodeHeader.size(); ++col) {
+        const Value::Type type = nodeHeader.value(col).type();
+        int badRow = 0;
+        QByteArray& buf = addSection(NodeAttr, static_cast<quint32>(col), static_cast<quint8>(type));
+        if (!encodeColumn(type, numNodes, [&nodes, col](int row) { return nodes[row]->attr(col); },
+                          buf, badRow)) {
+            error = QString("the attribute '%1' of the node %2 does not have the expected type.")
+                    .arg(nodeHeader.name(col)).arg(ids[badRow]);
+            return fail();
+        }
+        appendName(nodeHeader.name(col));
+    }
+
+    // edges, grouped by the row of their origin and sorted by id
+    std::vector<std::pair<int, int>> order; // (origin row, index in 'edges')
+    order.reserve(edges.size());
+    for (int i = 0; i < numEdges; ++i) {
+        auto o = rowOf.find(edges[i]->origin()->id());
+        auto t = rowOf.find(edges[i]->neighbour()->id());
+        if (o == rowOf.end() || t == rowOf.end()) {
+            error = QString("the edge %1 connects nodes which are not in the graph.").arg(edges[i]->id());
+            return fail();
+        }
+        order.emplace_back(o->second, i);
+    }
+    std::sort(order.begin(), order.end(),
+        [&edges](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+            return a.first < b.first || (a.first == b.first && edges[a.second]->id() < edges[b.second]->id());
+        });
+
+    std::vector<int> offsets(numNodes + 1, 0);
+    std::vector<int> targets(numEdges);
+    for (int i = 0; i < numEdges; ++i) {
+        ++offsets[order[i].first + 1];
+        targets[i] = rowOf.at(edges[order[i].second]->neighbour()->id());
+    }
+    for (int row = 0; row < numNodes; ++row) {
+        offsets[row+1] += offsets[row];
+    }
+    appendInts(addSection(EdgeOffsets, 0, 0), offsets);
+    appendInts(addSection(EdgeTargets, 0, 0), targets);
+
+    const Attributes* edgeHeader = edges.empty() ? nullptr : edges.front()->attrs();
+    const int numEdgeAttrs = edgeHeader ? edgeHeader->size() : 0;
+    for (const EdgePtr& e : edges) {
+        if ((e->attrs() ? e->attrs()->size() : 0) != numEdgeAttrs) {
+            error = QString("the edge %1 does not have the same attributes as the others.").arg(e->id());
+            return fail();
+        }
+    }
+    for (int col = 0; col < numEdgeAttrs; ++col) {
+        const Value::Type type = edgeHeader->value(col).type();
+        int badRow = 0;
+        QByteArray& buf = addSection(EdgeAttr, static_cast<quint32>(col), static_cast<quint8>(type));
+        auto cell = [&edges, &order, col](int row) { return edges[order[row].second]->attr(col); };
+        if (!encodeColumn(type, numEdges, cell, buf, badRow)) {
+            error = QString("the attribute '%1' of the edge %2 does not have the expected type.")
+                    .arg(edgeHeader->name(col)).arg(edges[order[badRow].second]->id());
+            return fail();
+        }
+        appendName(edgeHeader->name(col));
+    }
+
+    // layout: header, section table and then the sections, all aligned
+    auto align = [](quint64 pos) { return (pos + Alignment - 1) / Alignment * Alignment; };
+    quint64 pos = align(kHeaderSize + sections.size() * sizeof(Section));
+    for (auto& s : sections) {
+        s.first.offset = pos;
+        s.first.size = static_cast<quint64>(s.second.size());
+        pos = align(pos + s.first.size);
+    }
+
+    QByteArray head(kHeaderSize, '\0');
+    std::memcpy(head.data(), kMagic, 8);
+    const quint32 version = Version;
+    const quint32 flags = isDirected ? 1 : 0;
+    const quint32 numSections = static_cast<quint32>(sections.size());
+    const quint64 tableOffset = kHeaderSize;
+    std::memcpy(head.data() + 8, &version, 4);
+    std::memcpy(head.data() + 12, &flags, 4);
+    std::memcpy(head.data() + 16, &numNodes, 4);
+    std::memcpy(head.data() + 20, &numEdges, 4);
+    std::memcpy(head.data() + 24, &numSections, 4);
+    std::memcpy(head.data() + 32, &tableOffset, 8);
+    for (auto const& s : sections) {
+        appendRaw(head, s.first);
+    }
+
+    QFile file(filePath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        error = "unable to write the graph snapshot.\n" + filePath;
+        return fail();
+    }
+    bool ok = file.write(head) == head.size();
+    quint64 written = static_cast<quint64>(head.size());
+    for (auto const& s : sections) {
+        const QByteArray padding(static_cast<int>(s.first.offset - written), '\0');
+        ok = ok && file.write(padding) == padding.size() && file.write(s.second) == s.second.size();
+        written = s.first.offset + s.first.size;
+    }
+    const QByteArray padding(static_cast<int>(pos - written), '\0');
+    ok = ok && file.write(padding) == padding.size();
+    file.close();
+    if (!ok) {
+        error = "failed to write the graph snapshot.\n" + filePath;
+        return fail();
+    }
+    return true;
+}
+
+GraphSnapshotPtr GraphSnapshot::open(const QString& filePath, QString* errMsg)
+{
+    std::shared_ptr<GraphSnapshot> snapshot(new GraphSnapshot());
+    QString error;
+    if (!snapshot->read(filePath, error)) {
+        if (errMsg) {
+            *errMsg = QString("%1\n%2").arg(error).arg(filePath);
+        }
+        return GraphSnapshotPtr();
+    }
+    return snapshot;
+}
+
+bool GraphSnapshot::read(const QString& filePath, QString& error)
+{
+    if (!isLittleEndianHost()) {
+        error = "graph snapshots are only supported on little-endian hosts.";
+        return false;
+    }
+
+    m_file = std::make_shared<TextFile>();
+    if (!m_file->open(filePath)) {
+        error = "unable to read the graph snapshot.";
+        return false;
+    }
+
+    const char* data = m_file->begin();
+    const quint64 fileSize = static_cast<quint64>(m_file->size());
+    if (fileSize < kHeaderSize || std::memcmp(data, kMagic, 8) != 0) {
+        error = "this file is not a graph snapshot.";
+        return false;
+    } else if (reinterpret_cast<quintptr>(data) % alignof(double)) {
+        error = "unable to map the graph snapshot in place.";
+        return false;
+    }
+
+    quint32 version, flags, numSections;
+    quint64 tableOffset;
+    std::memcpy(&version, data + 8, 4);
+    std::memcpy(&flags, data + 12, 4);
+    std::memcpy(&m_numNodes, data + 16, 4);
+    std::memcpy(&m_numEdges, data + 20, 4);
+    std::memcpy(&numSections, data + 24, 4);
+    std::memcpy(&tableOffset, data + 32, 8);
+    m_isDirected = flags & 1;
+    if (version != Version) {
+        error = QString("unsupported version of graph snapshot: %1.").arg(version);
+        return false;
+    } else if (m_numNodes < 0 || m_numEdges < 0 || tableOffset > fileSize
+               || numSections > (fileSize - tableOffset) / sizeof(Section)) {
+        error = "the graph snapshot is corrupted.";
+        return false;
+    }
+
+    std::vector<Section> nodeAttrs, edgeAttrs;
+    std::vector<QString> names;
+    bool hasIds = false, hasX = false, hasY = false, hasOffsets = false, hasTargets = false;
+    bool ok = true;
+    for (quint32 i = 0; ok && i < numSections; ++i) {
+        Section s;
+        std::memcpy(&s, data + tableOffset + i * sizeof(Section), sizeof(Section));
+        if (s.offset % Alignment || s.offset > fileSize || s.size > fileSize - s.offset) {
+            error = "the graph snapshot is corrupted.";
+            return false;
+        }
+        switch (s.kind) {
+        case NodeIds: ok = hasIds = readInts(s, m_numNodes, m_nodeIds); break;
+        case NodeX: ok = hasX = readInts(s, m_numNodes, m_nodeX); break;
+        case NodeY: ok = hasY = readInts(s, m_numNodes, m_nodeY); break;
+        case EdgeOffsets: ok = hasOffsets = readInts(s, m_numNodes + 1LL, m_edgeOffsets); break;
+        case EdgeTargets: ok = hasTargets = readInts(s, m_numEdges, m_edgeTargets); break;
+        case NodeAttr: nodeAttrs.emplace_back(s); break;
+        case EdgeAttr: edgeAttrs.emplace_back(s); break;
+        case Names: {
+            const char* p = data + s.offset;
+            const char* end = p + s.size;
+            while (ok && p < end) {
+                quint32 size;
+                ok = end - p >= 4;
+                if (ok) {
+                    std::memcpy(&size, p, 4);
+                    p += 4;
+                    ok = size <= static_cast<quint64>(end - p);
+                }
+                if (ok) {
+                    names.emplace_back(QString::fromUtf8(p, static_cast<int>(size)));
+                    p += size;
+                }
+            }
+            break;
+        }
+        default: break; // unknown sections are skipped
+        }
+    }
+    if (!ok || !hasIds || !hasX || !hasY || !hasOffsets || !hasTargets
+            || names.size() != nodeAttrs.size() + edgeAttrs.size()) {
+        error = "the graph snapshot is corrupted.";
+        return false;
+    }
+
+    // the topology is validated once, so it can be used without checks
+    for (int row = 1; row < m_numNodes; ++row) {
+        ok = ok && m_nodeIds[row-1] < m_nodeIds[row];
+    }
+    ok = ok && (m_numNodes == 0 || m_nodeIds[0] >= 0) && m_edgeOffsets[0] == 0
+            && m_edgeOffsets[m_numNodes] == m_numEdges;
+    for (int row = 0; row < m_numNodes; ++row) {
+        ok = ok && m_edgeOffsets[row] <= m_edgeOffsets[row+1];
+    }
+    for (int target : m_edgeTargets) {
+        ok = ok && target >= 0 && target < m_numNodes;
+    }
+    if (!ok) {
+        error = "the graph snapshot has an invalid topology.";
+        return false;
+    }
+
+    auto byColumn = [](const Section& a, const Section& b) { return a.column < b.column; };
+    std::sort(nodeAttrs.begin(), nodeAttrs.end(), byColumn);
+    std::sort(edgeAttrs.begin(), edgeAttrs.end(), byColumn);
+    for (size_t col = 0; col < nodeAttrs.size(); ++col) {
+        if (nodeAttrs[col].column != col
+                || !readColumn(nodeAttrs[col], names[col], m_numNodes, m_nodeAttrs, error)) {
+            return false;
+        }
+    }
+    for (size_t col = 0; col < edgeAttrs.size(); ++col) {
+        if (edgeAttrs[col].column != col
+                || !readColumn(edgeAttrs[col], names[nodeAttrs.size() + col],
+                               m_numEdges, m_edgeAttrs, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GraphSnapshot::readInts(const Section& s, qint64 count, Span<int>& ints) const
+{
+    if (s.size != static_cast<quint64>(count) * sizeof(int)) {
+        return false;
+    }
+    const int* p = reinterpret_cast<const int*>(m_file->begin() + s.offset);
+    ints = Span<int>(p, p + count);
+    return true;
+}
+
+bool GraphSnapshot::readColumn(const Section& s, const QString& name, int numRows,
+                               AttributeColumns& columns, QString& error) const
+{
+    if (columns.indexOf(name) != -1) {
+        error = QString("the attribute '%1' is duplicated.").arg(name);
+        return false;
+    }
+
+    const char* p = m_file->begin() + s.offset;
+    const Value::Type type = static_cast<Value::Type>(s.type);
+    size_t width = 0;
+    switch (type) {
+    case Value::BOOL: width = sizeof(bool); break;
+    case Value::CHAR: width = sizeof(char); break;
+    case Value::INT: width = sizeof(int); break;
+    case Value::DOUBLE: width = sizeof(double); break;
+    case Value::STRING: break;
+    default:
+        error = QString("the attribute '%1' has an unknown type.").arg(name);
+        return false;
+    }
+
+    if (width) {
+        if (s.size != numRows * width) {
+            error = QString("the attribute '%1' is corrupted.").arg(name);
+            return false;
+        }
+        columns.appendColumn(name, type, p, numRows, m_file);
+        return true;
+    }
+
+    // strings: offsets, then the bytes
+    const quint64 textOffset = (numRows + 1ULL) * sizeof(quint32);
+    bool ok = s.size >= textOffset;
+    std::vector<quint32> offsets(ok ? numRows + 1 : 0);
+    if (ok) {
+        std::memcpy(offsets.data(), p, textOffset);
+        ok = offsets[0] == 0 && offsets[numRows] <= s.size - textOffset;
+    }
+    for (int row = 0; ok && row < numRows; ++row) {
+        ok = offsets[row] <= offsets[row+1];
+    }
+    if (!ok) {
+        error = QString("the attribute '%1' is corrupted.").arg(name);
+        return false;
+    }
+
+    Values values;
+    values.reserve(numRows);
+    const char* text = p + textOffset;
+    for (int row = 0; row < numRows; ++row) {
+        values.emplace_back(QString::fromUtf8(text + offsets[row],
+                static_cast<int>(offsets[row+1] - offsets[row])));
+    }
+    columns.appendColumn(name, type, values);
+    return true;
+}
+
+} // evoplex
@@ -0,0 +1,186 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include <QString>
+#include <memory>
+#include <vector>
+
+#include "attributecolumns.h"
+#include "edge.h"
+#include "node.h"
+#include "span.h"
+#include "textfile.h"
+
+namespace evoplex {
+
+class GraphSnapshot;
+typedef std::shared_ptr<const GraphSnapshot> GraphSnapshotPtr;
+
+/**
+ *  @brief A binary snapshot of a graph (*.evg): its nodes, their
+ *  coordinates and attributes, and its edges in compressed sparse row
+ *  (CSR) format, along with their attributes.
+ *
+ *  Every section starts at a multiple of 64 bytes and holds a plain array
+ *  in the host's (little-endian) layout, so the file is memory-mapped and
+ *  read in place, i.e., without parsing it. In particular, the fixed-width
+ *  attribute columns are used as they are by AttributeColumns, which only
+ *  copies a column if it is changed. String columns are still decoded.
+ *
+ *  Layout (integers are little-endian):
+ *    header    "EVPXGRPH", u32 version, u32 flags (1: directed),
+ *              i32 numNodes, i32 numEdges, u32 numSections, u32 0,
+ *              u64 offset of the section table, zeros up to 64 bytes
+ *    table     {u32 kind, u32 column, u8 type, 7 zeros, u64 offset,
+ *              u64 size} per section
+ *    NodeIds       i32[numNodes], in ascending order; its index is the row
+ *    NodeX, NodeY  i32[numNodes]
+ *    Names         {u32 size, utf-8} per node attribute, then per edge attribute
+ *    EdgeOffsets   i32[numNodes+1]; the edges of row r are in [off[r], off[r+1])
+ *    EdgeTargets   i32[numEdges], the row of the target of each edge
+ *    NodeAttr      a column of the node attributes (one row per node)
+ *    EdgeAttr      a column of the edge attributes (parallel to EdgeTargets)
+ *
+ *  The cells of the attribute columns are u8 (bool and char), i32 (int)
+ *  or f64 (double); strings are stored as u32 offsets[numRows+1] followed
+ *  by their utf-8 bytes. The edges of undirected graphs are stored once,
+ *  from their origin.
+ */
+class GraphSnapshot
+{
+public:
+    enum SectionKind : quint32 {
+        NodeIds = 1,
+        NodeX = 2,
+        NodeY = 3,
+        Names = 4,
+        EdgeOffsets = 5,
+        EdgeTargets = 6,
+        NodeAttr = 7,
+        EdgeAttr = 8
+    };
+
+    static const quint32 Version = 1;
+    static const int Alignment = 64;
+
+    // true if the file path has the extension of graph snapshots, i.e., *.evg
+    static inline bool isSnapshot(const QString& filePath);
+
+    // Writes a snapshot. The nodes must be sorted by id and the edges must
+    // connect them. The attributes of all nodes (and of all edges) must
+    // have the same names and types.
+    static bool save(const QString& filePath, bool isDirected,
+                     const std::vector<NodePtr>& nodes,
+                     const std::vector<EdgePtr>& edges, QString* errMsg = nullptr);
+
+    // Maps a snapshot and checks its consistency. If it fails, it returns
+    // a null pointer and sets the error message.
+    static GraphSnapshotPtr open(const QString& filePath, QString* errMsg = nullptr);
+
+    inline bool isDirected() const;
+    inline int numNodes() const;
+    inline int numEdges() const;
+
+    inline Span<int> nodeIds() const;
+    inline Span<int> nodeX() const;
+    inline Span<int> nodeY() const;
+
+    // the edges of row 'r' are in [edgeOffsets()[r], edgeOffsets()[r+1])
+    inline Span<int> edgeOffsets() const;
+    inline Span<int> edgeTargets() const;
+
+    // The attribute columns, which read the mapped file in place and keep
+    // it alive. Note that they are shared (i.e., cheap to copy).
+    inline const AttributeColumns& nodeAttrs() const;
+    inline const AttributeColumns& edgeAttrs() const;
+
+private:
+    struct Section {
+        quint32 kind;
+        quint32 column;
+        quint8 type;
+        quint8 reserved[7];
+        quint64 offset;
+        quint64 size;
+    };
+
+    std::shared_ptr<TextFile> m_file; // also owned by the attribute columns
+    bool m_isDirected;
+    int m_numNodes;
+    int m_numEdges;
+    Span<int> m_nodeIds;
+    Span<int> m_nodeX;
+    Span<int> m_nodeY;
+    Span<int> m_edgeOffsets;
+    Span<int> m_edgeTargets;
+    AttributeColumns m_nodeAttrs;
+    AttributeColumns m_edgeAttrs;
+
+    GraphSnapshot();
+
+    bool read(const QString& filePath, QString& error);
+    // points to an array of 'count' i32 of a section; false if the sizes differ
+    bool readInts(const Section& s, qint64 count, Span<int>& ints) const;
+    bool readColumn(const Section& s, const QString& name, int numRows,
+                    AttributeColumns& columns, QString& error) const;
+};
+
+/************************************************************************
+   GraphSnapshot: Inline member functions
+ ************************************************************************/
+
+inline bool GraphSnapshot::isSnapshot(const QString& filePath)
+{ return filePath.endsWith(".evg"); }
+
+inline bool GraphSnapshot::isDirected() const
+{ return m_isDirected; }
+
+inline int GraphSnapshot::numNodes() const
+{ return m_numNodes; }
+
+inline int GraphSnapshot::numEdges() const
+{ return m_numEdges; }
+
+inline Span<int> GraphSnapshot::nodeIds() const
+{ return m_nodeIds; }
+
+inline Span<int> GraphSnapshot::nodeX() const
+{ return m_nodeX; }
+
+inline Span<int> GraphSnapshot::nodeY() const
+{ return m_nodeY; }
+
+inline Span<int> GraphSnapshot::edgeOffsets() const
+{ return m_edgeOffsets; }
+
+inline Span<int> GraphSnapshot::edgeTargets() const
+{ return m_edgeTargets; }
+
+inline const AttributeColumns& GraphSnapshot::nodeAttrs() const
+{ return m_nodeAttrs; }
+
+inline const AttributeColumns& GraphSnapshot::edgeAttrs() const
+{ return m_edgeAttrs; }
+
+} // evoplex
+#endif // GRAPH_SNAPSHOT_H
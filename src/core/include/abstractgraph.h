@@ -25,8 +25,15 @@
 #include <QMutex>
 
 #include "abstractplugin.h"
+#include "arena.h"
+#include "attributecolumns.h"
+#include "attributerange.h"
+#include "csr.h"
+#include "edgelist.h"
+#include "edgepool.h"
 #include "edges.h"
 #include "nodes.h"
+#include "topologycache.h"
 
 namespace evoplex {
 
@@ -59,7 +66,7 @@ public:
 
     static GraphType enumFromString(const QString& str);
 
-    ~AbstractGraph() = default;
+    ~AbstractGraph();
 
     inline const QString& name() const;
     inline const GraphType& type() const;
@@ -70,6 +77,8 @@ public:
     inline const Edges& edges() const;
     inline const Nodes& nodes() const;
     inline const NodePtr& node(int id) const;
+    // uniformly random node in O(1), even after removing nodes;
+    // it throws std::out_of_range if the graph is empty
     inline const NodePtr& randNode() const;
 
     inline int numNodes() const;
@@ -78,9 +87,16 @@ public:
     inline NodePtr addNode(Attributes attr);
     NodePtr addNode(Attributes attr, int x, int y);
 
-    // nodes must belong to the graph
-    inline EdgePtr addEdge(const int originId, const int neighbourId, Attributes* attrs = new Attributes());
-    EdgePtr addEdge(const NodePtr& origin, const NodePtr& neighbour, Attributes* attrs = new Attributes());
+    // Nodes must belong to the graph. The graph takes the ownership of attrs;
+    // if it is a nullptr, the edge gets the default edge attributes of the
+    // model, which are only copied when the edge changes them.
+    inline EdgePtr addEdge(const int originId, const int neighbourId, Attributes* attrs = nullptr);
+    EdgePtr addEdge(const NodePtr& origin, const NodePtr& neighbour, Attributes* attrs = nullptr);
+    // Adds all the edges at once (i.e., locking the graph only once),
+    // with the default edge attributes. If the list has attributes (e.g.,
+    // from a snapshot), the ones named as the model's are used instead.
+    // The nodes must belong to the graph.
+    void addEdges(const EdgeList& edges);
 
     void removeAllEdges();
     void removeAllEdges(const NodePtr& node);
@@ -91,12 +107,47 @@ public:
     void removeEdge(const EdgePtr& edge);
     Edges::iterator removeEdge(Edges::iterator it);
 
+    // Freezes the current topology into a compressed sparse row (CSR)
+    // structure, which allows iterating over the neighbours of a node as
+    // a contiguous span. Any change in the topology (i.e., adding or
+    // removing nodes or edges) unfreezes the graph, so models which
+    // change the graph have to call it again before using csr().
+    // Note that the map-based API (e.g., Node::outEdges()) is always available.
+    void freeze();
+    inline bool isFrozen() const;
+    inline const CSR& csr() const;
+
+    // The attributes of all nodes are stored in a structure-of-arrays,
+    // i.e., one contiguous array per attribute and one row per node.
+    // The rows are aligned with the rows of csr(), so models can scan
+    // the whole population by accessing the columns directly.
+    // Adding or removing nodes invalidates the pointers to the columns.
+    inline AttributeColumns& nodeColumns();
+    inline const AttributeColumns& nodeColumns() const;
+
+    // Opt-in histograms of the edge attributes, i.e., how many edges hold
+    // each value. They are updated in O(1) when edges are added, removed
+    // or changed via setAttr(). See also AttributeColumns::histograms().
+    void setEdgeHistogramEnabled(int attrId, bool enabled);
+    inline const AttrHistograms& edgeHistograms() const;
+
+    // Exports the graph (i.e., the nodes, the edges and their attributes)
+    // to a graph snapshot (*.evg), which can be read back in place, e.g.,
+    // as the set of nodes of an experiment or by the customGraph plugin.
+    bool saveToFile(const QString& filePath, QString* errMsg = nullptr);
+
 protected:
     Nodes m_nodes;
     Edges m_edges;
 
     explicit AbstractGraph(const QString& name);
 
+    // Reads an edge list whose node ids are in [0, numNodes()). The trials
+    // of an experiment share a TopologyCache, so the file is parsed only
+    // once for all of them, including their resets.
+    // If it fails, it returns a null pointer and sets the error message.
+    EdgeListPtr readEdgeList(const QString& filePath, QString* errMsg = nullptr) const;
+
 private:
     const QString m_name;
     GraphType m_type;
@@ -104,10 +155,34 @@ private:
     int m_lastNodeId;
     int m_lastEdgeId;
     QMutex m_mutex;
+    CSR m_csr;
+    AttributeColumns m_nodeColumns;
+    std::vector<NodePtr> m_rows; // row of m_nodeColumns -> node
+    Attributes m_edgeAttrs; // default edge attributes; empty if the model has none
+    // Nodes and edges of this graph take their memory from the arena, so
+    // that destroying the graph frees them in bulk. Nodes which outlive the
+    // graph keep the arena alive.
+    ArenaPtr m_arena;
+    AttrHistograms m_edgeHists;
+    EdgePool m_edgePool;
+    TopologyCache* m_topologyCache; // owned by the experiment; might be null
+
+    // adds an edge; the caller must hold m_mutex
+    EdgePtr insertEdge(const NodePtr& origin, const NodePtr& neighbour, Attributes* attrs);
+
+    // moves the node's attributes into a new row of m_nodeColumns
+    void bindNode(const NodePtr& node);
+    // releases the node's row; the last row is moved into its place
+    void unbindNode(Node* node);
 
     // takes the ownership of the PRG
     // cannot be called twice
-    bool setup(PRG* prg, const Attributes* attrs, Nodes& nodes, const QString& graphType);
+    // If 'nodeAttrs' is not empty, its rows hold the attributes of the nodes
+    // in ascending order of id and the nodes' own attributes are ignored.
+    // The columns are shared with 'nodeAttrs' until they are changed.
+    bool setup(PRG* prg, const Attributes* attrs, Nodes& nodes,
+               const QString& graphType, const AttributesScope& edgeAttrsScope,
+               const AttributeColumns& nodeAttrs = AttributeColumns());
 };
 
 
@@ -139,8 +214,10 @@ inline const Nodes& AbstractGraph::nodes() const
 inline const NodePtr& AbstractGraph::node(int id) const
 { return m_nodes.at(id); }
 
-inline const NodePtr& AbstractGraph::randNode() const
-{ return m_nodes.at(prg()->randI(m_nodes.size()-1)); }
+inline const NodePtr& AbstractGraph::randNode() const {
+    Q_ASSERT_X(!m_rows.empty(), "AbstractGraph::randNode", "the graph is empty");
+    return m_rows.at(prg()->bounded(static_cast<std::uint32_t>(m_rows.size())));
+}
 
 inline int AbstractGraph::numEdges() const
 { return static_cast<int>(m_edges.size()); }
@@ -148,6 +225,21 @@ inline int AbstractGraph::numEdges() const
 inline int AbstractGraph::numNodes() const
 { return static_cast<int>(m_nodes.size()); }
 
+inline bool AbstractGraph::isFrozen() const
+{ return !m_csr.isEmpty(); }
+
+inline const CSR& AbstractGraph::csr() const
+{ Q_ASSERT_X(isFrozen(), "AbstractGraph::csr", "the graph must be frozen first"); return m_csr; }
+
+inline const AttrHistograms& AbstractGraph::edgeHistograms() const
+{ return m_edgeHists; }
+
+inline AttributeColumns& AbstractGraph::nodeColumns()
+{ return m_nodeColumns; }
+
+inline const AttributeColumns& AbstractGraph::nodeColumns() const
+{ return m_nodeColumns; }
+
 inline NodePtr AbstractGraph::addNode(Attributes attr)
 { return addNode(attr, 0, m_lastNodeId+1); }
 
@@ -21,8 +21,11 @@
 #ifndef ABSTRACT_MODEL_H
 #define ABSTRACT_MODEL_H
 
+#include <functional>
+
 #include "abstractgraph.h"
 #include "abstractplugin.h"
+#include "parallelfor.h"
 
 namespace evoplex {
 
@@ -69,6 +72,39 @@ protected:
     int m_currStep;
     int m_status;
 
+    // Synchronous updates of node attributes.
+    // Once a (bool, char, int or double) node attribute is double-buffered,
+    // usually in init(), the model reads the current state of all nodes
+    // from currState() and writes the next state into nextState(); the
+    // buffers are swapped in O(1) after each algorithmStep(). As the two
+    // arrays are disjoint, the update loop has no read/write hazards.
+    // Both arrays are indexed by the rows of graph()->csr() and must be
+    // requested again at every step. Also, every row of nextState() must
+    // be written, as it holds the state of two steps ago.
+    inline void setDoubleBuffered(int nodeAttrId, bool enabled = true);
+    template <typename T> inline const T* currState(int nodeAttrId) const;
+    template <typename T> inline T* nextState(int nodeAttrId) const;
+
+    // Resolves a node attribute by name, usually once in init(), so that the
+    // hot loops do not look up names. An invalid handle means that there is
+    // no such attribute or that its type is not T; init() should then fail.
+    template <typename T> inline AttrHandle<T> nodeAttr(const char* name) const;
+    template <typename T> inline void setDoubleBuffered(AttrHandle<T> h, bool enabled = true);
+    template <typename T> inline const T* currState(AttrHandle<T> h) const;
+    template <typename T> inline T* nextState(AttrHandle<T> h) const;
+
+    // Calls fn(begin, end) for blocks of ParallelFor::kBlockSize rows of
+    // graph()->csr() (i.e., nodes) using the idle threads of the pool which
+    // runs the trials, and returns when all blocks are done. The body must
+    // only write to the rows in [begin, end) of raw arrays, i.e., the
+    // nextState() or data<T>() pointers taken before the loop, and must not
+    // change the graph. In particular, Node::setAttr() is not allowed, as it
+    // may copy a shared column and updates the histograms. Blocks which need
+    // random numbers should use their own stream, e.g.,
+    // prg()->split(currStep()).split(begin / ParallelFor::kBlockSize),
+    // which makes the results independent of the number of threads.
+    inline void parallelForNodes(const std::function<void(int, int)>& fn) const;
+
     explicit AbstractModel()
         : AbstractPlugin(), m_graph(nullptr), m_currStep(0), m_status(0) {}
 
@@ -110,6 +146,40 @@ inline int AbstractModel::currStep() const
 inline int AbstractModel::status() const
 { return m_status; }
 
+inline void AbstractModel::setDoubleBuffered(int nodeAttrId, bool enabled)
+{ m_graph->nodeColumns().setDoubleBuffered(nodeAttrId, enabled); }
+
+template <typename T>
+inline const T* AbstractModel::currState(int nodeAttrId) const
+{ return m_graph->nodeColumns().data<T>(nodeAttrId); }
+
+template <typename T>
+inline T* AbstractModel::nextState(int nodeAttrId) const
+{ return m_graph->nodeColumns().backData<T>(nodeAttrId); }
+
+template <typename T>
+inline AttrHandle<T> AbstractModel::nodeAttr(const char* name) const
+{ return m_graph->nodeColumns().handle<T>(name); }
+
+template <typename T>
+inline void AbstractModel::setDoubleBuffered(AttrHandle<T> h, bool enabled)
+{ setDoubleBuffered(h.column(), enabled); }
+
+template <typename T>
+inline const T* AbstractModel::currState(AttrHandle<T> h) const
+{ return currState<T>(h.column()); }
+
+template <typename T>
+inline T* AbstractModel::nextState(AttrHandle<T> h) const
+{ return nextState<T>(h.column()); }
+
+inline void AbstractModel::parallelForNodes(const std::function<void(int, int)>& fn) const {
+    AttributeColumns& columns = m_graph->nodeColumns();
+    columns.setSweeping(true);
+    ParallelFor::run(columns.numRows(), fn);
+    columns.setSweeping(false);
+}
+
 inline Values AbstractModel::customOutputs(const Values& inputs) const
 { Q_UNUSED(inputs); return Values(); }
 
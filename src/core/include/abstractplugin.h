@@ -21,7 +21,10 @@
 #ifndef BASE_PLUGIN_H
 #define BASE_PLUGIN_H
 
+#include <QByteArray>
+#include <QHash>
 #include <QString>
+#include <cstring>
 
 #include "attributes.h"
 #include "prg.h"
@@ -58,6 +61,11 @@ protected:
 
 private:
     const Attributes* m_attrs;
+    QHash<QString, int> m_attrIndex; // name -> id, built in setup()
+    QHash<QByteArray, int> m_attrUtf8Index; // same, but UTF-8 names
+
+    inline int indexOf(const char* name) const;
+    inline int indexOf(const QString& name) const;
 };
 
 /************************************************************************
@@ -77,28 +85,44 @@ inline const Value& AbstractPlugin::attr(int attrId) const
 { return m_attrs->value(attrId);  }
 
 inline const Value& AbstractPlugin::attr(const char* name) const
-{ return m_attrs->value(name); }
+{ return m_attrs->value(indexOf(name)); }
 
 inline const Value& AbstractPlugin::attr(const QString& name) const
-{ return m_attrs->value(name); }
+{ return m_attrs->value(indexOf(name)); }
 
 inline const Value& AbstractPlugin::attr(const char* name, const Value& defaultValue) const
-{ return m_attrs->value(name, defaultValue); }
+{ return m_attrs->value(indexOf(name), defaultValue); }
 
 inline const Value& AbstractPlugin::attr(const QString& name, const Value& defaultValue) const
-{ return m_attrs->value(name, defaultValue); }
+{ return m_attrs->value(indexOf(name), defaultValue); }
 
 inline bool AbstractPlugin::attrExists(const char* name) const
-{ return m_attrs->contains(name); }
+{ return indexOf(name) > -1; }
 
 inline bool AbstractPlugin::attrExists(const QString& name) const
-{ return m_attrs->contains(name); }
+{ return indexOf(name) > -1; }
+
+inline int AbstractPlugin::indexOf(const char* name) const
+{ return m_attrUtf8Index.value(QByteArray::fromRawData(name, static_cast<int>(std::strlen(name))), -1); }
+
+inline int AbstractPlugin::indexOf(const QString& name) const
+{ return m_attrIndex.value(name, -1); }
 
 inline bool AbstractPlugin::setup(PRG* prg, const Attributes* attrs) {
     Q_ASSERT_X(prg, "AbstractPlugin::setup", "PRG must not be null");
     Q_ASSERT_X(!m_prg, "AbstractPlugin::setup", "tried to setup a plugin twice");
     m_prg = prg;
     m_attrs = attrs;
+    m_attrIndex.clear();
+    m_attrUtf8Index.clear();
+    if (m_attrs) {
+        for (int id = 0; id < m_attrs->size(); ++id) {
+            if (!m_attrIndex.contains(m_attrs->name(id))) { // the first one wins
+                m_attrIndex.insert(m_attrs->name(id), id);
+                m_attrUtf8Index.insert(m_attrs->name(id).toUtf8(), id);
+            }
+        }
+    }
     return m_prg != nullptr;
 }
 
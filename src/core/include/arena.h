@@ -0,0 +1,155 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <QMutex>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace evoplex {
+
+class Arena;
+typedef std::shared_ptr<Arena> ArenaPtr;
+
+/**
+ *  @brief A monotonic memory arena.
+ *
+ *  Memory is carved out of large blocks which are only returned to the
+ *  system when the arena is destroyed, i.e., all objects allocated from it
+ *  are freed at once. Small blocks passed to deallocate() are kept in
+ *  free lists per size and reused by the next allocations of the same
+ *  size, so containers which keep inserting and erasing elements (e.g.,
+ *  the edges of a node) do not grow the arena indefinitely.
+ *
+ *  It is thread-safe, but it is meant to be used by a single trial.
+ */
+class Arena
+{
+public:
+    Arena() : m_head(nullptr), m_end(nullptr), m_nextBlockSize(kMinBlockSize), m_bytes(0) {}
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    void deallocate(void* p, size_t bytes);
+
+    // total amount of memory taken from the system
+    inline size_t bytesReserved() const;
+
+private:
+    static const size_t kMinBlockSize = 64 * 1024;
+    static const size_t kMaxBlockSize = 4 * 1024 * 1024;
+    static const size_t kGranularity = 16;
+    static const size_t kNumFreeLists = 32; // blocks up to 512 bytes
+
+    struct FreeBlock { FreeBlock* next; };
+
+    QMutex m_mutex;
+    char* m_head;
+    char* m_end;
+    size_t m_nextBlockSize;
+    size_t m_bytes;
+    std::vector<char*> m_blocks;
+    FreeBlock* m_freeLists[kNumFreeLists] = {};
+
+    void* allocateFromBlock(size_t bytes, size_t alignment);
+};
+
+/**
+ *  @brief A standard allocator which takes the memory from an Arena.
+ *  Each copy shares the ownership of the Arena, so objects created with
+ *  std::allocate_shared keep it alive. Without an Arena, it falls back to
+ *  the global operator new.
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    ArenaAllocator() {}
+    ArenaAllocator(const ArenaPtr& arena) : m_arena(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& a) : m_arena(a.arena()) {}
+
+    inline T* allocate(size_t n);
+    inline void deallocate(T* p, size_t n);
+
+    inline const ArenaPtr& arena() const;
+
+    template <typename U>
+    struct rebind { typedef ArenaAllocator<U> other; };
+
+private:
+    ArenaPtr m_arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{ return a.arena() == b.arena(); }
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{ return a.arena() != b.arena(); }
+
+/************************************************************************
+   Arena: Inline member functions
+ ************************************************************************/
+
+inline size_t Arena::bytesReserved() const
+{ return m_bytes; }
+
+/************************************************************************
+   ArenaAllocator: Inline member functions
+ ************************************************************************/
+
+template <typename T>
+inline T* ArenaAllocator<T>::allocate(size_t n) {
+    if (m_arena) {
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+}
+
+template <typename T>
+inline void ArenaAllocator<T>::deallocate(T* p, size_t n) {
+    if (m_arena) {
+        m_arena->deallocate(p, n * sizeof(T));
+    } else {
+        ::operator delete(p);
+    }
+}
+
+template <typename T>
+inline const ArenaPtr& ArenaAllocator<T>::arena() const
+{ return m_arena; }
+
+} // evoplex
+#endif // ARENA_H
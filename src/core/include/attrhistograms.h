@@ -0,0 +1,213 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATTR_HISTOGRAMS_H
+#define ATTR_HISTOGRAMS_H
+
+#include <QtGlobal>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "value.h"
+
+namespace evoplex {
+
+/**
+ *  @brief Counts how many entities (e.g., nodes or edges) hold each value
+ *  of an attribute.
+ *
+ *  Only the attributes which are tracked (opt-in) are counted. The owner of
+ *  the attributes keeps the counts up to date whenever an attribute changes,
+ *  which costs O(1), so reading them does not need a scan over the entities.
+ *  When the owner cannot see a change (e.g., a write to a raw array), it
+ *  marks the attribute as stale and rebuilds the counts before reading them.
+ */
+class AttrHistograms
+{
+public:
+    AttrHistograms() : m_numStale(0) {}
+
+    // true if no attribute is tracked
+    inline bool isEmpty() const;
+    inline const std::vector<int>& tracked() const;
+    inline bool isTracked(int attrId) const;
+
+    // Starts counting the values of an attribute from zero, i.e.,
+    // the owner is expected to add() the current values.
+    inline void track(int attrId);
+    inline void untrack(int attrId);
+    inline void clear();
+
+    // sets all the counts to zero and the attributes as not stale
+    inline void reset();
+    inline void reset(int attrId);
+
+    inline bool hasStale() const;
+    inline bool isStale(int attrId) const;
+    inline void setStale(int attrId);
+
+    inline void add(int attrId, const Value& value);
+    inline void remove(int attrId, const Value& value);
+    inline void replace(int attrId, const Value& from, const Value& to);
+
+    // number of entities holding the value
+    inline int count(int attrId, const Value& value) const;
+
+private:
+    // Values are counted bit-exactly. Value::operator==() compares doubles
+    // with a tolerance, which does not agree with their hash, i.e., a value
+    // could be replaced by a nearly equal one without being counted.
+    struct ExactEqual {
+        inline bool operator()(const Value& a, const Value& b) const;
+    };
+    typedef std::unordered_map<Value, int, std::hash<Value>, ExactEqual> Counts;
+
+    struct Histogram {
+        Histogram() : isTracked(false), isStale(false) {}
+        bool isTracked;
+        bool isStale;
+        Counts counts;
+    };
+
+    std::vector<Histogram> m_hists; // attrId -> histogram
+    std::vector<int> m_tracked;
+    int m_numStale;
+};
+
+/************************************************************************
+   AttrHistograms: Inline member functions
+ ************************************************************************/
+
+inline bool AttrHistograms::isEmpty() const
+{ return m_tracked.empty(); }
+
+inline const std::vector<int>& AttrHistograms::tracked() const
+{ return m_tracked; }
+
+inline bool AttrHistograms::isTracked(int attrId) const
+{ return attrId < static_cast<int>(m_hists.size()) && m_hists[attrId].isTracked; }
+
+inline void AttrHistograms::track(int attrId) {
+    if (isTracked(attrId)) {
+        reset(attrId);
+        return;
+    }
+    if (attrId >= static_cast<int>(m_hists.size())) {
+        m_hists.resize(attrId + 1);
+    }
+    m_hists[attrId].isTracked = true;
+    m_tracked.emplace_back(attrId);
+}
+
+inline void AttrHistograms::untrack(int attrId) {
+    if (!isTracked(attrId)) {
+        return;
+    }
+    reset(attrId);
+    m_hists[attrId].isTracked = false;
+    for (size_t i = 0; i < m_tracked.size(); ++i) {
+        if (m_tracked[i] == attrId) {
+            m_tracked.erase(m_tracked.begin() + i);
+            break;
+        }
+    }
+}
+
+inline void AttrHistograms::clear() {
+    m_hists.clear();
+    m_tracked.clear();
+    m_numStale = 0;
+}
+
+inline void AttrHistograms::reset() {
+    for (int attrId : m_tracked) {
+        reset(attrId);
+    }
+}
+
+inline void AttrHistograms::reset(int attrId) {
+    Histogram& h = m_hists.at(attrId);
+    h.counts.clear();
+    if (h.isStale) {
+        h.isStale = false;
+        --m_numStale;
+    }
+}
+
+inline bool AttrHistograms::hasStale() const
+{ return m_numStale > 0; }
+
+inline bool AttrHistograms::isStale(int attrId) const
+{ return isTracked(attrId) && m_hists[attrId].isStale; }
+
+inline void AttrHistograms::setStale(int attrId) {
+    Histogram& h = m_hists.at(attrId);
+    if (h.isTracked && !h.isStale) {
+        h.isStale = true;
+        ++m_numStale;
+    }
+}
+
+inline void AttrHistograms::add(int attrId, const Value& value)
+{ ++m_hists[attrId].counts[value]; }
+
+inline void AttrHistograms::remove(int attrId, const Value& value) {
+    Counts& counts = m_hists[attrId].counts;
+    auto it = counts.find(value);
+    Q_ASSERT_X(it != counts.end(), "AttrHistograms", "the value is not in the histogram");
+    if (--it->second == 0) {
+        counts.erase(it);
+    }
+}
+
+inline void AttrHistograms::replace(int attrId, const Value& from, const Value& to) {
+    if (!ExactEqual()(from, to)) {
+        remove(attrId, from);
+        add(attrId, to);
+    }
+}
+
+inline int AttrHistograms::count(int attrId, const Value& value) const {
+    Q_ASSERT_X(!isStale(attrId), "AttrHistograms", "the histogram must be rebuilt first");
+    const Counts& counts = m_hists.at(attrId).counts;
+    auto it = counts.find(value);
+    return it == counts.end() ? 0 : it->second;
+}
+
+inline bool AttrHistograms::ExactEqual::operator()(const Value& a, const Value& b) const {
+    if (a.type() != b.type()) {
+        return false;
+    }
+    switch (a.type()) {
+    case Value::DOUBLE: {
+        const double da = a.toDouble(), db = b.toDouble();
+        return std::memcmp(&da, &db, sizeof(double)) == 0;
+    }
+    case Value::INT: return a.toInt() == b.toInt();
+    case Value::BOOL: return a.toBool() == b.toBool();
+    case Value::CHAR: return a.toChar() == b.toChar();
+    case Value::STRING: return a.toSymbol() == b.toSymbol();
+    default: return true; // invalid
+    }
+}
+
+} // evoplex
+#endif // ATTR_HISTOGRAMS_H
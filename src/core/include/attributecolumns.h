@@ -0,0 +1,412 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATTRIBUTE_COLUMNS_H
+#define ATTRIBUTE_COLUMNS_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QtGlobal>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "attrhistograms.h"
+#include "attributes.h"
+#include "value.h"
+
+namespace evoplex {
+
+// maps a C++ type to the type of a fixed-width column
+template <typename T> struct ColumnType;
+template <> struct ColumnType<bool>   { static const Value::Type type = Value::BOOL; };
+template <> struct ColumnType<char>   { static const Value::Type type = Value::CHAR; };
+template <> struct ColumnType<int>    { static const Value::Type type = Value::INT; };
+template <> struct ColumnType<double> { static const Value::Type type = Value::DOUBLE; };
+
+/**
+ *  @brief A typed reference to a fixed-width column of AttributeColumns.
+ *
+ *  Handles are resolved by name once, usually in the model's init(), and
+ *  then give direct access to the column, i.e., without looking up names
+ *  or converting Values.
+ */
+template <typename T>
+class AttrHandle
+{
+public:
+    typedef T value_type;
+
+    AttrHandle() : m_col(-1) {}
+    explicit AttrHandle(int col) : m_col(col) {}
+
+    inline bool isValid() const { return m_col >= 0; }
+    inline int column() const { return m_col; }
+
+private:
+    int m_col;
+};
+
+/**
+ *  @brief A structure-of-arrays store of attributes.
+ *
+ *  It keeps one contiguous array per attribute (i.e., a column) and one
+ *  row per entity, e.g., a node. The names are stored only once and the
+ *  types of the columns are defined by the first row. Bool, char, int and
+ *  double columns are stored as raw typed arrays, whereas any other type
+ *  falls back to a vector of Values.
+ *
+ *  A column can also be double-buffered to support synchronous updates:
+ *  the current state is read from the front buffer (i.e., data() and
+ *  value()) while the next state is written into the back buffer (i.e.,
+ *  backData()); swapBuffers() then swaps both buffers in O(1).
+ *
+ *  Copies are cheap: they share the columns with the original until one
+ *  of them changes a column, which then gets its own copy (copy-on-write).
+ *  It allows trials to start from the same initial population without
+ *  copying it upfront. Note that the non-const data() counts as a change.
+ *  Likewise, a fixed-width column can read its rows in place from memory
+ *  owned by someone else (e.g., a memory-mapped file); the rows are only
+ *  copied when the column is first changed.
+ *
+ *  Columns may also keep a histogram of their values (opt-in), which is
+ *  updated in O(1) by setValue(), appendRow() and removeRow(). Writes to
+ *  the raw arrays (i.e., the non-const data() and swapBuffers()) can't be
+ *  followed, so they mark the histogram as stale and the next call to
+ *  histograms() rebuilds it in O(N). That is, models which change a few
+ *  rows per step via setValue() (e.g., Node::setAttr()) get the counts of
+ *  the values almost for free.
+ */
+class AttributeColumns
+{
+public:
+    AttributeColumns() : m_numRows(0), m_isSweeping(false) {}
+
+    inline int numRows() const;
+    inline int numColumns() const;
+
+    inline const std::vector<QString>& names() const;
+    inline const QString& name(int col) const;
+    inline int indexOf(const char* name) const;
+    inline int indexOf(const QString& name) const;
+    inline Value::Type type(int col) const;
+
+    // Resolves a fixed-width column by name. The handle is invalid (and a
+    // warning is printed) if there is no such column or if its type is not T.
+    template <typename T> AttrHandle<T> handle(const char* name) const;
+
+    // true if the column is still shared with a copy of this object
+    inline bool isShared(int col) const;
+
+    // Appends a row and returns its index. The first row defines the
+    // layout (names and types) of the columns.
+    int appendRow(const Attributes& attrs);
+
+    // Appends a fixed-width column whose 'numRows' rows are read in place
+    // from 'rows', e.g., a memory-mapped file, which 'owner' keeps alive.
+    // All columns must have the same number of rows.
+    void appendColumn(const QString& name, Value::Type type, const char* rows,
+                      int numRows, const std::shared_ptr<const void>& owner);
+
+    // Appends a column holding a copy of 'values', one per row.
+    void appendColumn(const QString& name, Value::Type type, const Values& values);
+
+    // Appends a column of 'other', which is shared until one of them changes it.
+    void appendColumn(const AttributeColumns& other, int col);
+
+    // Removes a row by moving the last row into its place.
+    void removeRow(int row);
+
+    void clear();
+
+    inline Value value(int row, int col) const;
+    inline void setValue(int row, int col, const Value& value);
+
+    template <typename T> inline T value(int row, AttrHandle<T> h) const;
+    template <typename T> inline void setValue(int row, AttrHandle<T> h, T value);
+
+    // Set while the rows are swept in parallel (e.g., parallelForNodes()).
+    // setValue() is not thread-safe, as it may copy a shared column and
+    // updates the histograms, so only the raw arrays can be written then.
+    inline void setSweeping(bool sweeping);
+    inline bool isSweeping() const;
+
+    // Copies a row into an Attributes object.
+    Attributes row(int row) const;
+
+    // Direct access to the contiguous array of a fixed-width column.
+    // T must match the type of the column: bool, char, int or double.
+    template <typename T> inline T* data(int col);
+    template <typename T> inline const T* data(int col) const;
+
+    // Enables (or disables) the back buffer of a fixed-width column.
+    // The back buffer starts as a copy of the front buffer.
+    void setDoubleBuffered(int col, bool enabled);
+    inline bool isDoubleBuffered(int col) const;
+
+    // Direct access to the back buffer of a double-buffered column.
+    // Note that, after a swap, it holds the state of two swaps ago, so
+    // every row is expected to be rewritten before the next swap.
+    template <typename T> inline T* backData(int col);
+
+    // Swaps the front and back buffers of all double-buffered columns.
+    // Pointers obtained from data() and backData() swap their roles too.
+    void swapBuffers();
+
+    // Enables (or disables) the histogram of a column.
+    void setHistogramEnabled(int col, bool enabled);
+    inline bool hasHistogram(int col) const;
+    // true if the next call to histograms() will rebuild the column's histogram
+    inline bool isHistogramStale(int col) const;
+    // the histograms of the columns, in which the stale ones are rebuilt
+    inline const AttrHistograms& histograms() const;
+
+private:
+    struct Column {
+        Value::Type type;
+        size_t width;           // bytes per row; 0 for the other types
+        std::shared_ptr<std::vector<char>> bytes; // fixed-width types
+        std::shared_ptr<const char> mapped; // read-only rows used instead of 'bytes'
+        size_t mappedSize;
+        std::vector<char> back; // back buffer of fixed-width types
+        std::shared_ptr<Values> values; // other types
+        bool doubleBuffered;
+    };
+
+    std::vector<QString> m_names;
+    QHash<QString, int> m_index; // name -> column
+    QHash<QByteArray, int> m_utf8Index; // same, but UTF-8 names; for indexOf(const char*)
+    std::vector<Column> m_columns;
+    int m_numRows;
+    mutable AttrHistograms m_hists; // rebuilt lazily when stale
+    bool m_isSweeping;
+
+    // the buffers of a column, copied first if they are shared
+    inline static std::vector<char>& bytes(Column& c);
+    inline static const char* constBytes(const Column& c);
+    inline static Values& values(Column& c);
+
+    // as data(), but without marking the histogram as stale
+    template <typename T> inline T* rawData(int col);
+    // Writes a value without updating the histogram. Numeric values are
+    // converted to the type of fixed-width columns; other values are not
+    // written to those columns.
+    inline void write(int row, int col, const Value& value);
+    // converts a numeric value to T; false if the value is not numeric
+    template <typename T> inline static bool convert(const Value& value, T& out);
+    void warnInvalidWrite(int col, const Value& value) const;
+
+    // adds a column without rows, which the caller then fills
+    Column& addColumn(const QString& name, Value::Type type, int numRows);
+    void rebuildHistogram(int col) const;
+};
+
+/************************************************************************
+   AttributeColumns: Inline member functions
+ ************************************************************************/
+
+inline int AttributeColumns::numRows() const
+{ return m_numRows; }
+
+inline int AttributeColumns::numColumns() const
+{ return static_cast<int>(m_columns.size()); }
+
+inline const std::vector<QString>& AttributeColumns::names() const
+{ return m_names; }
+
+inline const QString& AttributeColumns::name(int col) const
+{ return m_names.at(col); }
+
+inline int AttributeColumns::indexOf(const char* name) const
+{ return m_utf8Index.value(QByteArray::fromRawData(name, static_cast<int>(std::strlen(name))), -1); }
+
+inline int AttributeColumns::indexOf(const QString& name) const
+{ return m_index.value(name, -1); }
+
+template <typename T>
+AttrHandle<T> AttributeColumns::handle(const char* name) const {
+    const int col = indexOf(name);
+    if (col < 0) {
+        qWarning("AttributeColumns: there is no attribute named '%s'", name);
+        return AttrHandle<T>();
+    } else if (m_columns[col].type != ColumnType<T>::type) {
+        qWarning("AttributeColumns: the attribute '%s' has a different type", name);
+        return AttrHandle<T>();
+    }
+    return AttrHandle<T>(col);
+}
+
+inline Value::Type AttributeColumns::type(int col) const
+{ return m_columns.at(col).type; }
+
+inline bool AttributeColumns::isShared(int col) const {
+    const Column& c = m_columns.at(col);
+    return c.width ? (c.mapped || c.bytes.use_count() > 1) : c.values.use_count() > 1;
+}
+
+inline Value AttributeColumns::value(int row, int col) const
+{
+    Q_ASSERT_X(row >= 0 && row < m_numRows, "AttributeColumns", "row out of range");
+    const Column& c = m_columns.at(col);
+    switch (c.type) {
+    case Value::BOOL: return Value(data<bool>(col)[row]);
+    case Value::CHAR: return Value(data<char>(col)[row]);
+    case Value::INT: return Value(data<int>(col)[row]);
+    case Value::DOUBLE: return Value(data<double>(col)[row]);
+    default: return (*c.values)[row];
+    }
+}
+
+inline void AttributeColumns::setValue(int row, int col, const Value& value)
+{
+    Q_ASSERT_X(!m_isSweeping, "AttributeColumns::setValue",
+               "values cannot be set during a parallel sweep; write to the raw arrays instead");
+    if (m_hists.isTracked(col)) {
+        const Value prev = AttributeColumns::value(row, col);
+        write(row, col, value);
+        m_hists.replace(col, prev, AttributeColumns::value(row, col));
+    } else {
+        write(row, col, value);
+    }
+}
+
+inline void AttributeColumns::write(int row, int col, const Value& value)
+{
+    Q_ASSERT_X(row >= 0 && row < m_numRows, "AttributeColumns", "row out of range");
+    Column& c = m_columns.at(col);
+    bool ok = true;
+    switch (c.type) {
+    case Value::BOOL: { bool v; if ((ok = convert(value, v))) rawData<bool>(col)[row] = v; break; }
+    case Value::CHAR: { char v; if ((ok = convert(value, v))) rawData<char>(col)[row] = v; break; }
+    case Value::INT: { int v; if ((ok = convert(value, v))) rawData<int>(col)[row] = v; break; }
+    case Value::DOUBLE: { double v; if ((ok = convert(value, v))) rawData<double>(col)[row] = v; break; }
+    default: values(c)[row] = value;
+    }
+    if (!ok) {
+        warnInvalidWrite(col, value);
+    }
+}
+
+template <typename T>
+inline bool AttributeColumns::convert(const Value& value, T& out)
+{
+    switch (value.type()) {
+    case Value::BOOL: out = static_cast<T>(value.toBool()); return true;
+    case Value::CHAR: out = static_cast<T>(value.toChar()); return true;
+    case Value::INT: out = static_cast<T>(value.toInt()); return true;
+    case Value::DOUBLE: out = static_cast<T>(value.toDouble()); return true;
+    default: return false;
+    }
+}
+
+template <typename T>
+inline T AttributeColumns::value(int row, AttrHandle<T> h) const
+{ return data<T>(h.column())[row]; }
+
+template <typename T>
+inline void AttributeColumns::setValue(int row, AttrHandle<T> h, T value) {
+    Q_ASSERT_X(!m_isSweeping, "AttributeColumns::setValue",
+               "values cannot be set during a parallel sweep; write to the raw arrays instead");
+    T& v = rawData<T>(h.column())[row];
+    if (m_hists.isTracked(h.column())) {
+        m_hists.replace(h.column(), Value(v), Value(value));
+    }
+    v = value;
+}
+
+inline void AttributeColumns::setSweeping(bool sweeping)
+{ m_isSweeping = sweeping; }
+
+inline bool AttributeColumns::isSweeping() const
+{ return m_isSweeping; }
+
+inline bool AttributeColumns::hasHistogram(int col) const
+{ return m_hists.isTracked(col); }
+
+inline bool AttributeColumns::isHistogramStale(int col) const
+{ return m_hists.isStale(col); }
+
+inline const AttrHistograms& AttributeColumns::histograms() const {
+    if (m_hists.hasStale()) {
+        for (int col : m_hists.tracked()) {
+            if (m_hists.isStale(col)) {
+                rebuildHistogram(col);
+            }
+        }
+    }
+    return m_hists;
+}
+
+inline bool AttributeColumns::isDoubleBuffered(int col) const
+{ return m_columns.at(col).doubleBuffered; }
+
+template <typename T>
+inline T* AttributeColumns::backData(int col) {
+    Q_ASSERT_X(m_columns.at(col).type == ColumnType<T>::type, "AttributeColumns",
+               "the requested type does not match the column's type");
+    Q_ASSERT_X(isDoubleBuffered(col), "AttributeColumns", "the column is not double-buffered");
+    return reinterpret_cast<T*>(m_columns[col].back.data());
+}
+
+template <typename T>
+inline T* AttributeColumns::data(int col) {
+    if (m_hists.isTracked(col)) {
+        m_hists.setStale(col);
+    }
+    return rawData<T>(col);
+}
+
+template <typename T>
+inline T* AttributeColumns::rawData(int col) {
+    Q_ASSERT_X(m_columns.at(col).type == ColumnType<T>::type, "AttributeColumns",
+               "the requested type does not match the column's type");
+    return reinterpret_cast<T*>(bytes(m_columns[col]).data());
+}
+
+template <typename T>
+inline const T* AttributeColumns::data(int col) const {
+    Q_ASSERT_X(m_columns.at(col).type == ColumnType<T>::type, "AttributeColumns",
+               "the requested type does not match the column's type");
+    return reinterpret_cast<const T*>(constBytes(m_columns[col]));
+}
+
+inline std::vector<char>& AttributeColumns::bytes(Column& c) {
+    if (c.mapped) {
+        c.bytes = std::make_shared<std::vector<char>>(c.mapped.get(), c.mapped.get() + c.mappedSize);
+        c.mapped.reset();
+    } else if (c.bytes.use_count() > 1) {
+        c.bytes = std::make_shared<std::vector<char>>(*c.bytes);
+    }
+    return *c.bytes;
+}
+
+inline const char* AttributeColumns::constBytes(const Column& c)
+{ return c.mapped ? c.mapped.get() : c.bytes->data(); }
+
+inline Values& AttributeColumns::values(Column& c) {
+    if (c.values.use_count() > 1) {
+        c.values = std::make_shared<Values>(*c.values);
+    }
+    return *c.values;
+}
+
+} // evoplex
+#endif // ATTRIBUTE_COLUMNS_H
@@ -113,7 +113,7 @@ inline bool Attributes::isEmpty() const
 { return m_names.empty(); }
 
 inline int Attributes::indexOf(const char* name) const
-{ return indexOf(QString::fromLocal8Bit(name)); }
+{ return indexOf(QString::fromUtf8(name)); }
 
 inline int Attributes::indexOf(const QString& name) const {
     int idx = std::find(m_names.begin(), m_names.end(), name) - m_names.begin();
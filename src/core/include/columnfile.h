@@ -0,0 +1,139 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COLUMN_FILE_H
+#define COLUMN_FILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <vector>
+
+#include "value.h"
+
+namespace evoplex {
+
+/**
+ *  @brief A binary, columnar file of rows of Values, e.g., the outputs
+ *  of a trial. It is an alternative to CSV files, which are slow to write
+ *  and several times larger.
+ *
+ *  Rows are stored in chunks, column by column. Each column of a chunk
+ *  has a single type and fixed-width cells (except for strings); cells
+ *  without a value (e.g., sampled outputs) are flagged in a bitmap. The
+ *  chunks can be compressed, and an index at the end of the file points
+ *  to each of them. Every row also holds its step.
+ *
+ *  Layout (integers are little-endian):
+ *    file      "EVPXCOL1", u32 flags, u32 header size, header (utf-8)
+ *    chunk     u32 size, data (compressed with qCompress if flags & 1)
+ *    data      u32 numRows, u32 numCols, i32 steps[numRows],
+ *              and, for each column, u8 type, u8 hasEmpty,
+ *              [bitmap of non-empty cells], cells
+ *    index     u32 numChunks, {u64 offset, u32 numRows,
+ *              i32 firstStep, i32 lastStep} per chunk
+ *    trailer   u64 offset of the index, "EVPXIDX1"
+ *
+ *  A file without the index (e.g., the writer was interrupted) can still
+ *  be read, as the chunks are found by walking through them.
+ */
+class ColumnFile
+{
+public:
+    enum Flag {
+        Compressed = 1
+    };
+
+    struct ChunkInfo {
+        qint64 offset;
+        int numRows;
+        int firstStep;
+        int lastStep;
+    };
+
+    // the types of the columns
+    enum ColumnType : quint8 {
+        Empty = 0,   // no values at all
+        Int = 1,     // i32
+        Double = 2,  // f64
+        Bool = 3,    // u8
+        Char = 4,    // u8
+        String = 5   // u32 sizes[numRows], then the bytes; also used for mixed types
+    };
+
+    // appends the text (CSV) representation of a Value; nothing if invalid
+    static void appendText(QByteArray& buf, const Value& v);
+};
+
+/**
+ *  @brief Encodes a ColumnFile. It does not write anything, it just
+ *  returns the bytes to be appended to the file.
+ */
+class ColumnFileWriter
+{
+public:
+    explicit ColumnFileWriter(bool compressed);
+
+    QByteArray begin(const QByteArray& header);
+    // 'cells' holds 'numCols' Values per step, row by row
+    QByteArray chunk(int numCols, const std::vector<int>& steps, const Values& cells);
+    QByteArray end();
+
+    inline bool isCompressed() const { return m_compressed; }
+
+private:
+    const bool m_compressed;
+    qint64 m_offset; // bytes written so far
+    std::vector<ColumnFile::ChunkInfo> m_index;
+};
+
+/**
+ *  @brief Reads a ColumnFile.
+ */
+class ColumnFileReader
+{
+public:
+    // reads the header and the index; returns false if it fails
+    bool open(const QString& fpath, QString& error);
+
+    inline const QString& header() const { return m_header; }
+    inline bool isCompressed() const { return m_flags & ColumnFile::Compressed; }
+    inline int numChunks() const { return static_cast<int>(m_index.size()); }
+    inline const ColumnFile::ChunkInfo& chunkInfo(int i) const { return m_index.at(i); }
+    qint64 numRows() const;
+
+    // reads the steps and the cells ('numCols' per step) of a chunk
+    bool readChunk(int i, int& numCols, std::vector<int>& steps, Values& cells, QString& error);
+
+    // Writes the whole file as CSV: the step, then the columns of the header.
+    bool toCsv(const QString& csvPath, QString& error);
+
+private:
+    QFile m_file;
+    quint32 m_flags = 0;
+    QString m_header;
+    std::vector<ColumnFile::ChunkInfo> m_index;
+
+    bool readIndex(qint64 firstChunk, QString& error);
+    bool scanChunks(qint64 firstChunk, QString& error);
+};
+
+} // evoplex
+#endif // COLUMN_FILE_H
@@ -46,6 +46,7 @@
 #define OUTPUT_AVGTRIALS "avgTrials"        // 1 to indicate if the output should be done across all trials; 0 otherwise
 #define OUTPUT_HEADER "header"              // valid header
 #define OUTPUT_SAVESTEPS "saveSteps"        // n=0 to save all steps; n>0 to save the last n steps
+#define OUTPUT_FORMAT "format"              // file format: 'csv', 'bin' (binary columns) or 'binz' (compressed binary columns)
 
 /******************************************************************************
     Plugin stuff
@@ -0,0 +1,136 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSR_H
+#define CSR_H
+
+#include <vector>
+
+#include "edges.h"
+#include "node.h"
+#include "span.h"
+
+namespace evoplex {
+
+/**
+ *  @brief A read-only compressed sparse row (CSR) snapshot of a graph.
+ *
+ *  Nodes are mapped to dense row indices [0, numRows()) in the given
+ *  order, which for AbstractGraph is the order of the rows of its node
+ *  attribute columns. That is, a row index can also be used to access the
+ *  attributes of a node directly. The neighbours of each row are stored contiguously
+ *  as row indices, sorted in ascending order, and a parallel array holds
+ *  the corresponding edges (i.e., their ids and attributes), as seen from
+ *  the row.
+ *
+ *  For undirected graphs, in- and out-neighbours are the same.
+ */
+class CSR
+{
+public:
+    CSR() : m_isDirected(false), m_nodes(nullptr) {}
+
+    // Builds the CSR from scratch. The rows (i.e., nodes and edges) must
+    // outlive it and must not be changed while it is in use.
+    void build(const std::vector<NodePtr>& rows, bool isDirected);
+    void clear();
+
+    inline bool isEmpty() const;
+    inline int numRows() const;
+
+    // row index of a node; -1 if the node does not exist
+    inline int row(int nodeId) const;
+    inline const NodePtr& node(int row) const;
+
+    inline int outDegree(int row) const;
+    inline Span<int> outNeighbours(int row) const;
+    inline Span<EdgePtr> outEdges(int row) const;
+
+    inline int inDegree(int row) const;
+    inline Span<int> inNeighbours(int row) const;
+    inline Span<EdgePtr> inEdges(int row) const;
+
+private:
+    struct Rows {
+        std::vector<int> offsets;       // size: numRows + 1
+        std::vector<int> neighbours;    // row index of the neighbours
+        std::vector<EdgePtr> edges; // parallel to 'neighbours'
+    };
+
+    bool m_isDirected;
+    const std::vector<NodePtr>* m_nodes; // row -> node
+    std::vector<int> m_rowOf;     // node id -> row
+    Rows m_out;
+    Rows m_in; // empty for undirected graphs
+
+    void buildRows(Rows& rows, bool outward);
+
+    inline const Rows& inRows() const;
+};
+
+/************************************************************************
+   CSR: Inline member functions
+ ************************************************************************/
+
+inline bool CSR::isEmpty() const
+{ return !m_nodes || m_nodes->empty(); }
+
+inline int CSR::numRows() const
+{ return m_nodes ? static_cast<int>(m_nodes->size()) : 0; }
+
+inline int CSR::row(int nodeId) const
+{ return (nodeId >= 0 && nodeId < static_cast<int>(m_rowOf.size())) ? m_rowOf[nodeId] : -1; }
+
+inline const NodePtr& CSR::node(int row) const
+{ return (*m_nodes)[row]; }
+
+inline int CSR::outDegree(int row) const
+{ return m_out.offsets[row+1] - m_out.offsets[row]; }
+
+inline Span<int> CSR::outNeighbours(int row) const {
+    const int* d = m_out.neighbours.data();
+    return Span<int>(d + m_out.offsets[row], d + m_out.offsets[row+1]);
+}
+
+inline Span<EdgePtr> CSR::outEdges(int row) const {
+    const EdgePtr* d = m_out.edges.data();
+    return Span<EdgePtr>(d + m_out.offsets[row], d + m_out.offsets[row+1]);
+}
+
+inline int CSR::inDegree(int row) const
+{ return inRows().offsets[row+1] - inRows().offsets[row]; }
+
+inline Span<int> CSR::inNeighbours(int row) const {
+    const Rows& r = inRows();
+    return Span<int>(r.neighbours.data() + r.offsets[row],
+                     r.neighbours.data() + r.offsets[row+1]);
+}
+
+inline Span<EdgePtr> CSR::inEdges(int row) const {
+    const Rows& r = inRows();
+    return Span<EdgePtr>(r.edges.data() + r.offsets[row],
+                             r.edges.data() + r.offsets[row+1]);
+}
+
+inline const CSR::Rows& CSR::inRows() const
+{ return m_isDirected ? m_in : m_out; }
+
+} // evoplex
+#endif // CSR_H
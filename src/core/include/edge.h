@@ -21,71 +21,195 @@
 #ifndef EDGE_H
 #define EDGE_H
 
+#include <cstddef>
 #include <memory>
 #include <unordered_map>
 
+#include "attrhistograms.h"
 #include "attributes.h"
 
 namespace evoplex {
 
 class Edge;
+class EdgePtr;
 class Node;
 
 typedef std::shared_ptr<Node> NodePtr;
-typedef std::shared_ptr<Edge> EdgePtr;
 
+/**
+ *  @brief An edge of the graph.
+ *
+ *  Edges are allocated from the EdgePool of the graph and there is a single
+ *  Edge per connection, which is seen from either end through an EdgePtr.
+ *  The attributes are shared with the graph's default edge attributes until
+ *  the first call to setAttr(); graphs of models without edge attributes
+ *  do not allocate any. setAttr() also updates the graph's edge histograms.
+ */
 class Edge
 {
+    friend class AbstractGraph;
+    friend class EdgePool;
+    friend class EdgePtr;
+    friend class Node;
+
+public:
+    Edge() : m_id(-1), m_ownsAttrs(false), m_attrs(nullptr), m_hists(nullptr)
+    { m_slots[0] = m_slots[1] = -1; m_nodes[0] = m_nodes[1] = nullptr; }
+
+    inline int id() const;
+    inline const Attributes* attrs() const;
+
+private:
+    int m_id;
+    int m_slots[2]; // position in the list of edges of the origin/neighbour
+    bool m_ownsAttrs;
+    const NodePtr* m_nodes[2]; // origin, neighbour
+    Attributes* m_attrs;
+    AttrHistograms* m_hists; // the graph's edge histograms
+
+    inline void reset(int id, const NodePtr* origin, const NodePtr* neighbour,
+                      Attributes* attrs, bool ownsAttrs, AttrHistograms* hists);
+    inline void release();
+    inline Attributes* mutableAttrs();
+};
+
+/**
+ *  @brief A lightweight handle to an Edge, i.e., a pointer to it and the
+ *  direction from which it is seen.
+ *
+ *  The in-edge of a node is its neighbour's out-edge seen from the other
+ *  end, that is, origin() and neighbour() are swapped. EdgePtr has the
+ *  semantics of a pointer (e.g., edge->neighbour()), but it does not own the
+ *  Edge, which is valid until it is removed from the graph.
+ */
+class EdgePtr
+{
+    friend class Node;
+
 public:
-    explicit Edge(int id, const NodePtr& origin, const NodePtr& neighbour,
-        Attributes* attrs, bool takesOwnership)
-        : m_id(id), m_origin(origin), m_neighbour(neighbour), m_attrs(attrs),
-          m_takesOwnership(takesOwnership) {}
+    EdgePtr() : m_edge(nullptr), m_reversed(false) {}
+    EdgePtr(std::nullptr_t) : EdgePtr() {}
+    EdgePtr(Edge* edge, bool reversed) : m_edge(edge), m_reversed(reversed) {}
+
+    inline const EdgePtr* operator->() const;
+    inline explicit operator bool() const;
+    inline bool operator==(const EdgePtr& e) const;
+    inline bool operator!=(const EdgePtr& e) const;
 
-    ~Edge() { if (m_takesOwnership) delete m_attrs; }
+    inline Edge* get() const;
+    inline bool isReversed() const;
 
     inline const Attributes* attrs() const;
     inline const Value& attr(const char* name) const;
     inline const Value& attr(const int id) const;
-    inline void setAttr(const int id, const Value& value);
+    inline void setAttr(const int id, const Value& value) const;
 
     inline int id() const;
     inline const NodePtr& origin() const;
     inline const NodePtr& neighbour() const;
 
 private:
-    const int m_id;
-    const NodePtr& m_origin;
-    const NodePtr& m_neighbour;
-    Attributes* m_attrs;
-    bool m_takesOwnership;
+    Edge* m_edge;
+    bool m_reversed;
+
+    inline int& slot() const;
+    inline static const Attributes& emptyAttrs();
 };
 
 /************************************************************************
    Edge: Inline member functions
  ************************************************************************/
 
+inline int Edge::id() const
+{ return m_id; }
+
 inline const Attributes* Edge::attrs() const
 { return m_attrs; }
 
-inline const Value& Edge::attr(const char* name) const
-{ return m_attrs->value(name); }
+inline void Edge::reset(int id, const NodePtr* origin, const NodePtr* neighbour,
+                        Attributes* attrs, bool ownsAttrs, AttrHistograms* hists) {
+    m_id = id;
+    m_slots[0] = m_slots[1] = -1;
+    m_nodes[0] = origin;
+    m_nodes[1] = neighbour;
+    m_attrs = attrs;
+    m_ownsAttrs = ownsAttrs;
+    m_hists = hists;
+}
+
+inline void Edge::release() {
+    if (m_ownsAttrs) {
+        delete m_attrs;
+    }
+    m_attrs = nullptr;
+    m_ownsAttrs = false;
+    m_hists = nullptr;
+    m_nodes[0] = m_nodes[1] = nullptr;
+    m_id = -1;
+}
+
+inline Attributes* Edge::mutableAttrs() {
+    if (m_attrs && !m_ownsAttrs) {
+        m_attrs = new Attributes(*m_attrs);
+        m_ownsAttrs = true;
+    }
+    return m_attrs;
+}
 
-inline const Value& Edge::attr(const int id) const
-{ return m_attrs->value(id); }
+/************************************************************************
+   EdgePtr: Inline member functions
+ ************************************************************************/
 
-inline void Edge::setAttr(const int id, const Value& value)
-{ m_attrs->setValue(id, value); }
+inline const EdgePtr* EdgePtr::operator->() const
+{ return this; }
 
-inline int Edge::id() const
-{ return m_id; }
+inline EdgePtr::operator bool() const
+{ return m_edge != nullptr; }
+
+inline bool EdgePtr::operator==(const EdgePtr& e) const
+{ return m_edge == e.m_edge && m_reversed == e.m_reversed; }
+
+inline bool EdgePtr::operator!=(const EdgePtr& e) const
+{ return !(*this == e); }
+
+inline Edge* EdgePtr::get() const
+{ return m_edge; }
+
+inline bool EdgePtr::isReversed() const
+{ return m_reversed; }
+
+inline const Attributes* EdgePtr::attrs() const
+{ return m_edge->m_attrs; }
+
+inline const Value& EdgePtr::attr(const char* name) const
+{ return (m_edge->m_attrs ? *m_edge->m_attrs : emptyAttrs()).value(name); }
+
+inline const Value& EdgePtr::attr(const int id) const
+{ return (m_edge->m_attrs ? *m_edge->m_attrs : emptyAttrs()).value(id); }
+
+inline void EdgePtr::setAttr(const int id, const Value& value) const {
+    Attributes* attrs = m_edge->mutableAttrs();
+    if (!attrs) throw std::out_of_range("the edge has no attributes");
+    if (m_edge->m_hists && m_edge->m_hists->isTracked(id)) {
+        m_edge->m_hists->replace(id, attrs->value(id), value);
+    }
+    attrs->setValue(id, value);
+}
+
+inline int EdgePtr::id() const
+{ return m_edge->m_id; }
+
+inline const NodePtr& EdgePtr::origin() const
+{ return *m_edge->m_nodes[m_reversed ? 1 : 0]; }
 
-inline const NodePtr& Edge::origin() const
-{ return m_origin; }
+inline const NodePtr& EdgePtr::neighbour() const
+{ return *m_edge->m_nodes[m_reversed ? 0 : 1]; }
 
-inline const NodePtr& Edge::neighbour() const
-{ return m_neighbour; }
+inline int& EdgePtr::slot() const
+{ return m_edge->m_slots[m_reversed ? 1 : 0]; }
 
+inline const Attributes& EdgePtr::emptyAttrs()
+{ static const Attributes empty; return empty; }
 
 } // evoplex
 #endif // EDGE_H
@@ -0,0 +1,90 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EDGELIST_H
+#define EDGELIST_H
+
+#include <QString>
+#include <vector>
+
+#include "attributecolumns.h"
+
+namespace evoplex {
+
+/**
+ *  @brief A list of edges, i.e., pairs of node ids, as read from a csv file.
+ *
+ *  The file must have a header whose first columns are 'origin' and
+ *  'target'; the other columns are ignored. The file is memory-mapped and
+ *  split into chunks of lines, which are parsed in parallel.
+ *
+ *  The edges can also be read from a graph snapshot (*.evg), in which
+ *  case they may come with attributes too, i.e., one row per edge.
+ */
+class EdgeList
+{
+public:
+    // Reads the edges from a csv file or from a graph snapshot (*.evg).
+    // The node ids must be in [0, numNodes); in snapshots, the ids of the
+    // nodes are their rows. If it fails, it returns an empty list and sets
+    // the error message.
+    static EdgeList fromFile(const QString& filePath, int numNodes,
+                             QString* errMsg = nullptr);
+
+    inline bool isEmpty() const;
+    inline int size() const;
+    inline int origin(int i) const;
+    inline int target(int i) const;
+
+    // the attributes of the edges (one row per edge), if any
+    inline const AttributeColumns& attrs() const;
+
+    void add(int origin, int target);
+    void clear();
+
+private:
+    std::vector<int> m_origins;
+    std::vector<int> m_targets;
+    AttributeColumns m_attrs;
+
+    static EdgeList fromSnapshot(const QString& filePath, int numNodes, QString* errMsg);
+};
+
+/************************************************************************
+   EdgeList: Inline member functions
+ ************************************************************************/
+
+inline bool EdgeList::isEmpty() const
+{ return m_origins.empty(); }
+
+inline int EdgeList::size() const
+{ return static_cast<int>(m_origins.size()); }
+
+inline int EdgeList::origin(int i) const
+{ return m_origins[i]; }
+
+inline int EdgeList::target(int i) const
+{ return m_targets[i]; }
+
+inline const AttributeColumns& EdgeList::attrs() const
+{ return m_attrs; }
+
+} // evoplex
+#endif // EDGELIST_H
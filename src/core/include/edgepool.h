@@ -0,0 +1,79 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EDGEPOOL_H
+#define EDGEPOOL_H
+
+#include <vector>
+
+#include "arena.h"
+#include "edge.h"
+
+namespace evoplex {
+
+/**
+ *  @brief Owns the edges of a graph.
+ *
+ *  Edges are allocated in chunks from an Arena, so adding an edge does
+ *  not hit the heap most of the time, and the pointers to them remain valid
+ *  until they are destroyed. Destroyed edges are recycled by the next
+ *  create(), and clear() keeps the chunks for the next edges.
+ *
+ *  If histograms are given, the values of the tracked attributes are
+ *  counted when edges are created and discounted when they are destroyed.
+ */
+class EdgePool
+{
+public:
+    explicit EdgePool(Arena* arena, AttrHistograms* hists = nullptr)
+        : m_arena(arena), m_hists(hists), m_next(0), m_size(0) {}
+    ~EdgePool() { clear(); }
+
+    EdgePool(const EdgePool&) = delete;
+    EdgePool& operator=(const EdgePool&) = delete;
+
+    // takes the ownership of attrs if ownsAttrs is true
+    Edge* create(int id, const NodePtr* origin, const NodePtr* neighbour,
+                 Attributes* attrs, bool ownsAttrs);
+    void destroy(Edge* edge);
+    void clear();
+
+    inline int size() const;
+
+private:
+    static const size_t kChunkSize = 4096;
+
+    Arena* m_arena;
+    AttrHistograms* m_hists;
+    std::vector<Edge*> m_chunks;
+    size_t m_next; // edges handed out from the chunks since the last clear()
+    int m_size;
+    std::vector<Edge*> m_free;
+};
+
+/************************************************************************
+   EdgePool: Inline member functions
+ ************************************************************************/
+
+inline int EdgePool::size() const
+{ return m_size; }
+
+} // evoplex
+#endif // EDGEPOOL_H
@@ -21,16 +21,25 @@
 #ifndef EDGES_H
 #define EDGES_H
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
 
+#include "arena.h"
 #include "edge.h"
 
 namespace evoplex {
 
-struct Edges : public std::unordered_map<int, EdgePtr>
+typedef std::unordered_map<int, EdgePtr, std::hash<int>, std::equal_to<int>,
+                           ArenaAllocator<std::pair<const int, EdgePtr>>> EdgesMap;
+
+// the elements are taken from the Arena given at construction, if any
+struct Edges : public EdgesMap
 {
 public:
+    Edges() {}
+    explicit Edges(const ArenaPtr& arena) : EdgesMap(allocator_type(arena)) {}
+
     struct Iterator : public iterator {
         Iterator() {}
         Iterator(const iterator& _a) : iterator(_a) {}
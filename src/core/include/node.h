@@ -21,8 +21,12 @@
 #ifndef NODE_H
 #define NODE_H
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
+#include "arena.h"
+#include "attributecolumns.h"
 #include "attributes.h"
 #include "edges.h"
 #include "prg.h"
@@ -36,7 +40,8 @@ class NodeInterface
 {
     friend class AbstractGraph;
 public:
-    virtual NodePtr clone() const = 0;
+    // the copy takes its memory from the arena, if any
+    virtual NodePtr clone(const ArenaPtr& arena = ArenaPtr()) const = 0;
     virtual const Edges& inEdges() const = 0;
     virtual const Edges& outEdges() const = 0;
     virtual int degree() const = 0;
@@ -50,16 +55,27 @@ private:
     virtual void removeOutEdge(const int edgeId) = 0;
     virtual void clearInEdges() = 0;
     virtual void clearOutEdges() = 0;
+    // makes room for more edges, e.g., before adding them in bulk
+    virtual void reserveEdges(int numIn, int numOut) = 0;
 };
 
 class Node : public NodeInterface
 {
+    friend class AbstractGraph;
+
 public:
-    inline const Attributes& attrs() const;
-    inline const Value& attr(const char* name) const;
-    inline const Value& attr(const int id) const;
+    // Note that the attributes of a node which belongs to a graph live
+    // in the graph's column store, so these methods return copies.
+    inline Attributes attrs() const;
+    inline Value attr(const char* name) const;
+    inline Value attr(const int id) const;
     inline void setAttr(const int id, const Value& value);
 
+    // typed access to a column of the graph's column store;
+    // the node must belong to a graph
+    template <typename T> inline T attr(AttrHandle<T> h) const;
+    template <typename T> inline void setAttr(AttrHandle<T> h, T value);
+
     inline int id() const;
 
     inline int x() const;
@@ -68,13 +84,23 @@ public:
     inline void setY(int y);
     inline void setCoords(int x, int y);
 
+    // uniformly random out-neighbour in O(1); the node must have one,
+    // otherwise it throws std::out_of_range
     inline const NodePtr& randNeighbour(PRG* prg) const;
 
 protected:
     Edges m_outEdges;
+    std::vector<EdgePtr> m_outList; // same edges as m_outEdges, indexable
 
-    explicit Node(int id, Attributes attrs, int x, int y)
-        : m_id(id), m_attrs(attrs), m_x(x), m_y(y) {}
+    // keep m_outEdges and m_outList in sync;
+    // removing an edge moves the last one into its slot
+    inline void insertOutEdge(const EdgePtr& outEdge);
+    inline void eraseOutEdge(const int edgeId);
+    inline void clearOutList();
+    inline void reserveOutEdges(int n);
+
+    explicit Node(int id, Attributes attrs, int x, int y, const ArenaPtr& arena = ArenaPtr())
+        : m_outEdges(arena), m_id(id), m_attrs(attrs), m_columns(nullptr), m_row(-1), m_x(x), m_y(y) {}
 
     explicit Node(int id, Attributes attr)
         : Node(id, attr, 0, id) {}
@@ -83,19 +109,29 @@ protected:
 
 private:
     const int m_id;
-    Attributes m_attrs;
+    Attributes m_attrs; // empty when bound to a column store
+    AttributeColumns* m_columns;
+    int m_row;
     int m_x;
     int m_y;
+
+    // moves the attributes into a row of the column store
+    inline void bind(AttributeColumns* columns);
+    // uses an existing row of the column store, dropping the own attributes
+    inline void bind(AttributeColumns* columns, int row);
+    // copies the attributes back from the column store
+    inline void unbind();
 };
 
 class UNode : public Node
 {
 public:
-    explicit UNode(int id, Attributes attrs, int x, int y) : Node(id, attrs, x, y) {}
+    explicit UNode(int id, Attributes attrs, int x, int y, const ArenaPtr& arena = ArenaPtr())
+        : Node(id, attrs, x, y, arena) {}
     explicit UNode(int id, Attributes attrs) : Node(id, attrs) {}
     virtual ~UNode() {}
 
-    inline NodePtr clone() const override;
+    inline NodePtr clone(const ArenaPtr& arena = ArenaPtr()) const override;
     inline const Edges& inEdges() const override;
     inline const Edges& outEdges() const override;
     inline int degree() const override;
@@ -109,16 +145,18 @@ private:
     inline void removeOutEdge(const int edgeId) override;
     inline void clearInEdges() override;
     inline void clearOutEdges() override;
+    inline void reserveEdges(int numIn, int numOut) override;
 };
 
 class DNode : public Node
 {
 public:
-    explicit DNode(int id, Attributes attrs, int x, int y) : Node(id, attrs, x, y) {}
+    explicit DNode(int id, Attributes attrs, int x, int y, const ArenaPtr& arena = ArenaPtr())
+        : Node(id, attrs, x, y, arena), m_inEdges(arena) {}
     explicit DNode(int id, Attributes attrs) : Node(id, attrs) {}
     virtual ~DNode() {}
 
-    inline NodePtr clone() const override;
+    inline NodePtr clone(const ArenaPtr& arena = ArenaPtr()) const override;
     inline const Edges& inEdges() const override;
     inline const Edges& outEdges() const override;
     inline int degree() const override;
@@ -134,23 +172,46 @@ private:
     inline void removeOutEdge(const int edgeId) override;
     inline void clearInEdges() override;
     inline void clearOutEdges() override;
+    inline void reserveEdges(int numIn, int numOut) override;
 };
 
+// Creates a node of type T (i.e., UNode or DNode). If an arena is given,
+// the node, its reference count and its edges are allocated from it.
+template <class T>
+inline NodePtr makeNode(const ArenaPtr& arena, int id, Attributes attrs, int x, int y) {
+    if (arena) {
+        return std::allocate_shared<T>(ArenaAllocator<T>(arena), id, attrs, x, y, arena);
+    }
+    return std::make_shared<T>(id, attrs, x, y);
+}
+
 /************************************************************************
    Node: Inline member functions
  ************************************************************************/
 
-inline const Attributes& Node::attrs() const
-{ return m_attrs; }
+inline Attributes Node::attrs() const
+{ return m_columns ? m_columns->row(m_row) : m_attrs; }
 
-inline const Value& Node::attr(const char* name) const
-{ return m_attrs.value(name); }
+inline Value Node::attr(const char* name) const
+{ return m_columns ? m_columns->value(m_row, m_columns->indexOf(name)) : m_attrs.value(name); }
 
-inline const Value& Node::attr(const int id) const
-{ return m_attrs.value(id); }
+inline Value Node::attr(const int id) const
+{ return m_columns ? m_columns->value(m_row, id) : m_attrs.value(id); }
 
 inline void Node::setAttr(const int id, const Value& value)
-{ m_attrs.setValue(id, value); }
+{ if (m_columns) m_columns->setValue(m_row, id, value); else m_attrs.setValue(id, value); }
+
+template <typename T>
+inline T Node::attr(AttrHandle<T> h) const {
+    Q_ASSERT_X(m_columns, "Node::attr", "the node is not bound to a column store");
+    return m_columns->value(m_row, h);
+}
+
+template <typename T>
+inline void Node::setAttr(AttrHandle<T> h, T value) {
+    Q_ASSERT_X(m_columns, "Node::setAttr", "the node is not bound to a column store");
+    m_columns->setValue(m_row, h, value);
+}
 
 inline int Node::id() const
 { return m_id; }
@@ -170,15 +231,67 @@ inline void Node::setY(int y)
 inline void Node::setCoords(int x, int y)
 { setX(x); setY(y); }
 
-inline const NodePtr& Node::randNeighbour(PRG* prg) const
-{ return (*std::next(m_outEdges.cbegin(), prg->randI(m_outEdges.size()-1))).second->neighbour(); }
+inline const NodePtr& Node::randNeighbour(PRG* prg) const {
+    Q_ASSERT_X(!m_outList.empty(), "Node::randNeighbour", "the node has no neighbours");
+    return m_outList.at(prg->bounded(static_cast<std::uint32_t>(m_outList.size())))->neighbour();
+}
+
+inline void Node::insertOutEdge(const EdgePtr& outEdge) {
+    if (m_outEdges.insert({outEdge->id(), outEdge}).second) {
+        outEdge.slot() = static_cast<int>(m_outList.size());
+        m_outList.emplace_back(outEdge);
+    }
+}
+
+inline void Node::eraseOutEdge(const int edgeId) {
+    auto it = m_outEdges.find(edgeId);
+    if (it == m_outEdges.end()) {
+        return;
+    }
+    const int slot = it->second.slot();
+    m_outList[slot] = m_outList.back();
+    m_outList[slot].slot() = slot;
+    m_outList.pop_back();
+    m_outEdges.erase(it);
+}
+
+inline void Node::clearOutList()
+{ m_outEdges.clear(); m_outList.clear(); }
+
+inline void Node::reserveOutEdges(int n) {
+    m_outEdges.reserve(m_outEdges.size() + n);
+    m_outList.reserve(m_outList.size() + n);
+}
+
+inline void Node::bind(AttributeColumns* columns) {
+    Q_ASSERT_X(!m_columns, "Node::bind", "the node is already bound to a column store");
+    m_row = columns->appendRow(m_attrs);
+    m_columns = columns;
+    m_attrs = Attributes();
+}
+
+inline void Node::bind(AttributeColumns* columns, int row) {
+    Q_ASSERT_X(!m_columns, "Node::bind", "the node is already bound to a column store");
+    Q_ASSERT_X(row >= 0 && row < columns->numRows(), "Node::bind", "row out of range");
+    m_row = row;
+    m_columns = columns;
+    m_attrs = Attributes();
+}
+
+inline void Node::unbind() {
+    if (m_columns) {
+        m_attrs = m_columns->row(m_row);
+        m_columns = nullptr;
+        m_row = -1;
+    }
+}
 
 /************************************************************************
    UNode: Inline member functions
  ************************************************************************/
 
-inline NodePtr UNode::clone() const
-{ return std::make_shared<UNode>(id(), attrs(), x(), y()); }
+inline NodePtr UNode::clone(const ArenaPtr& arena) const
+{ return makeNode<UNode>(arena, id(), attrs(), x(), y()); }
 
 inline const Edges& UNode::inEdges() const
 { return m_outEdges; }
@@ -195,30 +308,33 @@ inline int UNode::inDegree() const
 inline int UNode::outDegree() const
 { return degree(); }
 
+inline void UNode::reserveEdges(int numIn, int numOut)
+{ reserveOutEdges(numIn + numOut); }
+
 inline void UNode::addInEdge(const EdgePtr& inEdge)
 { addOutEdge(inEdge); }
 
 inline void UNode::addOutEdge(const EdgePtr& outEdge)
-{ m_outEdges.insert({outEdge->id(), outEdge}); }
+{ insertOutEdge(outEdge); }
 
 inline void UNode::removeInEdge(const int edgeId)
 { removeOutEdge(edgeId); }
 
 inline void UNode::removeOutEdge(const int edgeId)
-{ m_outEdges.erase(edgeId); }
+{ eraseOutEdge(edgeId); }
 
 inline void UNode::clearInEdges()
 { clearOutEdges(); }
 
 inline void UNode::clearOutEdges()
-{ m_outEdges.clear(); }
+{ clearOutList(); }
 
 /************************************************************************
    DNode: Inline member functions
  ************************************************************************/
 
-inline NodePtr DNode::clone() const
-{ return std::make_shared<DNode>(id(), attrs(), x(), y()); }
+inline NodePtr DNode::clone(const ArenaPtr& arena) const
+{ return makeNode<DNode>(arena, id(), attrs(), x(), y()); }
 
 inline const Edges& DNode::inEdges() const
 { return m_inEdges; }
@@ -235,23 +351,28 @@ inline int DNode::inDegree() const
 inline int DNode::outDegree() const
 { return static_cast<int>(m_outEdges.size()); }
 
+inline void DNode::reserveEdges(int numIn, int numOut) {
+    m_inEdges.reserve(m_inEdges.size() + numIn);
+    reserveOutEdges(numOut);
+}
+
 inline void DNode::addInEdge(const EdgePtr& inEdge)
 { m_inEdges.insert({inEdge->id(), inEdge}); }
 
 inline void DNode::addOutEdge(const EdgePtr& outEdge)
-{ m_outEdges.insert({outEdge->id(), outEdge}); }
+{ insertOutEdge(outEdge); }
 
 inline void DNode::removeInEdge(const int edgeId)
 { m_inEdges.erase(edgeId); }
 
 inline void DNode::removeOutEdge(const int edgeId)
-{ m_outEdges.erase(edgeId); }
+{ eraseOutEdge(edgeId); }
 
 inline void DNode::clearInEdges()
 { m_inEdges.clear(); }
 
 inline void DNode::clearOutEdges()
-{ m_outEdges.clear(); }
+{ clearOutList(); }
 
 } // evoplex
 #endif // NODE_H
@@ -25,6 +25,7 @@
 #include <memory>
 #include <unordered_map>
 
+#include "attributecolumns.h"
 #include "attributerange.h"
 #include "node.h"
 
@@ -58,12 +59,28 @@ public:
             const int graphType, QString* errMsg = nullptr,
             std::function<void(int)> progress = [](int){});
 
-    // Read a set of nodes from a csv file
+    // Read a set of nodes from a csv file or from a graph snapshot (*.evg).
+    // The rows of a csv file are parsed in parallel, straight from the
+    // mapped file. 'progress' gets the per mille of the work done, i.e., of
+    // the bytes parsed (csv) or of the nodes read (*.evg), and ends at 1000.
     static Nodes fromFile(const QString& filePath, const AttributesScope& attrsScope,
             const int graphType, QString* errMsg = nullptr,
             std::function<void(int)> progress = [](int){});
 
-    // Export set of nodes to a csv file
+    // Reads the nodes of a graph snapshot (*.evg) without copying their
+    // attributes: the nodes have no attributes and, instead, 'attrs' gets
+    // one row per node (in ascending order of ids) whose columns are read
+    // in place from the snapshot. The columns follow the ids of 'attrsScope'.
+    // As for csv files, the ids of the nodes are their rows, i.e., the ids
+    // saved in the snapshot (which may have gaps) are renumbered.
+    static Nodes fromSnapshot(const QString& filePath, const AttributesScope& attrsScope,
+            const int graphType, AttributeColumns& attrs, QString* errMsg = nullptr);
+
+    // Export set of nodes to a csv file, or to a graph snapshot if the
+    // file path ends with '.evg'. The csv rows are in ascending order of
+    // ids; they are formatted in parallel and written in chunks, which are
+    // gzip-compressed if the file path ends with '.gz'. For csv files,
+    // 'progress' gets the number of rows written.
     bool saveToFile(QString filepath, std::function<void(int)> progress = [](int){}) const;
 
 private:
@@ -72,10 +89,6 @@ private:
     // and has all the required attributes (attrsScope)
     static QStringList validateHeader(const QString& header,
             const AttributesScope& attrsScope, QString* errMsg = nullptr);
-
-    static NodePtr readRow(const int row, const QStringList& header,
-            const QStringList& values, const AttributesScope& attrsScope,
-            const bool isDirected, QString* errMsg = nullptr);
 };
 
 } // evoplex
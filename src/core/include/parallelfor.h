@@ -0,0 +1,64 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <functional>
+
+class QThreadPool;
+
+namespace evoplex {
+
+/**
+ *  @brief Runs a loop over a range of rows in parallel.
+ *
+ *  The range [0, size) is split into blocks of a fixed number of rows,
+ *  which are handed out to the threads one at a time through a shared
+ *  counter, i.e., a thread which finishes a block just takes the next one.
+ *  The calling thread always takes part in the loop and it is helped by
+ *  the idle threads of the thread pool (if any). Thus, when the pool is
+ *  busy (e.g., running other trials), the loop runs sequentially.
+ *
+ *  The block boundaries do not depend on the number of threads, so a loop
+ *  body which uses one PRG stream per block is deterministic.
+ */
+class ParallelFor
+{
+public:
+    // number of rows per block; small enough to keep a few
+    // attribute columns of a block in the L2 cache
+    static const int kBlockSize = 4096;
+
+    // Sets the thread pool shared by all loops.
+    // By default, it uses QThreadPool::globalInstance().
+    static void setThreadPool(QThreadPool* pool);
+
+    // Calls fn(begin, end) for each block of rows in [0, size) and returns
+    // when all of them are done. The block index is begin / blockSize.
+    static void run(int size, const std::function<void(int, int)>& fn,
+                    int blockSize = kBlockSize);
+
+private:
+    static QThreadPool* s_threadPool;
+};
+
+} // evoplex
+#endif // PARALLEL_FOR_H
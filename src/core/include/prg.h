@@ -2,7 +2,7 @@
  *  This file is part of Evoplex.
  *
  *  Evoplex is a multi-agent system for networks.
- *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -21,66 +21,274 @@
 #ifndef PRG_H
 #define PRG_H
 
+#include <array>
+#include <cstdint>
 #include <random>
 
 namespace evoplex
 {
+
+/**
+ *  @brief Philox4x32-10 counter-based random number generator.
+ *  It maps a 128-bit counter and a 64-bit key to 128 random bits.
+ *  Salmon et al. (2011) Parallel random numbers: as easy as 1, 2, 3.
+ */
+struct Philox4x32
+{
+    typedef std::array<std::uint32_t, 4> Counter;
+    typedef std::array<std::uint32_t, 2> Key;
+
+    static inline Counter generate(Counter ctr, Key key);
+
+private:
+    static inline void round(Counter& ctr, const Key& key);
+};
+
+/**
+ *  @brief A pseudo-random generator.
+ *  Each PRG is a stream of the Philox4x32-10 generator identified by its
+ *  key, so its state takes just a few bytes. Streams can be split into
+ *  independent and reproducible sub-streams, e.g., one per trial, thread
+ *  or block of nodes. It also satisfies the UniformRandomBitGenerator
+ *  requirements, so it can be used with the std distributions.
+ */
 class PRG
 {
 public:
+    typedef std::uint32_t result_type;
+
     explicit PRG(unsigned int seed);
 
+    // Returns an independent stream identified by streamId.
+    // It depends only on this stream's key and streamId, that is,
+    // the numbers drawn from this stream do not affect it.
+    PRG split(std::uint64_t streamId) const;
+
+    // Advances the stream as if n 32-bit numbers had been drawn.
+    void jump(std::uint64_t n);
+
+    // Generate a random 32-bit unsigned integer
+    inline result_type operator()();
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFF; }
+
     // Generate a random double [0, 1)
     inline double randD();
     // Generate a random double [0, max)
     inline double randD(double max);
     // Generate a random double [min, max)
-    double randD(double min, double max);
+    inline double randD(double min, double max);
 
     // Generate a random float [0, 1)
     inline float randF();
     // Generate a random float [0, max)
     inline float randF(float max);
     // Generate a random float [min, max)
-    float randF(float min, float max);
+    inline float randF(float min, float max);
 
     // Generate a random integer [0, max]
     inline int randI(int max);
     // Generate a random integer [min, max]
-    int randI(int min, int max);
+    inline int randI(int min, int max);
 
     // Generate a random integer [0, max]
     inline size_t randI(size_t max);
     // Generate a random integer [min, max]
     size_t randS(size_t min, size_t max);
 
+    // Generate a random integer [0, range) using Lemire's nearly
+    // divisionless method; range must be greater than zero.
+    // Lemire (2019) Fast random integer generation in an interval.
+    inline std::uint32_t bounded(std::uint32_t range);
+
+    // Fill the array with n random 32-bit unsigned integers
+    void fill(std::uint32_t* out, size_t n);
+    // Fill the array with n random doubles [0, 1);
+    // same as calling randD() n times
+    void fillD(double* out, size_t n);
+    // Fill the array with n random integers [min, max]
+    void fillI(int* out, size_t n, int min, int max);
+
+private:
+    Philox4x32::Key m_key;
+    std::uint64_t m_counter;   // counter of the next block
+    Philox4x32::Counter m_buf; // current block
+    int m_idx;                 // next number in m_buf; 4 if it is empty
+
+    inline Philox4x32::Counter block(std::uint64_t counter) const;
+    inline void refill();
+};
+
+/**
+ *  @brief A uniform distribution of integers in a fixed range [min, max].
+ *  It precomputes the rejection threshold of Lemire's method, so drawing
+ *  a number takes one multiplication and no division.
+ */
+class IntSampler
+{
+public:
+    explicit IntSampler(int min, int max);
+
+    inline int min() const;
+    inline int max() const;
+
+    inline int operator()(PRG& prg) const;
+
+    // Fill the array with n random integers [min, max]
+    void fill(PRG& prg, int* out, size_t n) const;
+
+private:
+    int m_min;
+    int m_max;
+    std::uint32_t m_range;     // 0 means the full 32-bit range
+    std::uint32_t m_threshold; // (2^32 - range) % range
+
+    inline bool map(std::uint32_t x, int& out) const;
+};
+
+/**
+ *  @brief A uniform distribution of doubles in a fixed range [min, max).
+ */
+class RealSampler
+{
+public:
+    explicit RealSampler(double min, double max)
+        : m_min(min), m_scale(max - min) {}
+
+    inline double operator()(PRG& prg) const;
+
+    // Fill the array with n random doubles [min, max)
+    void fill(PRG& prg, double* out, size_t n) const;
+
 private:
-    std::mt19937 m_mteng; //  Mersenne Twister engine
-    std::uniform_real_distribution<double> m_doubleZeroOne;
-    std::uniform_real_distribution<float> m_floatZeroOne;
+    double m_min;
+    double m_scale;
 };
 
+/************************************************************************
+   Philox4x32: Inline member functions
+ ************************************************************************/
+
+inline Philox4x32::Counter Philox4x32::generate(Counter ctr, Key key)
+{
+    round(ctr, key);
+    for (int r = 1; r < 10; ++r) {
+        key[0] += 0x9E3779B9; // golden ratio
+        key[1] += 0xBB67AE85; // sqrt(3) - 1
+        round(ctr, key);
+    }
+    return ctr;
+}
+
+inline void Philox4x32::round(Counter& ctr, const Key& key)
+{
+    const std::uint64_t p0 = std::uint64_t(0xD2511F53) * ctr[0];
+    const std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * ctr[2];
+    ctr = {{ static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+             static_cast<std::uint32_t>(p1),
+             static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+             static_cast<std::uint32_t>(p0) }};
+}
+
 /************************************************************************
    PRG: Inline member functions
  ************************************************************************/
 
+inline PRG::result_type PRG::operator()()
+{
+    if (m_idx == 4) refill();
+    return m_buf[m_idx++];
+}
+
 inline double PRG::randD()
-{ return m_doubleZeroOne(m_mteng); }
+{
+    const std::uint64_t hi = (*this)();
+    const std::uint64_t lo = (*this)();
+    return (((hi << 32) | lo) >> 11) * (1.0 / 9007199254740992.0); // 53 bits / 2^53
+}
 
 inline double PRG::randD(double max)
 { return randD(0.0, max); }
 
+inline double PRG::randD(double min, double max)
+{ return min + randD() * (max - min); }
+
 inline float PRG::randF()
-{ return m_floatZeroOne(m_mteng); }
+{ return ((*this)() >> 8) * (1.f / 16777216.f); } // 24 bits / 2^24
 
 inline float PRG::randF(float max)
 { return randF(0.f, max); }
 
+inline float PRG::randF(float min, float max)
+{ return min + randF() * (max - min); }
+
 inline int PRG::randI(int max)
 { return randI(0, max); }
 
+inline int PRG::randI(int min, int max) {
+    const std::uint32_t range = static_cast<std::uint32_t>(max) - static_cast<std::uint32_t>(min) + 1;
+    const std::uint32_t x = range ? bounded(range) : (*this)();
+    return static_cast<int>(static_cast<std::uint32_t>(min) + x);
+}
+
+inline std::uint32_t PRG::bounded(std::uint32_t range) {
+    std::uint64_t m = std::uint64_t((*this)()) * range;
+    std::uint32_t low = static_cast<std::uint32_t>(m);
+    if (low < range) {
+        // slow path: only taken with probability range / 2^32
+        const std::uint32_t threshold = (0u - range) % range;
+        while (low < threshold) {
+            m = std::uint64_t((*this)()) * range;
+            low = static_cast<std::uint32_t>(m);
+        }
+    }
+    return static_cast<std::uint32_t>(m >> 32);
+}
+
 inline size_t PRG::randI(size_t max)
 { return randS(0, max); }
 
+inline Philox4x32::Counter PRG::block(std::uint64_t counter) const
+{
+    return Philox4x32::generate({{ static_cast<std::uint32_t>(counter),
+                                   static_cast<std::uint32_t>(counter >> 32), 0, 0 }}, m_key);
+}
+
+inline void PRG::refill()
+{ m_buf = block(m_counter++); m_idx = 0; }
+
+/************************************************************************
+   IntSampler: Inline member functions
+ ************************************************************************/
+
+inline int IntSampler::min() const
+{ return m_min; }
+
+inline int IntSampler::max() const
+{ return m_max; }
+
+inline bool IntSampler::map(std::uint32_t x, int& out) const {
+    if (!m_range) {
+        out = static_cast<int>(x);
+        return true;
+    }
+    const std::uint64_t m = std::uint64_t(x) * m_range;
+    out = static_cast<int>(static_cast<std::uint32_t>(m_min) + static_cast<std::uint32_t>(m >> 32));
+    return static_cast<std::uint32_t>(m) >= m_threshold;
+}
+
+inline int IntSampler::operator()(PRG& prg) const {
+    int out;
+    while (!map(prg(), out)) {}
+    return out;
+}
+
+/************************************************************************
+   RealSampler: Inline member functions
+ ************************************************************************/
+
+inline double RealSampler::operator()(PRG& prg) const
+{ return m_min + prg.randD() * m_scale; }
+
 } // evoplex
 #endif // PRG_H
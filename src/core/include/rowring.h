@@ -0,0 +1,166 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROW_RING_H
+#define ROW_RING_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+
+#include "value.h"
+
+namespace evoplex {
+
+/**
+ *  @brief A single-producer/single-consumer queue of rows of Values.
+ *
+ *  Rows are stored column-major in fixed-size segments, that is, each
+ *  segment holds one contiguous array per column plus the step of each
+ *  row. When a segment is full, the producer links a new one; when the
+ *  consumer is done with a segment, it hands it back to the producer to be
+ *  reused. Thus, once the queue has reached its working size, pushing and
+ *  popping rows do not allocate. Value is trivially copyable, so copying a
+ *  row into a segment does not allocate either.
+ *
+ *  One thread may call push() while another calls isEmpty(), front() and
+ *  pop(), without locks. clear() must not race with any of them.
+ */
+class RowRing
+{
+public:
+    // A view of a row; it is valid until the row is popped.
+    class Row
+    {
+    public:
+        Row(int step, const Value* values, int stride, int size)
+            : m_step(step), m_values(values), m_stride(stride), m_size(size) {}
+
+        inline int step() const { return m_step; }
+        inline int size() const { return m_size; }
+        inline const Value& at(int col) const { return m_values[col * m_stride]; }
+
+    private:
+        int m_step;
+        const Value* m_values;
+        int m_stride;
+        int m_size;
+    };
+
+    static const int kSegmentSize = 1024;
+
+    explicit RowRing(int numCols, int segmentSize = kSegmentSize);
+    ~RowRing();
+
+    RowRing(const RowRing&) = delete;
+    RowRing& operator=(const RowRing&) = delete;
+
+    inline int numCols() const;
+
+    // producer: appends a row whose values are given by valueOf(col)
+    template <typename F> inline void push(int step, F valueOf);
+
+    // consumer
+    inline bool isEmpty() const;
+    inline Row front() const;
+    inline void pop();
+
+    // drops all rows; neither the producer nor the consumer may be active
+    void clear();
+
+private:
+    struct Segment {
+        explicit Segment(int numCols, int size)
+            : written(0), read(0), next(nullptr), steps(size), values(numCols * size) {}
+        std::atomic<int> written;       // rows published by the producer
+        int read;                       // rows consumed by the consumer
+        std::atomic<Segment*> next;
+        std::vector<int> steps;
+        std::vector<Value> values;      // column-major
+    };
+
+    const int m_numCols;
+    const int m_segmentSize;
+    Segment* m_tail;                    // producer only
+    mutable Segment* m_head;            // consumer only
+    mutable std::atomic<Segment*> m_spare; // consumed segment, ready to be reused
+
+    Segment* newSegment();
+    void recycle(Segment* seg) const;
+};
+
+/************************************************************************
+   RowRing: Inline member functions
+ ************************************************************************/
+
+inline int RowRing::numCols() const
+{ return m_numCols; }
+
+template <typename F>
+inline void RowRing::push(int step, F valueOf)
+{
+    Segment* seg = m_tail;
+    int w = seg->written.load(std::memory_order_relaxed);
+    if (w == m_segmentSize) {
+        Segment* next = newSegment();
+        seg->next.store(next, std::memory_order_release);
+        m_tail = seg = next;
+        w = 0;
+    }
+    seg->steps[w] = step;
+    for (int col = 0; col < m_numCols; ++col) {
+        seg->values[col * m_segmentSize + w] = valueOf(col);
+    }
+    seg->written.store(w + 1, std::memory_order_release);
+}
+
+inline bool RowRing::isEmpty() const
+{
+    Segment* seg = m_head;
+    if (seg->read < seg->written.load(std::memory_order_acquire)) {
+        return false;
+    } else if (seg->read < m_segmentSize) {
+        return true;
+    }
+    // the segment is done; move on if the producer has linked another one
+    Segment* next = seg->next.load(std::memory_order_acquire);
+    if (!next) {
+        return true;
+    }
+    m_head = next;
+    recycle(seg);
+    return next->read >= next->written.load(std::memory_order_acquire);
+}
+
+inline RowRing::Row RowRing::front() const
+{
+    Q_ASSERT_X(!isEmpty(), "RowRing::front", "the ring is empty");
+    const Segment* seg = m_head;
+    return Row(seg->steps[seg->read], seg->values.data() + seg->read, m_segmentSize, m_numCols);
+}
+
+inline void RowRing::pop()
+{
+    Q_ASSERT_X(!isEmpty(), "RowRing::pop", "the ring is empty");
+    ++m_head->read;
+}
+
+} // evoplex
+#endif // ROW_RING_H
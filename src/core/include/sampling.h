@@ -0,0 +1,96 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <QString>
+
+namespace evoplex {
+
+/**
+ *  @brief The steps at which an output is recorded.
+ *
+ *  An output is evaluated only at the steps for which isDue() is true,
+ *  so the cost of reducing the attributes is not paid at the other steps.
+ *  The last step of a trial is always recorded.
+ *
+ *  In text (e.g., in the experiment's header), a sampling is written as a
+ *  suffix of the output, e.g., 'mean_nodes_score@every100':
+ *    ""         every step (default)
+ *    "everyN"   every N steps, e.g., 'every100' records 0, 100, 200...
+ *    "logN"     log-spaced, N steps per decade, e.g., 'log10'
+ *    "final"    only the last step
+ *    "change"   only when any of the values changes (run-length encoded),
+ *               i.e., a row holds until the step of the next row
+ */
+
+class Sampling
+{
+public:
+    enum Mode {
+        EveryStep,
+        EveryN,
+        LogSpaced,
+        Final,
+        OnChange
+    };
+
+    // It returns 'every step' and sets 'ok' to false if 'str' is invalid.
+    static Sampling fromString(const QString& str, bool* ok = nullptr);
+
+    Sampling() : m_mode(EveryStep), m_n(1) {}
+    explicit Sampling(Mode mode, int n = 1);
+
+    QString toString() const;
+
+    inline bool isDue(const int step, const bool isFinal) const;
+
+    inline Mode mode() const { return m_mode; }
+    inline int n() const { return m_n; }
+
+    inline bool operator==(const Sampling& s) const { return m_mode == s.m_mode && m_n == s.m_n; }
+    inline bool operator!=(const Sampling& s) const { return !(*this == s); }
+
+private:
+    Mode m_mode;
+    int m_n;
+
+    bool isLogDue(const int step) const;
+};
+
+/************************************************************************
+   Sampling: Inline member functions
+ ************************************************************************/
+
+inline bool Sampling::isDue(const int step, const bool isFinal) const
+{
+    switch (m_mode) {
+    case EveryStep: return true;
+    case EveryN: return isFinal || step % m_n == 0;
+    case LogSpaced: return isFinal || isLogDue(step);
+    case Final: return isFinal;
+    case OnChange: return true; // the values must be computed to be compared
+    default: return true;
+    }
+}
+
+} // evoplex
+#endif // SAMPLING_H
@@ -0,0 +1,52 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPAN_H
+#define SPAN_H
+
+namespace evoplex {
+
+/**
+ *  @brief A non-owning view over a contiguous sequence of elements.
+ *  It is only valid while the underlying container is not modified.
+ */
+template <typename T>
+class Span
+{
+public:
+    Span() : m_begin(nullptr), m_end(nullptr) {}
+    Span(const T* begin, const T* end) : m_begin(begin), m_end(end) {}
+
+    inline const T* begin() const { return m_begin; }
+    inline const T* end() const { return m_end; }
+    inline const T* data() const { return m_begin; }
+
+    inline int size() const { return static_cast<int>(m_end - m_begin); }
+    inline bool empty() const { return m_begin == m_end; }
+
+    inline const T& operator[](int i) const { return m_begin[i]; }
+
+private:
+    const T* m_begin;
+    const T* m_end;
+};
+
+} // evoplex
+#endif // SPAN_H
@@ -21,6 +21,8 @@
 #ifndef STATS_H
 #define STATS_H
 
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 
 #include "attributes.h"
@@ -57,5 +59,174 @@ public:
     }
 };
 
+/**
+ *  @brief Streaming estimate of a quantile in O(1) memory, i.e., the
+ *  P-square algorithm of Jain and Chlamtac (1985).
+ *
+ *  It keeps five markers (min, p/2, p, (1+p)/2 and max) whose heights are
+ *  adjusted with a piecewise-parabolic interpolation as values arrive.
+ *  The estimate is exact while there are fewer than five values.
+ */
+class P2Quantile
+{
+public:
+    explicit P2Quantile(double p);
+
+    void add(double x);
+    double value() const;
+
+    inline double probability() const { return m_p; }
+
+private:
+    double m_p;
+    int m_n;
+    double m_q[5];   // heights of the markers
+    int m_pos[5];    // actual positions of the markers
+    double m_np[5];  // desired positions of the markers
+    double m_dn[5];  // increments of the desired positions
+
+    double parabolic(int i, int d) const;
+    double linear(int i, int d) const;
+};
+
+/**
+ *  @brief Single-pass summary of a numeric attribute.
+ *
+ *  It accumulates the count, sum, mean, (population) variance, min and
+ *  max of the values and, if requested, a histogram and a set of
+ *  quantiles, so that all of them are computed in a single pass over the
+ *  values. Arrays without histogram and quantiles (e.g., a column of
+ *  AttributeColumns) are reduced in independent lanes, which lets the
+ *  compiler vectorize the loop.
+ */
+class Summary
+{
+public:
+    // 'binEdges' are the lower bounds of the bins in ascending order,
+    // i.e., the bin i holds the values in [binEdges[i], binEdges[i+1]);
+    // values below the first edge are not binned.
+    // 'probs' are the probabilities of the quantiles, in [0,1].
+    explicit Summary(const std::vector<double>& binEdges = std::vector<double>(),
+                     const std::vector<double>& probs = std::vector<double>());
+
+    inline void add(double x);
+    template <typename T> void add(const T* begin, const T* end);
+
+    inline int count() const { return m_n; }
+    inline double sum() const;
+    double mean() const;
+    double variance() const;
+    double min() const;
+    double max() const;
+
+    inline const std::vector<int>& bins() const { return m_bins; }
+    // number of values in the bins whose lower bounds are in [lower, upper);
+    // both 'lower' and 'upper' are expected to be edges of the bins
+    int binCount(double lower, double upper) const;
+    // estimate of the i-th quantile
+    inline double quantile(size_t i) const { return m_quantiles.at(i).value(); }
+    // estimate of the quantile with probability p; NaN if it is not tracked
+    double quantileOf(double p) const;
+
+private:
+    int m_n;
+    // the sums are shifted by the first value to avoid cancellations
+    // when computing the variance
+    double m_shift;
+    double m_sum;
+    double m_sumSq;
+    double m_min;
+    double m_max;
+    std::vector<double> m_binEdges;
+    std::vector<int> m_bins;
+    std::vector<P2Quantile> m_quantiles;
+};
+
+/************************************************************************
+   Summary: Inline member functions
+ ************************************************************************/
+
+inline void Summary::add(double x)
+{
+    if (m_n == 0) {
+        m_shift = x;
+        m_min = m_max = x;
+    }
+    ++m_n;
+    const double d = x - m_shift;
+    m_sum += d;
+    m_sumSq += d * d;
+    m_min = std::min(m_min, x);
+    m_max = std::max(m_max, x);
+
+    if (!m_binEdges.empty()) {
+        const std::ptrdiff_t bin = std::upper_bound(m_binEdges.begin(), m_binEdges.end(), x)
+                                 - m_binEdges.begin() - 1;
+        if (bin >= 0) {
+            ++m_bins[bin];
+        }
+    }
+    for (P2Quantile& q : m_quantiles) {
+        q.add(x);
+    }
+}
+
+template <typename T>
+void Summary::add(const T* begin, const T* end)
+{
+    if (begin == end) {
+        return;
+    } else if (!m_binEdges.empty() || !m_quantiles.empty()) {
+        for (const T* it = begin; it != end; ++it) {
+            add(static_cast<double>(*it));
+        }
+        return;
+    }
+
+    if (m_n == 0) {
+        m_shift = m_min = m_max = static_cast<double>(*begin);
+    }
+
+    const int kLanes = 4;
+    double sum[kLanes], sumSq[kLanes], mn[kLanes], mx[kLanes];
+    for (int l = 0; l < kLanes; ++l) {
+        sum[l] = sumSq[l] = 0.0;
+        mn[l] = m_min;
+        mx[l] = m_max;
+    }
+
+    const std::ptrdiff_t n = end - begin;
+    std::ptrdiff_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (int l = 0; l < kLanes; ++l) {
+            const double x = static_cast<double>(begin[i + l]);
+            const double d = x - m_shift;
+            sum[l] += d;
+            sumSq[l] += d * d;
+            mn[l] = mn[l] < x ? mn[l] : x;
+            mx[l] = mx[l] > x ? mx[l] : x;
+        }
+    }
+    for (; i < n; ++i) {
+        const double x = static_cast<double>(begin[i]);
+        const double d = x - m_shift;
+        sum[0] += d;
+        sumSq[0] += d * d;
+        mn[0] = std::min(mn[0], x);
+        mx[0] = std::max(mx[0], x);
+    }
+
+    m_n += static_cast<int>(n);
+    for (int l = 0; l < kLanes; ++l) {
+        m_sum += sum[l];
+        m_sumSq += sumSq[l];
+        m_min = std::min(m_min, mn[l]);
+        m_max = std::max(m_max, mx[l]);
+    }
+}
+
+inline double Summary::sum() const
+{ return m_sum + m_n * m_shift; }
+
 }
 #endif // STATS_H
@@ -0,0 +1,52 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STRING_TABLE_H
+#define STRING_TABLE_H
+
+#include <QtGlobal>
+
+namespace evoplex {
+
+/**
+ *  @brief A global, thread-safe table of interned strings.
+ *
+ *  Each distinct string is stored once and identified by a 32-bit symbol,
+ *  which is all a STRING Value holds. That makes copying, hashing and
+ *  comparing strings O(1), and none of them allocates.
+ *  Symbols and their strings live until the end of the program; the
+ *  symbol 0 is the empty string.
+ */
+class StringTable
+{
+public:
+    // returns the symbol of the string, adding it to the table if needed
+    static quint32 intern(const char* str);
+    static quint32 intern(const char* str, int len);
+
+    // the string of a symbol; it remains valid until the end of the program
+    static const char* str(quint32 symbol);
+
+    // number of distinct strings in the table
+    static int size();
+};
+
+} // evoplex
+#endif // STRING_TABLE_H
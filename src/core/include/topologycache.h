@@ -0,0 +1,85 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOPOLOGY_CACHE_H
+#define TOPOLOGY_CACHE_H
+
+#include <QMutex>
+#include <QString>
+#include <future>
+#include <map>
+#include <memory>
+#include <tuple>
+
+#include "edgelist.h"
+
+namespace evoplex {
+
+typedef std::shared_ptr<const EdgeList> EdgeListPtr;
+
+/**
+ *  @brief Read-only topologies (i.e., edge lists) shared by the trials of
+ *  an experiment, so that a file is parsed once instead of once per trial
+ *  and per reset.
+ *
+ *  The entries are keyed by the file path, its last modification time,
+ *  the graph type and the number of nodes (which the edges are validated
+ *  against), so a file which changes on disk is read again.
+ *
+ *  A file is read without holding the lock of the cache. Instead, its
+ *  entry is added before reading it, so the trials which need the same
+ *  file wait for that entry only, while the others go on.
+ *  All methods are thread-safe.
+ */
+class TopologyCache
+{
+public:
+    // Returns the edges of the file, reading it only if it is not cached.
+    // If it fails, it returns a null pointer and sets the error message.
+    EdgeListPtr edges(const QString& filePath, int graphType, int numNodes,
+                      QString* errMsg = nullptr);
+
+    // Drops all the entries; the topologies in use stay alive until the
+    // graphs release them.
+    void clear();
+
+    inline int size() const;
+
+private:
+    typedef std::tuple<QString, qint64, int, int> Key;
+
+    struct Entry {
+        EdgeListPtr edges; // null if it failed
+        QString error;
+    };
+
+    mutable QMutex m_mutex;
+    std::map<Key, std::shared_future<Entry>> m_edges; // ready or being read
+};
+
+/************************************************************************
+   TopologyCache: Inline member functions
+ ************************************************************************/
+
+inline int TopologyCache::size() const
+{ QMutexLocker locker(&m_mutex); return static_cast<int>(m_edges.size()); }
+
+} // evoplex
+#endif // TOPOLOGY_CACHE_H
@@ -27,6 +27,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "arena.h"
 #include "prg.h"
 
 namespace evoplex
@@ -73,13 +74,13 @@ namespace Utils
         s.clear();
     }
 
-    // clone a population of nodes
+    // clone a population of nodes, optionally into an arena
     template <class C>
-    C clone(const C& container) {
+    C clone(const C& container, const ArenaPtr& arena = ArenaPtr()) {
         C ret;
         ret.reserve(container.size());
         for (auto const& pair : container) {
-            ret.insert({pair.first, pair.second->clone()});
+            ret.insert({pair.first, pair.second->clone(arena)});
         }
         return ret;
     }
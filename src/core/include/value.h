@@ -22,21 +22,33 @@
 #define VALUE_H
 
 #include <functional>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <QString>
 
+#include "stringtable.h"
+
 namespace evoplex
 {
 class Value;
 typedef std::vector<Value> Values;
 
+/**
+ *  @brief A tagged union of bool, char, double, int and string.
+ *  Strings are interned in the StringTable, so a STRING Value only holds
+ *  a symbol, and copying, hashing and comparing Values never allocates.
+ *  It is a trivially copyable 16-byte object, i.e., containers of Values
+ *  are copied and grown with memcpy.
+ */
 class Value
 {
 public:
     enum Type { BOOL, CHAR, DOUBLE, INT, STRING, INVALID };
 
     Value();
-    Value(const Value& value);
+    Value(const Value& value) = default;
+    Value(Value&& value) noexcept = default;
     Value(const bool value);
     Value(const char value);
     Value(const double value);
@@ -44,8 +56,6 @@ public:
     Value(const char* value);
     Value(const QString& value);
 
-    ~Value();
-
     inline Type type() const;
     inline bool isValid() const;
     inline bool isBool() const;
@@ -60,8 +70,13 @@ public:
     inline int toInt() const;
     inline const char* toString() const;
     QString toQString(char format = 'g', int precision = 8) const;
+    // the symbol of a STRING in the StringTable
+    inline quint32 toSymbol() const;
+
+    Value& operator=(const Value& v) = default;
+    Value& operator=(Value&& v) noexcept = default;
+    inline void swap(Value& v) noexcept;
 
-    Value& operator=(const Value& v);
     bool operator==(const Value& v) const;
     bool operator!=(const Value& v) const;
     bool operator<(const Value& v) const;
@@ -70,7 +85,7 @@ public:
     bool operator>=(const Value& v) const;
 
 private:
-    union { bool b; char c; double d; int i; const char* s; } m_data;
+    union { bool b; char c; double d; int i; quint32 s; } m_data;
     Type m_type;
 };
 
@@ -78,6 +93,16 @@ private:
    Value: Inline member functions
  ************************************************************************/
 
+inline void Value::swap(Value& v) noexcept
+{ std::swap(m_data, v.m_data); std::swap(m_type, v.m_type); }
+
+inline void swap(Value& a, Value& b) noexcept
+{ a.swap(b); }
+
+static_assert(sizeof(Value) == 16, "Value is expected to fit in 16 bytes");
+static_assert(std::is_trivially_copyable<Value>::value, "Value must be trivially copyable");
+static_assert(std::is_nothrow_move_constructible<Value>::value, "Value must be nothrow movable");
+
 inline Value::Type Value::type() const
 { return m_type; }
 
@@ -112,6 +137,9 @@ inline int Value::toInt() const
 { return m_data.i; }
 
 inline const char* Value::toString() const
+{ return StringTable::str(m_data.s); }
+
+inline quint32 Value::toSymbol() const
 { return m_data.s; }
 
 } // evoplex
@@ -142,7 +170,7 @@ struct hash<evoplex::Value>
         case evoplex::Value::DOUBLE: return std::hash<double>()(v.toDouble());
         case evoplex::Value::BOOL: return std::hash<bool>()(v.toBool());
         case evoplex::Value::CHAR: return std::hash<char>()(v.toChar());
-        case evoplex::Value::STRING: return std::hash<char*>()(v.toString());
+        case evoplex::Value::STRING: return std::hash<quint32>()(v.toSymbol());
         default: throw std::invalid_argument("invalid type of Value");
         }
     }
@@ -28,6 +28,7 @@
 
 #include "mainapp.h"
 #include "experimentsmgr.h"
+#include "filewriter.h"
 #include "logger.h"
 #include "project.h"
 #include "constants.h"
@@ -45,6 +46,7 @@ const char* MainApp::kPluginExtension = ".so";
 
 MainApp::MainApp()
     : m_experimentsMgr(new ExperimentsMgr())
+    , m_fileWriter(new FileWriter())
 {
     resetSettingsToDefault();
     m_defaultStepDelay = m_userPrefs.value("settings/stepDelay", m_defaultStepDelay).toInt();
@@ -68,6 +70,7 @@ MainApp::MainApp()
     addAttrScope(id, OUTPUT_DIR, "string");
     addAttrScope(id, OUTPUT_HEADER, "string");
     addAttrScope(id, OUTPUT_AVGTRIALS, "bool");
+    addAttrScope(id, OUTPUT_FORMAT, "string{csv,bin,binz}");
 
     QStringList searchPaths;
     searchPaths << qApp->applicationDirPath() + "/lib/evoplex/plugins";
@@ -92,6 +95,10 @@ MainApp::~MainApp()
     Utils::deleteAndShrink(m_graphs);
     delete m_experimentsMgr;
     m_experimentsMgr = nullptr;
+    // the experiments are only deleted later on (see ExperimentsMgr), so they
+    // must not rely on it; it writes what is left in the queue and closes the files
+    delete m_fileWriter;
+    m_fileWriter = nullptr;
 }
 
 void MainApp::resetSettingsToDefault()
@@ -35,6 +35,7 @@
 namespace evoplex {
 
 class ExperimentsMgr;
+class FileWriter;
 class Project;
 
 typedef QSharedPointer<Project> ProjectPtr;
@@ -69,6 +70,7 @@ public:
     void setStepsToFlush(int steps);
 
     inline ExperimentsMgr* expMgr() const { return m_experimentsMgr; }
+    inline FileWriter* fileWriter() const { return m_fileWriter; }
     inline const QHash<QString, GraphPlugin*>& graphs() const { return m_graphs; }
     inline const QHash<QString, ModelPlugin*>& models() const { return m_models; }
     inline const std::map<int, ProjectPtr>& projects() const { return m_projects; }
@@ -95,6 +97,7 @@ private:
     void initUserPlugins();
 
     ExperimentsMgr* m_experimentsMgr;
+    FileWriter* m_fileWriter; // writes the output files in its own thread
     QDir m_systemPluginsDir;
 
     QSettings m_userPrefs;
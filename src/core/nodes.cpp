@@ -20,16 +20,259 @@
 
 #include <QFile>
 #include <QFileInfo>
-#include <QTextStream>
 #include <QtDebug>
 #include <QStringList>
+#include <algorithm>
 
 #include "nodes.h"
 #include "attrsgenerator.h"
 #include "abstractgraph.h"
+#include "columnfile.h"
+#include "graphsnapshot.h"
+#include "parallelfor.h"
+#include "textfile.h"
 
 namespace evoplex {
 
+namespace {
+
+// the type of the values of an attribute range
+Value::Type valueType(const AttributeRange* attrRange)
+{
+    switch (attrRange->type()) {
+    case AttributeRange::Bool: return Value::BOOL;
+    case AttributeRange::Int_Range:
+    case AttributeRange::Int_Set: return Value::INT;
+    case AttributeRange::Double_Range:
+    case AttributeRange::Double_Set: return Value::DOUBLE;
+    case AttributeRange::String:
+    case AttributeRange::String_Set:
+    case AttributeRange::DirPath:
+    case AttributeRange::FilePath: return Value::STRING;
+    default: return Value::INVALID;
+    }
+}
+
+// true if the value of a column (of the right type) belongs to the range
+bool inRange(const AttributeRange* attrRange, const Value& value)
+{
+    switch (attrRange->type()) {
+    case AttributeRange::Int_Range:
+    case AttributeRange::Double_Range:
+        return value >= attrRange->min() && value <= attrRange->max();
+    case AttributeRange::Int_Set:
+    case AttributeRange::Double_Set:
+    case AttributeRange::String_Set: {
+        const Values& set = dynamic_cast<const SetOfValues*>(attrRange)->values();
+        return std::find(set.cbegin(), set.cend(), value) != set.cend();
+    }
+    default:
+        return true;
+    }
+}
+
+// big enough to make the overhead of a task negligible
+const qint64 kChunkSize = 4 << 20;
+// the progress is reported after each batch of chunks
+const size_t kChunksPerBatch = 16;
+// rows formatted (and compressed) at once when saving a csv file
+const int kRowsPerChunk = 1 << 16;
+
+// the CRC-32 used by gzip
+quint32 crc32(const QByteArray& data)
+{
+    static const std::vector<quint32> kTable = []() {
+        std::vector<quint32> table(256);
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    const uchar* p = reinterpret_cast<const uchar*>(data.constData());
+    for (const uchar* end = p + data.size(); p < end; ++p) {
+        crc = kTable[(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Compresses 'data' into a gzip member. A file can be made of several
+// members, which are decompressed as a whole, so each chunk is compressed
+// on its own. qCompress() returns the uncompressed size (4 bytes) and a
+// zlib stream, i.e., a 2-byte header, the deflate data and a 4-byte
+// checksum; the deflate data is wrapped into the gzip format instead.
+QByteArray gzipMember(const QByteArray& data)
+{
+    const QByteArray zlib = qCompress(data, 1);
+    const int deflateSize = zlib.size() - 10;
+    Q_ASSERT_X(deflateSize > 0, "Nodes", "unexpected output of qCompress()");
+
+    auto put32 = [](QByteArray& buf, quint32 v) {
+        for (int i = 0; i < 4; ++i) {
+            buf.append(static_cast<char>((v >> (8 * i)) & 0xFF));
+        }
+    };
+
+    // magic, deflate, no flags, no mtime, no extra flags, unknown OS
+    static const char kHeader[] = { '\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff' };
+    QByteArray member;
+    member.reserve(deflateSize + 18);
+    member.append(kHeader, sizeof(kHeader));
+    member.append(zlib.constData() + 6, deflateSize);
+    put32(member, crc32(data));
+    put32(member, static_cast<quint32>(data.size()));
+    return member;
+}
+
+// How a column of a csv file is parsed and validated; it is worked out
+// from the header once, instead of for every cell.
+struct ColumnPlan
+{
+    enum Kind { Invalid, X, Y, Int, Double, Bool, Other };
+
+    Kind kind;
+    const AttributeRange* attrRange;
+    int intMin, intMax;
+    double doubleMin, doubleMax;
+    Values set; // the valid values of sets; empty for ranges
+
+    ColumnPlan(const QString& name, const AttributeRange* range)
+        : kind(Invalid), attrRange(range), intMin(0), intMax(0), doubleMin(0.), doubleMax(0.)
+    {
+        if (name == "x") {
+            kind = X;
+        } else if (name == "y") {
+            kind = Y;
+        } else if (!attrRange) {
+            kind = Invalid; // not required by the model
+        } else {
+            switch (attrRange->type()) {
+            case AttributeRange::Int_Range:
+                kind = Int;
+                intMin = attrRange->min().toInt();
+                intMax = attrRange->max().toInt();
+                break;
+            case AttributeRange::Double_Range:
+                kind = Double;
+                doubleMin = attrRange->min().toDouble();
+                doubleMax = attrRange->max().toDouble();
+                break;
+            case AttributeRange::Int_Set:
+            case AttributeRange::Double_Set:
+                kind = attrRange->type() == AttributeRange::Int_Set ? Int : Double;
+                set = dynamic_cast<const SetOfValues*>(attrRange)->values();
+                break;
+            case AttributeRange::Bool:
+                kind = Bool;
+                break;
+            default:
+                kind = Other;
+            }
+        }
+    }
+
+    inline bool inSet(const Value& v) const
+    { return std::find(set.cbegin(), set.cend(), v) != set.cend(); }
+
+    // parses the cell [p, end) into the coordinates or into 'attrs'
+    bool parse(const char* p, const char* end, int& x, int& y, Attributes& attrs) const
+    {
+        switch (kind) {
+        case X:
+            return TextFile::parseInt(p, end, x) && p == end;
+        case Y:
+            return TextFile::parseInt(p, end, y) && p == end;
+        case Int: {
+            int v;
+            if (!TextFile::parseInt(p, end, v) || p != end
+                    || (set.empty() ? (v < intMin || v > intMax) : !inSet(Value(v)))) {
+                return false;
+            }
+            attrs.setValue(attrRange->id(), Value(v));
+            return true;
+        }
+        case Double: {
+            double v;
+            if (!TextFile::parseDouble(p, end, v)
+                    || (set.empty() ? !(v >= doubleMin && v <= doubleMax) : !inSet(Value(v)))) {
+                return false;
+            }
+            attrs.setValue(attrRange->id(), Value(v));
+            return true;
+        }
+        case Bool: {
+            const auto len = end - p;
+            const bool isTrue = (len == 4 && std::equal(p, end, "true")) || (len == 1 && *p == '1');
+            const bool isFalse = (len == 5 && std::equal(p, end, "false")) || (len == 1 && *p == '0');
+            if (!isTrue && !isFalse) {
+                return false;
+            }
+            attrs.setValue(attrRange->id(), Value(isTrue));
+            return true;
+        }
+        case Other: {
+            const Value v = attrRange->validate(QString::fromUtf8(p, static_cast<int>(end - p)));
+            if (!v.isValid()) {
+                return false;
+            }
+            attrs.setValue(attrRange->id(), v);
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+};
+
+struct NodesChunk {
+    std::vector<NodePtr> nodes;
+    int firstRow = 0; // id of the first node
+    int numRows = 0;
+    int errorRow = -1; // local row of the first invalid row
+    QString error;
+};
+
+void parseChunk(const Span<char>& text, const std::vector<ColumnPlan>& plan,
+                const Attributes& defaults, bool isDirected, NodesChunk& chunk)
+{
+    chunk.nodes.reserve(chunk.numRows);
+    const char* p = text.begin();
+    for (int row = 0; p < text.end(); ++row) {
+        const Span<char> line = TextFile::readLine(p, text.end());
+        const int id = chunk.firstRow + row;
+        int x = 0;
+        int y = id;
+        Attributes attrs = defaults;
+        const char* c = line.begin();
+        for (size_t col = 0; col < plan.size(); ++col) {
+            const char* cellEnd = std::find(c, line.end(), ',');
+            if ((cellEnd == line.end()) != (col + 1 == plan.size())) {
+                chunk.error = "rows must have the same number of columns!";
+            } else if (!plan[col].parse(c, cellEnd, x, y, attrs)) {
+                chunk.error = QString("invalid value at column: %1").arg(static_cast<int>(col));
+            }
+            if (!chunk.error.isEmpty()) {
+                chunk.errorRow = row;
+                return;
+            }
+            c = cellEnd + 1;
+        }
+
+        if (isDirected) {
+            chunk.nodes.emplace_back(std::make_shared<DNode>(id, attrs, x, y));
+        } else {
+            chunk.nodes.emplace_back(std::make_shared<UNode>(id, attrs, x, y));
+        }
+    }
+}
+
+} // namespace
+
 Nodes Nodes::fromCmd(const QString& cmd, const AttributesScope& attrsScope,
              const int graphType, QString* errMsg, std::function<void(int)> progress)
 {
@@ -69,43 +312,189 @@ Nodes Nodes::fromFile(const QString& filePath, const AttributesScope& attrsScope
     Q_ASSERT_X(isDirected || graphType == AbstractGraph::Undirected,
                "Nodes", "graph type must be 'directed' or 'undirected'");
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        *errMsg = "unable to read csv file with the set of nodes.\n" + filePath;
-        qWarning() << *errMsg;
+    if (GraphSnapshot::isSnapshot(filePath)) {
+        // the attributes are copied into the nodes
+        AttributeColumns attrs;
+        const Nodes bare = fromSnapshot(filePath, attrsScope, graphType, attrs, errMsg);
+        std::vector<int> ids;
+        ids.reserve(bare.size());
+        for (auto const& p : bare) {
+            ids.emplace_back(p.first);
+        }
+        std::sort(ids.begin(), ids.end());
+
+        Nodes nodes;
+        nodes.reserve(bare.size());
+        const qint64 numRows = static_cast<qint64>(ids.size());
+        int lastPermille = -1;
+        for (int row = 0; row < static_cast<int>(ids.size()); ++row) {
+            const NodePtr& n = bare.at(ids[row]);
+            const Attributes a = attrs.row(row);
+            if (isDirected) {
+                nodes.insert({n->id(), std::make_shared<DNode>(n->id(), a, n->x(), n->y())});
+            } else {
+                nodes.insert({n->id(), std::make_shared<UNode>(n->id(), a, n->x(), n->y())});
+            }
+            const int permille = static_cast<int>((row + 1) * 1000 / numRows);
+            if (permille != lastPermille) {
+                lastPermille = permille;
+                progress(permille);
+            }
+        }
+        return nodes;
+    }
+
+    auto fail = [errMsg, &filePath](const QString& msg) {
+        if (errMsg) {
+            *errMsg = msg + "\n" + filePath;
+            qWarning() << *errMsg;
+        }
+        return Nodes();
+    };
+
+    TextFile file;
+    if (!file.open(filePath)) {
+        return fail("unable to read csv file with the set of nodes.");
+    } else if (file.size() == 0) {
         return Nodes();
     }
 
-    QTextStream in(&file);
+    // read and validate header, which is turned into a plan of how to
+    // parse and validate each column
+    const char* p = file.begin();
+    const Span<char> headerLine = TextFile::readLine(p, file.end());
+    QString error;
+    const QStringList header = validateHeader(
+            QString::fromUtf8(headerLine.data(), headerLine.size()), attrsScope, &error);
+    if (header.isEmpty()) {
+        return fail("failed to read attributes from file. " + error);
+    }
 
-    // read and validate header
-    QStringList header;
-    if (!in.atEnd()) {
-        header = validateHeader(in.readLine(), attrsScope);
-        if (header.isEmpty()) {
-            *errMsg = "failed to read attributes from file.\n" + filePath;
-            qWarning() << *errMsg;
-            return Nodes();
+    std::vector<ColumnPlan> plan;
+    plan.reserve(header.size());
+    Attributes defaults(attrsScope.size());
+    for (const QString& col : header) {
+        plan.emplace_back(col, attrsScope.value(col));
+    }
+    for (const AttributeRange* attrRange : attrsScope) {
+        defaults.replace(attrRange->id(), attrRange->attrName(), attrRange->min());
+    }
+
+    // the rows of each chunk are counted first, so the ids are known upfront
+    const std::vector<Span<char>> texts = file.chunks(p, kChunkSize);
+    std::vector<NodesChunk> chunks(texts.size());
+    ParallelFor::run(static_cast<int>(texts.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const Span<char>& t = texts[i];
+            chunks[i].numRows = static_cast<int>(std::count(t.begin(), t.end(), '\n'))
+                    + (t.empty() || t.end()[-1] == '\n' ? 0 : 1);
         }
+    }, 1);
+    int numRows = 0;
+    for (NodesChunk& chunk : chunks) {
+        chunk.firstRow = numRows;
+        numRows += chunk.numRows;
+    }
+
+    // parsed in batches of chunks, so the progress is reported (in bytes
+    // per mille of the file) from this thread
+    qint64 bytesDone = p - file.begin();
+    for (size_t batch = 0; batch < texts.size(); batch += kChunksPerBatch) {
+        const int batchSize = static_cast<int>(std::min(kChunksPerBatch, texts.size() - batch));
+        ParallelFor::run(batchSize, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                parseChunk(texts[batch + i], plan, defaults, isDirected, chunks[batch + i]);
+            }
+        }, 1);
+
+        for (int i = 0; i < batchSize; ++i) {
+            const NodesChunk& chunk = chunks[batch + i];
+            if (chunk.errorRow >= 0) {
+                return fail(QString("%1\n row: %2").arg(chunk.error).arg(chunk.firstRow + chunk.errorRow));
+            }
+            bytesDone += texts[batch + i].size();
+        }
+        progress(static_cast<int>(bytesDone * 1000 / file.size()));
     }
 
-    // create set of attributes
-    int row = 0;
     Nodes nodes;
-    while (!in.atEnd()) {
-        QStringList values = in.readLine().split(",");
-        NodePtr node = readRow(row, header, values, attrsScope, isDirected);
-        if (!node) {
-            *errMsg = QString("%1\n row: %2").arg(*errMsg).arg(row);
-            qWarning() << *errMsg;
-            return Nodes();
+    nodes.reserve(numRows);
+    for (NodesChunk& chunk : chunks) {
+        for (NodePtr& node : chunk.nodes) {
+            const int id = node->id();
+            nodes.insert({id, std::move(node)});
         }
-        nodes.insert({row, node});
-        progress(row);
-        ++row;
+        std::vector<NodePtr>().swap(chunk.nodes);
     }
-    file.close();
+    return nodes;
+}
+
+Nodes Nodes::fromSnapshot(const QString& filePath, const AttributesScope& attrsScope,
+                          const int graphType, AttributeColumns& attrs, QString* errMsg)
+{
+    bool isDirected = graphType == AbstractGraph::Directed;
+    Q_ASSERT_X(isDirected || graphType == AbstractGraph::Undirected,
+               "Nodes", "graph type must be 'directed' or 'undirected'");
 
+    QString error;
+    attrs.clear();
+    const GraphSnapshotPtr snapshot = GraphSnapshot::open(filePath, &error);
+    if (!snapshot) {
+        if (errMsg) {
+            *errMsg = error;
+        }
+        qWarning() << error;
+        return Nodes();
+    }
+
+    // the columns are picked by name, in the order of the scope, and must
+    // have the values expected by it
+    std::vector<const AttributeRange*> ranges(attrsScope.size(), nullptr);
+    for (const AttributeRange* attrRange : attrsScope) {
+        ranges.at(attrRange->id()) = attrRange;
+    }
+    const AttributeColumns& columns = snapshot->nodeAttrs();
+    for (const AttributeRange* attrRange : ranges) {
+        const int col = columns.indexOf(attrRange->attrName());
+        if (col < 0 || columns.type(col) != valueType(attrRange)) {
+            error = QString("the snapshot is incompatible for the model.\n"
+                            "Expected attribute: %1 (%2)")
+                            .arg(attrRange->attrName()).arg(attrRange->attrRangeStr());
+            break;
+        }
+        for (int row = 0; row < columns.numRows(); ++row) {
+            if (!inRange(attrRange, columns.value(row, col))) {
+                error = QString("invalid value of '%1' at row: %2")
+                                .arg(attrRange->attrName()).arg(row);
+                break;
+            }
+        }
+        if (!error.isEmpty()) {
+            break;
+        }
+        attrs.appendColumn(columns, col);
+    }
+    if (!error.isEmpty()) {
+        attrs.clear();
+        if (errMsg) {
+            *errMsg = QString("%1\n%2").arg(error).arg(filePath);
+        }
+        qWarning() << error;
+        return Nodes();
+    }
+
+    // the ids are renumbered, as the saved ones may have gaps
+    Nodes nodes;
+    nodes.reserve(snapshot->numNodes());
+    for (int row = 0; row < snapshot->numNodes(); ++row) {
+        const int x = snapshot->nodeX()[row];
+        const int y = snapshot->nodeY()[row];
+        if (isDirected) {
+            nodes.insert({row, std::make_shared<DNode>(row, Attributes(), x, y)});
+        } else {
+            nodes.insert({row, std::make_shared<UNode>(row, Attributes(), x, y)});
+        }
+    }
     return nodes;
 }
 
@@ -116,7 +505,26 @@ bool Nodes::saveToFile(QString filePath, std::function<void(int)> progress) cons
         return false;
     }
 
-    if (!filePath.endsWith(".csv")) {
+    if (GraphSnapshot::isSnapshot(filePath)) {
+        std::vector<NodePtr> rows;
+        rows.reserve(size());
+        for (auto const& pair : (*this)) {
+            rows.emplace_back(pair.second);
+        }
+        std::sort(rows.begin(), rows.end(),
+                  [](const NodePtr& a, const NodePtr& b) { return a->id() < b->id(); });
+
+        QString errMsg;
+        if (!GraphSnapshot::save(filePath, false, rows, std::vector<EdgePtr>(), &errMsg)) {
+            qWarning() << "failed to save the set of nodes to file." << errMsg;
+            return false;
+        }
+        progress(rows.back()->id());
+        return true;
+    }
+
+    const bool compressed = filePath.endsWith(".gz");
+    if (!compressed && !filePath.endsWith(".csv")) {
         filePath += ".csv";
     }
 
@@ -126,22 +534,62 @@ bool Nodes::saveToFile(QString filePath, std::function<void(int)> progress) cons
         return false;
     }
 
-    QTextStream out(&file);
-    const std::vector<QString>& header = (*begin()).second->attrs().names();
-    for (const QString& col : header) {
-        out << col << ",";
+    // rows are written in ascending order of ids
+    std::vector<const Node*> rows;
+    rows.reserve(size());
+    for (auto const& pair : (*this)) {
+        rows.emplace_back(pair.second.get());
     }
-    out << "x,y\n";
+    std::sort(rows.begin(), rows.end(),
+              [](const Node* a, const Node* b) { return a->id() < b->id(); });
 
-    for (auto const& pair : (*this)) {
-        for (const Value& value : pair.second->attrs().values()) {
-            out << value.toQString() << ",";
-        }
-        out << pair.second->x() << ",";
-        out << pair.second->y() << "\n";
+    QByteArray header;
+    const std::vector<QString> names = rows.front()->attrs().names();
+    for (const QString& col : names) {
+        header.append(col.toUtf8());
+        header.append(',');
+    }
+    header.append("x,y\n");
+    const int numAttrs = static_cast<int>(names.size());
 
-        out.flush();
-        progress(pair.first);
+    // the chunks of a batch are formatted (and compressed) in parallel,
+    // then they are written in order by this thread
+    const int numRows = static_cast<int>(rows.size());
+    const int numChunks = (numRows + kRowsPerChunk - 1) / kRowsPerChunk;
+    std::vector<QByteArray> bufs(std::min<size_t>(kChunksPerBatch, numChunks));
+    for (int batch = 0; batch < numChunks; batch += static_cast<int>(bufs.size())) {
+        const int batchSize = std::min(static_cast<int>(bufs.size()), numChunks - batch);
+        ParallelFor::run(batchSize, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                const int firstRow = (batch + i) * kRowsPerChunk;
+                const int lastRow = std::min(firstRow + kRowsPerChunk, numRows);
+                QByteArray& buf = bufs[i];
+                buf = firstRow == 0 ? header : QByteArray();
+                buf.reserve(buf.size() + (lastRow - firstRow) * (numAttrs + 2) * 8);
+                for (int r = firstRow; r < lastRow; ++r) {
+                    const Node* node = rows[r];
+                    for (int id = 0; id < numAttrs; ++id) {
+                        ColumnFile::appendText(buf, node->attr(id));
+                        buf.append(',');
+                    }
+                    ColumnFile::appendText(buf, Value(node->x()));
+                    buf.append(',');
+                    ColumnFile::appendText(buf, Value(node->y()));
+                    buf.append('\n');
+                }
+                if (compressed) {
+                    buf = gzipMember(buf);
+                }
+            }
+        }, 1);
+
+        for (int i = 0; i < batchSize; ++i) {
+            if (file.write(bufs[i]) != bufs[i].size()) {
+                qWarning() << "failed to save the set of nodes to file." << filePath;
+                return false;
+            }
+        }
+        progress(std::min((batch + batchSize) * kRowsPerChunk, numRows));
     }
 
     file.close();
@@ -168,7 +616,7 @@ QStringList Nodes::validateHeader(const QString& header, const AttributesScope&
     }
 
     for (const auto* attrRange : attrsScope) {
-        if (!header.contains(attrRange->attrName())) {
+        if (!headerList.contains(attrRange->attrName())) {
             *errMsg = QString("the header is imcompatible for the model.\n"
                               "Expected attributes: %1").arg(attrsScope.keys().join(", "));
             return QStringList();
@@ -177,44 +625,4 @@ QStringList Nodes::validateHeader(const QString& header, const AttributesScope&
     return headerList;
 }
 
-NodePtr Nodes::readRow(const int row, const QStringList& header, const QStringList& values,
-                       const AttributesScope& attrsScope, const bool isDirected, QString* errMsg)
-{
-    if (values.size() != header.size()) {
-        *errMsg = "rows must have the same number of columns!";
-        return nullptr;
-    }
-
-    int coordX = 0;
-    int coordY = row;
-    Attributes attrs(attrsScope.size());
-    for (int col = 0; col < values.size(); ++col) {
-        bool isValid = false;
-        if (header.at(col) == "x") {
-            coordX = values.at(col).toInt(&isValid);
-        } else if (header.at(col) == "y") {
-            coordY = values.at(col).toInt(&isValid);
-        } else {
-            AttributeRange* attrRange = attrsScope.value(header.at(col));
-            if (attrRange) { // is null if the column is not required
-                Value value = attrRange->validate(values.at(col));
-                if (value.isValid()) {
-                    isValid = true;
-                    attrs.replace(attrRange->id(), header.at(col), value);
-                }
-            }
-        }
-
-        if (!isValid) {
-            *errMsg = QString("invalid value at column: %1").arg(col);
-            return nullptr;
-        }
-    }
-
-    if (isDirected) {
-        return std::make_shared<DNode>(row, attrs, coordX, coordY);
-    }
-    return std::make_shared<UNode>(row, attrs, coordX, coordY);
-}
-
 } // evoplex
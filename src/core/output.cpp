@@ -20,6 +20,11 @@
 
 #include <QDebug>
 #include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <tuple>
 
 #include "output.h"
 #include "utils.h"
@@ -29,10 +34,13 @@ namespace evoplex
 
 Cache::Cache(Values inputs, std::vector<int> trialIds, OutputPtr parent)
     : m_parent(parent)
-    , m_inputs(inputs)
+    , m_inputs(std::move(inputs))
 {
     for (int trialId : trialIds) {
-        m_trials.insert({trialId, Data()});
+        m_trials.emplace(std::piecewise_construct, std::forward_as_tuple(trialId),
+                         std::forward_as_tuple(static_cast<int>(m_inputs.size())));
+        // created upfront, as trials might run concurrently
+        m_lastValues.insert({trialId, Values()});
     }
 }
 
@@ -43,9 +51,9 @@ void Cache::deleteCache()
 
 bool Cache::isEmpty(const int trialId) const
 {
-    std::unordered_map<int, Data>::const_iterator trial = m_trials.find(trialId);
+    std::unordered_map<int, RowRing>::const_iterator trial = m_trials.find(trialId);
     if (trial != m_trials.end()) {
-        return trial->second.rows.empty();
+        return trial->second.isEmpty();
     }
     return false;
 }
@@ -53,51 +61,205 @@ bool Cache::isEmpty(const int trialId) const
 QString Cache::printableHeader(const char sep, const bool joinInputs) const
 {
     return Output::printableHeader(m_parent->printableHeaderPrefix(),
-                                   m_inputs, sep, joinInputs);
+                                   m_inputs, sep, joinInputs, m_parent->sampling());
 }
 
 void Cache::flushAll()
 {
     for (auto& it : m_trials) {
-        it.second.rows.clear();
+        it.second.clear();
+    }
+    for (auto& it : m_lastValues) {
+        it.second.clear();
     }
 }
 
 /*******************************************************/
 /*******************************************************/
 
-DefaultOutput::DefaultOutput(const Function f, const Entity e, const AttributeRange* attrRange)
-    : Output()
+DefaultOutput::DefaultOutput(const Function f, const Entity e, const AttributeRange* attrRange,
+                             const Sampling& sampling)
+    : Output(sampling)
     , m_func(f)
     , m_entity(e)
     , m_attrRange(attrRange)
 {
-    m_headerPrefix = QString("%1_%2_%3_")
+    m_headerPrefix = QString("%1_%2_%3")
             .arg(stringFromFunc(m_func))
             .arg((m_entity == E_Nodes ? "nodes" : "edges"))
             .arg(m_attrRange->attrName());
+    // the scalar functions have a single, empty, input
+    if (!isScalar(m_func)) {
+        m_headerPrefix += "_";
+    }
+}
+
+bool DefaultOutput::isSupported(Function f, const AttributeRange* attrRange)
+{
+    if (f == F_Invalid || !attrRange || !attrRange->isValid()) {
+        return false;
+    } else if (f == F_Count) {
+        return true;
+    }
+    switch (attrRange->type()) {
+    case AttributeRange::Double_Range:
+    case AttributeRange::Int_Range:
+    case AttributeRange::Double_Set:
+    case AttributeRange::Int_Set:
+    case AttributeRange::Bool:
+        return true;
+    default:
+        return false;
+    }
 }
 
-void DefaultOutput::doOperation(const int trialId, const AbstractModel* model)
+Value DefaultOutput::validateInput(Function f, const AttributeRange* attrRange, const QString& input)
 {
-    if (m_allTrialIds.find(trialId) == m_allTrialIds.end()) {
+    if (!isSupported(f, attrRange)) {
+        return Value();
+    } else if (f == F_Count) {
+        return attrRange->validate(input);
+    } else if (isScalar(f)) {
+        return input.isEmpty() ? Value("") : Value();
+    }
+
+    bool ok;
+    const double d = input.toDouble(&ok);
+    if (!ok || (f == F_Quantile && (d < 0.0 || d > 1.0))) {
+        return Value();
+    }
+    return Value(d);
+}
+
+void DefaultOutput::doOperation(const int trialId, const AbstractModel* model, const bool isFinal)
+{
+    if (m_allTrialIds.find(trialId) == m_allTrialIds.end()
+            || !isDue(model->currStep(), isFinal)) {
         return;
     }
 
+    if (m_func == F_Count) {
+        updateCaches(trialId, model->currStep(), count(model->graph()), isFinal);
+        return;
+    }
+
+    std::vector<double> binEdges, probs;
+    requirements(binEdges, probs);
+    Summary summary(binEdges, probs);
+    summarize(model->graph(), m_entity, m_attrRange->id(), summary);
+    updateCaches(trialId, model->currStep(), reduce(summary), isFinal);
+}
+
+void DefaultOutput::doOperation(const int trialId, const AbstractModel* model, const bool isFinal,
+                                const Summary& summary)
+{
+    if (m_allTrialIds.find(trialId) == m_allTrialIds.end()
+            || !isDue(model->currStep(), isFinal)) {
+        return;
+    }
+    updateCaches(trialId, model->currStep(),
+                 m_func == F_Count ? count(model->graph()) : reduce(summary), isFinal);
+}
+
+void DefaultOutput::requirements(std::vector<double>& binEdges, std::vector<double>& probs) const
+{
+    for (const Value& input : m_allInputs) {
+        if (m_func == F_Hist) {
+            binEdges.emplace_back(input.toDouble());
+        } else if (m_func == F_Quantile) {
+            probs.emplace_back(input.toDouble());
+        }
+    }
+}
+
+Values DefaultOutput::count(AbstractGraph* graph) const
+{
+    // The histogram of the attribute is enabled at the first step of
+    // each trial and kept up to date by the graph, so that counting
+    // does not need to scan the nodes/edges at every step.
+    const int attrId = m_attrRange->id();
+    const AttrHistograms* hists;
+    if (m_entity == E_Nodes) {
+        if (!graph->nodeColumns().hasHistogram(attrId)) {
+            graph->nodeColumns().setHistogramEnabled(attrId, true);
+        }
+        hists = &graph->nodeColumns().histograms();
+    } else {
+        if (!graph->edgeHistograms().isTracked(attrId)) {
+            graph->setEdgeHistogramEnabled(attrId, true);
+        }
+        hists = &graph->edgeHistograms();
+    }
+
+    Values allValues;
+    allValues.reserve(m_allInputs.size());
+    for (const Value& input : m_allInputs) {
+        allValues.emplace_back(hists->count(attrId, input));
+    }
+    return allValues;
+}
+
+Values DefaultOutput::reduce(const Summary& summary) const
+{
     Values allValues;
     switch (m_func) {
-    case F_Count:
-        if (m_entity == E_Nodes) {
-            allValues = Stats::count(model->graph()->nodes(), m_attrRange->id(), m_allInputs);
-        } else {
-            allValues = Stats::count(model->graph()->edges(), m_attrRange->id(), m_allInputs);
+    case F_Sum: allValues.emplace_back(summary.sum()); break;
+    case F_Mean: allValues.emplace_back(summary.mean()); break;
+    case F_Var: allValues.emplace_back(summary.variance()); break;
+    case F_Min: allValues.emplace_back(summary.min()); break;
+    case F_Max: allValues.emplace_back(summary.max()); break;
+    case F_Hist:
+        // the inputs are sorted, i.e., they are the edges of the bins in
+        // ascending order, which might be a subset of the summary's edges
+        for (size_t i = 0; i < m_allInputs.size(); ++i) {
+            const double upper = i + 1 < m_allInputs.size()
+                    ? m_allInputs[i + 1].toDouble() : std::numeric_limits<double>::infinity();
+            allValues.emplace_back(summary.binCount(m_allInputs[i].toDouble(), upper));
+        }
+        break;
+    case F_Quantile:
+        for (const Value& input : m_allInputs) {
+            allValues.emplace_back(summary.quantileOf(input.toDouble()));
         }
         break;
     default:
         qFatal("invalid function!");
         break;
     }
-    updateCaches(trialId, model->currStep(), allValues);
+    return allValues;
+}
+
+void DefaultOutput::summarize(const AbstractGraph* graph, Entity e, int attrId, Summary& summary)
+{
+    if (e == E_Nodes) {
+        // scans the attribute's column directly
+        const AttributeColumns& columns = graph->nodeColumns();
+        const int n = columns.numRows();
+        switch (columns.type(attrId)) {
+        case Value::BOOL: summary.add(columns.data<bool>(attrId), columns.data<bool>(attrId) + n); break;
+        case Value::CHAR: summary.add(columns.data<char>(attrId), columns.data<char>(attrId) + n); break;
+        case Value::INT: summary.add(columns.data<int>(attrId), columns.data<int>(attrId) + n); break;
+        case Value::DOUBLE: summary.add(columns.data<double>(attrId), columns.data<double>(attrId) + n); break;
+        default:
+            qFatal("the attribute must be numeric!");
+        }
+        return;
+    }
+
+    for (auto const& p : graph->edges()) {
+        if (!p.second->attrs()) {
+            continue;
+        }
+        const Value& v = p.second->attr(attrId);
+        switch (v.type()) {
+        case Value::BOOL: summary.add(v.toBool()); break;
+        case Value::CHAR: summary.add(v.toChar()); break;
+        case Value::INT: summary.add(v.toInt()); break;
+        case Value::DOUBLE: summary.add(v.toDouble()); break;
+        default:
+            qFatal("the attribute must be numeric!");
+        }
+    }
 }
 
 bool DefaultOutput::operator==(const OutputPtr output) const
@@ -107,29 +269,32 @@ bool DefaultOutput::operator==(const OutputPtr output) const
     if (m_func != other->function()) return false;
     if (m_entity != other->entity()) return false;
     if (m_attrRange->id() != other->attrRange()->id()) return false;
+    if (m_sampling != other->sampling()) return false;
     return true;
 }
 
 /*******************************************************/
 /*******************************************************/
 
-CustomOutput::CustomOutput() : Output()
+CustomOutput::CustomOutput(const Sampling& sampling) : Output(sampling)
 {
     m_headerPrefix = "custom_";
 }
 
-void CustomOutput::doOperation(const int trialId, const AbstractModel* model)
+void CustomOutput::doOperation(const int trialId, const AbstractModel* model, const bool isFinal)
 {
-    if (m_allTrialIds.find(trialId) == m_allTrialIds.end()) {
+    if (m_allTrialIds.find(trialId) == m_allTrialIds.end()
+            || !isDue(model->currStep(), isFinal)) {
         return;
     }
-    updateCaches(trialId, model->currStep(), model->customOutputs(m_allInputs));
+    updateCaches(trialId, model->currStep(), model->customOutputs(m_allInputs), isFinal);
 }
 
 bool CustomOutput::operator==(const OutputPtr output) const
 {
     auto other = std::dynamic_pointer_cast<const CustomOutput>(output);
     if (!other) return false;
+    if (m_sampling != other->sampling()) return false;
     if (m_allInputs.size() != other->allInputs().size()) return false;
     for (size_t i = 0; i < m_allInputs.size(); ++i) {
         if (m_allInputs.at(i) != other->allInputs().at(i))
@@ -141,6 +306,90 @@ bool CustomOutput::operator==(const OutputPtr output) const
 /*******************************************************/
 /*******************************************************/
 
+void OutputPlanner::plan(const std::unordered_set<OutputPtr>& outputs)
+{
+    clear();
+    for (const OutputPtr& output : outputs) {
+        DefaultOutputPtr df = std::dynamic_pointer_cast<DefaultOutput>(output);
+        if (!df) {
+            m_others.emplace_back(output);
+            continue;
+        }
+
+        const int attrId = df->attrRange()->id();
+        auto it = std::find_if(m_groups.begin(), m_groups.end(), [&](const Group& g) {
+            return g.entity == df->entity() && g.attrId == attrId;
+        });
+        if (it == m_groups.end()) {
+            m_groups.push_back({df->entity(), attrId, {}});
+            it = m_groups.end() - 1;
+        }
+        it->outputs.emplace_back(df);
+    }
+}
+
+void OutputPlanner::clear()
+{
+    m_groups.clear();
+    m_others.clear();
+}
+
+int OutputPlanner::doOperation(const int trialId, const AbstractModel* model, const bool isFinal) const
+{
+    const int step = model->currStep();
+    int passes = 0;
+    for (const Group& group : m_groups) {
+        // the summary covers the requirements of all outputs in the group
+        // which are due at this step; if none is due, the group is skipped
+        bool needsSummary = false;
+        bool needsCount = false;
+        std::vector<double> binEdges, probs;
+        for (const DefaultOutputPtr& df : group.outputs) {
+            if (!df->isDue(step, isFinal)) {
+                continue;
+            }
+            needsSummary |= df->needsSummary();
+            needsCount |= !df->needsSummary();
+            df->requirements(binEdges, probs);
+        }
+        if (!needsSummary && !needsCount) {
+            continue;
+        }
+
+        std::sort(binEdges.begin(), binEdges.end());
+        binEdges.erase(std::unique(binEdges.begin(), binEdges.end()), binEdges.end());
+        std::sort(probs.begin(), probs.end());
+        probs.erase(std::unique(probs.begin(), probs.end()), probs.end());
+
+        Summary summary(binEdges, probs);
+        if (needsSummary) {
+            DefaultOutput::summarize(model->graph(), group.entity, group.attrId, summary);
+            ++passes;
+        }
+        if (needsCount && group.entity == DefaultOutput::E_Nodes) {
+            // enabling or rebuilding a histogram costs a pass too
+            const AttributeColumns& columns = model->graph()->nodeColumns();
+            if (!columns.hasHistogram(group.attrId) || columns.isHistogramStale(group.attrId)) {
+                ++passes;
+            }
+        } else if (needsCount && !model->graph()->edgeHistograms().isTracked(group.attrId)) {
+            ++passes;
+        }
+
+        for (const DefaultOutputPtr& df : group.outputs) {
+            df->doOperation(trialId, model, isFinal, summary);
+        }
+    }
+
+    for (const OutputPtr& output : m_others) {
+        output->doOperation(trialId, model, isFinal);
+    }
+    return passes;
+}
+
+/*******************************************************/
+/*******************************************************/
+
 Output::~Output()
 {
     for (Cache* c :  m_caches) {
@@ -188,54 +437,85 @@ void Output::updateListOfInputs()
             m_allTrialIds.insert(it.first);
         }
     }
-    // remove duplicates
-    std::sort(m_allInputs.begin(), m_allInputs.end());
+    // remove duplicates; strings can't be compared with operator<
+    std::sort(m_allInputs.begin(), m_allInputs.end(), [](const Value& a, const Value& b) {
+        if (a.type() == Value::STRING && b.type() == Value::STRING) {
+            return std::strcmp(a.toString(), b.toString()) < 0;
+        }
+        return a < b;
+    });
     m_allInputs.erase(std::unique(m_allInputs.begin(), m_allInputs.end()), m_allInputs.end());
+
+    for (Cache* cache : m_caches) {
+        cache->m_inputCols.clear();
+        for (const Value& input : cache->m_inputs) {
+            cache->m_inputCols.emplace_back(
+                std::find(m_allInputs.begin(), m_allInputs.end(), input) - m_allInputs.begin());
+        }
+    }
 }
 
-void Output::updateCaches(const int trialId, const int currStep, const Values& allValues)
+void Output::updateCaches(const int trialId, const int currStep, const Values& allValues, const bool isFinal)
 {
     if (m_caches.size() == 0) {
         return;
     }
 
     for (Cache* cache : m_caches) {
-        std::unordered_map<int, Cache::Data>::iterator itData = cache->m_trials.find(trialId);
-        if (itData == cache->m_trials.end()) {
+        std::unordered_map<int, RowRing>::iterator itRing = cache->m_trials.find(trialId);
+        if (itRing == cache->m_trials.end()) {
             continue;
         }
-
-        Cache::Data& data = itData->second;
-        Cache::Row newRow;
-        newRow.first = currStep;
-        newRow.second.reserve(cache->m_inputs.size());
-
-        for (Value input : cache->m_inputs) {
-            int col = std::find(m_allInputs.begin(), m_allInputs.end(), input) - m_allInputs.begin();
-            newRow.second.emplace_back(allValues.at(col));
+        const std::vector<int>& cols = cache->m_inputCols;
+
+        if (m_sampling.mode() == Sampling::OnChange) {
+            // run-length encoding: a row is added only when any of its values
+            // changes, and at the last step to close the current run
+            Values& last = cache->m_lastValues.at(trialId);
+            bool changed = last.size() != cols.size();
+            for (size_t col = 0; !changed && col < cols.size(); ++col) {
+                const Value& v = allValues.at(cols[col]);
+                changed = !(v == last[col] || (v.isDouble() && last[col].isDouble()
+                            && std::isnan(v.toDouble()) && std::isnan(last[col].toDouble())));
+            }
+            if (!changed && !isFinal) {
+                continue;
+            }
+            last.resize(cols.size());
+            for (size_t col = 0; col < cols.size(); ++col) {
+                last[col] = allValues.at(cols[col]);
+            }
         }
-        if (data.rows.empty()) data.last = data.rows.before_begin();
-        data.last = data.rows.emplace_after(data.last, newRow);
+
+        itRing->second.push(currStep, [&](int col) { return allValues.at(cols[col]); });
     }
 }
 
 QString Output::printableHeader(const char sep, const bool joinInputs) const
 {
-    return printableHeader(m_headerPrefix, m_allInputs, sep, joinInputs);
+    return printableHeader(m_headerPrefix, m_allInputs, sep, joinInputs, m_sampling);
 }
 
 QString Output::printableHeader(const QString& prefix, const Values& inputs,
-                                const char sep, const bool joinInputs)
+                                const char sep, const bool joinInputs,
+                                const Sampling& sampling)
 {
+    QString suffix = sampling.toString();
+    if (!suffix.isEmpty()) {
+        suffix.prepend('@');
+    }
+
     QString ret;
     if (joinInputs) {
         ret = prefix;
         for (Value val : inputs) {
             ret += val.toQString() + sep;
         }
+        ret.chop(1);
+        ret += suffix + sep;
     } else {
         for (Value val : inputs) {
-            ret += prefix + val.toQString() + sep;
+            ret += prefix + val.toQString() + suffix + sep;
         }
     }
     ret.chop(1);
@@ -246,8 +526,24 @@ std::vector<Cache*> Output::parseHeader(const QStringList& header, const std::ve
                                         const ModelPlugin* model, QString& errorMsg)
 {
     std::vector<Cache*> caches;
-    std::vector<Value> customHeader;
+    // custom outputs are grouped by sampling
+    std::vector<std::pair<Sampling, Values>> customHeaders;
     for (QString h : header) {
+        // eg., 'mean_nodes_score@every100'
+        Sampling sampling;
+        const int samplingPos = h.lastIndexOf('@');
+        if (samplingPos >= 0) {
+            bool ok;
+            sampling = Sampling::fromString(h.mid(samplingPos + 1), &ok);
+            if (!ok) {
+                errorMsg = QString("invalid header! Sampling is invalid. (%1)\n").arg(h);
+                qWarning() << errorMsg;
+                Utils::deleteAndShrink(caches);
+                return caches;
+            }
+            h.truncate(samplingPos);
+        }
+
         if (h.startsWith("custom_")) {
             h.remove("custom_");
             if (h.isEmpty()) {
@@ -256,15 +552,25 @@ std::vector<Cache*> Output::parseHeader(const QStringList& header, const std::ve
                 Utils::deleteAndShrink(caches);
                 return caches;
             }
-            customHeader.emplace_back(h);
+            auto it = std::find_if(customHeaders.begin(), customHeaders.end(),
+                [&sampling](const std::pair<Sampling, Values>& c) { return c.first == sampling; });
+            if (it == customHeaders.end()) {
+                customHeaders.push_back({sampling, Values()});
+                it = customHeaders.end() - 1;
+            }
+            it->second.emplace_back(h);
             continue;
         }
 
-        DefaultOutput::Function func;
-        if (h.startsWith("count_")) {
-            h.remove("count_");
-            func = DefaultOutput::F_Count;
-        } else {
+        DefaultOutput::Function func = DefaultOutput::F_Invalid;
+        for (const QString& funcStr : DefaultOutput::availableFunctions()) {
+            if (h.startsWith(funcStr + "_")) {
+                h.remove(0, funcStr.size() + 1);
+                func = DefaultOutput::funcFromString(funcStr);
+                break;
+            }
+        }
+        if (func == DefaultOutput::F_Invalid) {
             errorMsg = QString("invalid header! Function does not exist. (%1)\n").arg(h);
             qWarning() << errorMsg;
             Utils::deleteAndShrink(caches);
@@ -290,17 +596,32 @@ std::vector<Cache*> Output::parseHeader(const QStringList& header, const std::ve
 
         QStringList attrHeaderStr = h.split("_");
         AttributeRange* attrRange = entityAttrsScope.value(attrHeaderStr.first());
-        if (!attrRange->isValid()) {
+        if (!attrRange || !attrRange->isValid()) {
             errorMsg = QString("invalid header! Attribute does not exist. (%1)\n").arg(h);
             qWarning() << errorMsg;
             Utils::deleteAndShrink(caches);
             return caches;
+        } else if (!DefaultOutput::isSupported(func, attrRange)) {
+            errorMsg = QString("invalid header! The function requires a numeric attribute. (%1)\n").arg(h);
+            qWarning() << errorMsg;
+            Utils::deleteAndShrink(caches);
+            return caches;
         }
 
         std::vector<Value> attrHeader; //inputs
         attrHeaderStr.removeFirst();
+        if (DefaultOutput::isScalar(func)) {
+            // eg., 'mean_nodes_score'
+            if (!attrHeaderStr.isEmpty()) {
+                errorMsg = QString("invalid header! The function takes no inputs. (%1)\n").arg(h);
+                qWarning() << errorMsg;
+                Utils::deleteAndShrink(caches);
+                return caches;
+            }
+            attrHeaderStr << QString();
+        }
         for (QString valStr : attrHeaderStr) {
-            Value val = attrRange->validate(valStr);
+            Value val = DefaultOutput::validateInput(func, attrRange, valStr);
             if (!val.isValid()) {
                 errorMsg = QString("invalid header! Value of attribute is invalid. (%1)\n").arg(valStr);
                 qWarning() << errorMsg;
@@ -317,13 +638,13 @@ std::vector<Cache*> Output::parseHeader(const QStringList& header, const std::ve
             return caches;
         }
 
-        OutputPtr output = std::make_shared<DefaultOutput>(func, entity, attrRange);
+        OutputPtr output = std::make_shared<DefaultOutput>(func, entity, attrRange, sampling);
         caches.emplace_back(output->addCache(attrHeader, trialIds));
     }
 
-    if (!customHeader.empty()) {
-        OutputPtr output = std::make_shared<CustomOutput>();
-        caches.emplace_back(output->addCache(customHeader, trialIds));
+    for (const auto& custom : customHeaders) {
+        OutputPtr output = std::make_shared<CustomOutput>(custom.first);
+        caches.emplace_back(output->addCache(custom.second, trialIds));
     }
 
     return caches;
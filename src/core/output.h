@@ -21,16 +21,18 @@
 #ifndef OUTPUT_H
 #define OUTPUT_H
 
-#include <forward_list>
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "abstractmodel.h"
 #include "attributes.h"
 #include "attributerange.h"
 #include "modelplugin.h"
+#include "rowring.h"
+#include "sampling.h"
 #include "stats.h"
 
 namespace evoplex
@@ -44,11 +46,19 @@ typedef std::shared_ptr<Output> OutputPtr;
 typedef std::shared_ptr<CustomOutput> CustomOutputPtr;
 typedef std::shared_ptr<DefaultOutput> DefaultOutputPtr;
 
+/**
+ *  @brief The rows of an output (i.e., one column per input) for each trial.
+ *
+ *  The rows of each trial are kept in a RowRing, so the experiment's thread
+ *  can add rows while another thread (e.g., the GUI) reads them.
+ *  Depending on the sampling of the output, there might not be a row for
+ *  every step.
+ */
 class Cache
 {
     friend class Output;
 public:
-    typedef std::pair<int, Values> Row; // <rowNumber, values>
+    typedef RowRing::Row Row; // step and values
 
     bool isEmpty(const int trialId) const;
 
@@ -58,19 +68,16 @@ public:
 
     inline OutputPtr output() const { return m_parent; }
     inline const Values& inputs() const { return m_inputs; }
-    inline const Row& readFrontRow(const int trialId) const { return m_trials.at(trialId).rows.front(); }
-    inline void flushFrontRow(const int trialId) { m_trials.at(trialId).rows.pop_front(); }
+    inline Row readFrontRow(const int trialId) const { return m_trials.at(trialId).front(); }
+    inline void flushFrontRow(const int trialId) { m_trials.at(trialId).pop(); }
     void flushAll();
 
 private:
-    struct Data {
-        std::forward_list<Row> rows;
-        std::forward_list<Row>::const_iterator last;
-    };
-
     OutputPtr m_parent;
     Values m_inputs; // columns
-    std::unordered_map<int, Data> m_trials;
+    std::vector<int> m_inputCols; // input -> column in the parent's allInputs()
+    std::unordered_map<int, RowRing> m_trials;
+    std::unordered_map<int, Values> m_lastValues; // last row of each trial; for Sampling::OnChange
 
     // let's keep it private to ensure that only Output can create a Cache
     explicit Cache(Values inputs, std::vector<int> trialIds, OutputPtr parent);
@@ -83,15 +90,19 @@ public:
         const std::vector<int> trialIds, const ModelPlugin* model, QString& errorMsg);
 
     static QString printableHeader(const QString& prefix, const Values& inputs,
-                                   const char sep, const bool joinInputs);
+                                   const char sep, const bool joinInputs,
+                                   const Sampling& sampling = Sampling());
 
     virtual ~Output();
 
-    virtual void doOperation(const int trialId, const AbstractModel* model) = 0;
+    // Evaluates the output at the current step of the model, if it is due.
+    // 'isFinal' must be true at the last step of the trial.
+    virtual void doOperation(const int trialId, const AbstractModel* model, const bool isFinal) = 0;
 
     // Printable header with all columns of this operation separated by 'sep'.
     // If joinInputs is enabled: eg: func_attr_input1[sep]input2
     // If joinInputs is disabled: eg: func_attr_input1[sep]func_attr_input2
+    // A non-default sampling is appended to each column, eg: func_attr_input1@every10
     QString printableHeader(const char sep, const bool joinInputs) const;
 
     // Format for CustomOutput: "custom_nameDefinedInTheModel"
@@ -113,15 +124,20 @@ public:
     inline bool isEmpty() const { return m_caches.empty(); }
     inline const Values& allInputs() const { return m_allInputs; }
     inline const std::set<int>& trialIds() const { return m_allTrialIds; }
+    inline const Sampling& sampling() const { return m_sampling; }
+    inline bool isDue(const int step, const bool isFinal) const { return m_sampling.isDue(step, isFinal); }
 
 protected:
+    const Sampling m_sampling;
     QString m_headerPrefix;
     std::vector<Cache*> m_caches; // child caches
     std::set<int> m_allTrialIds;  // convenient to handle 'doOperation' requests
     Values m_allInputs;
 
+    explicit Output(const Sampling& sampling) : m_sampling(sampling) {}
+
     // auxiliar method for 'doOperation()'
-    void updateCaches(const int trialId, const int currStep, const Values& allValues);
+    void updateCaches(const int trialId, const int currStep, const Values& allValues, const bool isFinal);
 
 private:
     // auxiliar method to update the vector with all the current inputs
@@ -132,9 +148,9 @@ private:
 class CustomOutput: public Output
 {
 public:
-    explicit CustomOutput();
+    explicit CustomOutput(const Sampling& sampling = Sampling());
 
-    virtual void doOperation(const int trialId, const AbstractModel* model);
+    virtual void doOperation(const int trialId, const AbstractModel* model, const bool isFinal);
 
     virtual bool operator==(const OutputPtr output) const;
 };
@@ -148,25 +164,78 @@ public:
         E_Edges
     };
 
+    // count: number of entities holding each input value
+    // sum, mean, var, min, max: a single number, i.e., no inputs
+    // hist: number of entities in each bin; the inputs are the lower bounds of the bins
+    // quantile: streaming estimate of the quantiles; the inputs are the probabilities
     enum Function {
         F_Invalid,
-        F_Count
+        F_Count,
+        F_Sum,
+        F_Mean,
+        F_Var,
+        F_Min,
+        F_Max,
+        F_Hist,
+        F_Quantile
     };
     static std::vector<QString> availableFunctions() {
-        return {"count"};
+        return {"count", "sum", "mean", "var", "min", "max", "hist", "quantile"};
     }
     static Function funcFromString(QString f) {
         if (f == "count") return F_Count;
+        if (f == "sum") return F_Sum;
+        if (f == "mean") return F_Mean;
+        if (f == "var") return F_Var;
+        if (f == "min") return F_Min;
+        if (f == "max") return F_Max;
+        if (f == "hist") return F_Hist;
+        if (f == "quantile") return F_Quantile;
         return F_Invalid;
     }
     static QString stringFromFunc(Function f) {
-        if (f == F_Count) return "count";
-        return "invalid";
+        switch (f) {
+        case F_Count: return "count";
+        case F_Sum: return "sum";
+        case F_Mean: return "mean";
+        case F_Var: return "var";
+        case F_Min: return "min";
+        case F_Max: return "max";
+        case F_Hist: return "hist";
+        case F_Quantile: return "quantile";
+        default: return "invalid";
+        }
     }
-
-    explicit DefaultOutput(const Function f, const Entity e, const AttributeRange* attrRange);
-
-    virtual void doOperation(const int trialId, const AbstractModel* model);
+    // true if the function yields a single number, e.g., 'mean_nodes_score'
+    static bool isScalar(Function f) {
+        return f == F_Sum || f == F_Mean || f == F_Var || f == F_Min || f == F_Max;
+    }
+    // true if the attribute can be reduced by the function
+    static bool isSupported(Function f, const AttributeRange* attrRange);
+    // Validates an input of the function. The inputs of 'count' are values
+    // of the attribute; 'hist' takes bin edges and 'quantile' takes
+    // probabilities in [0,1]. The scalar functions take an empty input.
+    // Returns an invalid Value if the input is not valid.
+    static Value validateInput(Function f, const AttributeRange* attrRange, const QString& input);
+
+    explicit DefaultOutput(const Function f, const Entity e, const AttributeRange* attrRange,
+                           const Sampling& sampling = Sampling());
+
+    // reduces the attribute in a single pass over the nodes/edges
+    static void summarize(const AbstractGraph* graph, Entity e, int attrId, Summary& summary);
+
+    virtual void doOperation(const int trialId, const AbstractModel* model, const bool isFinal);
+    // Same as above, but takes a summary of the attribute which may be
+    // shared with other outputs, i.e., it does not traverse the graph.
+    // The summary must include the requirements() of this output.
+    void doOperation(const int trialId, const AbstractModel* model, const bool isFinal,
+                     const Summary& summary);
+
+    // true if the function reduces the values, i.e., all but count,
+    // which reads the histograms of the graph instead
+    inline bool needsSummary() const { return m_func != F_Count; }
+    // adds the bin edges and probabilities needed by this output
+    void requirements(std::vector<double>& binEdges, std::vector<double>& probs) const;
 
     virtual bool operator==(const OutputPtr output) const;
 
@@ -179,6 +248,46 @@ private:
     const Function m_func;
     const Entity m_entity;
     const AttributeRange* m_attrRange;
+
+    Values count(AbstractGraph* graph) const;
+    Values reduce(const Summary& summary) const;
+};
+
+/**
+ *  @brief Evaluates the outputs of an experiment at every step.
+ *
+ *  The default outputs are grouped by entity and attribute, so that all
+ *  the reductions of an attribute (e.g., mean, var and quantiles) share a
+ *  single pass over its values, which for nodes is a scan of the
+ *  attribute's column. Counts do not need a pass at all, as they read the
+ *  graph's histograms, unless the histogram has to be rebuilt.
+ *  Outputs that are not due at a step (see Sampling) are skipped, and so
+ *  is the pass over a group if none of its outputs is due.
+ */
+class OutputPlanner
+{
+public:
+    // Groups the outputs. It must be called whenever the set of outputs
+    // changes, but not while the experiment is running.
+    void plan(const std::unordered_set<OutputPtr>& outputs);
+    void clear();
+
+    // Evaluates all the outputs that are due at the current step of a trial.
+    // 'isFinal' must be true at the last step of the trial.
+    // Returns the number of passes over the nodes/edges.
+    int doOperation(const int trialId, const AbstractModel* model, const bool isFinal) const;
+
+    inline int numGroups() const { return static_cast<int>(m_groups.size()); }
+
+private:
+    struct Group {
+        DefaultOutput::Entity entity;
+        int attrId;
+        std::vector<DefaultOutputPtr> outputs;
+    };
+
+    std::vector<Group> m_groups;
+    std::vector<OutputPtr> m_others; // e.g., custom outputs
 };
 
 }
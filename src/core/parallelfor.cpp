@@ -0,0 +1,123 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QMutex>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "parallelfor.h"
+
+namespace evoplex {
+
+QThreadPool* ParallelFor::s_threadPool = nullptr;
+
+namespace {
+
+struct Loop
+{
+    Loop(int size, int blockSize, const std::function<void(int, int)>& fn)
+        : size(size), blockSize(blockSize), fn(fn), nextBlock(0), helpers(0),
+          numBlocks((size + blockSize - 1) / blockSize) {}
+
+    const int size;
+    const int blockSize;
+    const std::function<void(int, int)>& fn;
+    std::atomic<int> nextBlock;
+    int helpers; // guarded by 'mutex'
+    QMutex mutex;
+    QWaitCondition done;
+    const int numBlocks;
+
+    void work() {
+        int block = nextBlock.fetch_add(1);
+        while (block < numBlocks) {
+            const int begin = block * blockSize;
+            fn(begin, std::min(begin + blockSize, size));
+            block = nextBlock.fetch_add(1);
+        }
+    }
+};
+
+class LoopHelper : public QRunnable
+{
+public:
+    explicit LoopHelper(const std::shared_ptr<Loop>& loop) : m_loop(loop) {}
+
+    void run() override {
+        m_loop->work();
+        QMutexLocker locker(&m_loop->mutex);
+        if (--m_loop->helpers == 0) {
+            m_loop->done.wakeAll();
+        }
+    }
+
+private:
+    // shared, as the caller may return before the helper releases the mutex
+    std::shared_ptr<Loop> m_loop;
+};
+
+} // namespace
+
+void ParallelFor::setThreadPool(QThreadPool* pool)
+{
+    s_threadPool = pool;
+}
+
+void ParallelFor::run(int size, const std::function<void(int, int)>& fn, int blockSize)
+{
+    if (size <= 0) {
+        return;
+    } else if (size <= blockSize) {
+        fn(0, size);
+        return;
+    }
+
+    std::shared_ptr<Loop> loop = std::make_shared<Loop>(size, blockSize, fn);
+
+    // borrow as many idle threads as useful; the others are left to the pool
+    QThreadPool* pool = s_threadPool ? s_threadPool : QThreadPool::globalInstance();
+    for (int i = 1; i < loop->numBlocks; ++i) {
+        LoopHelper* helper = new LoopHelper(loop);
+        loop->mutex.lock();
+        ++loop->helpers;
+        loop->mutex.unlock();
+        if (!pool->tryStart(helper)) {
+            delete helper;
+            loop->mutex.lock();
+            --loop->helpers;
+            loop->mutex.unlock();
+            break;
+        }
+    }
+
+    loop->work();
+
+    // the helpers may still be running their last block
+    QMutexLocker locker(&loop->mutex);
+    while (loop->helpers > 0) {
+        loop->done.wait(&loop->mutex);
+    }
+}
+
+} // evoplex
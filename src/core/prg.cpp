@@ -2,7 +2,7 @@
  *  This file is part of Evoplex.
  *
  *  Evoplex is a multi-agent system for networks.
- *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -24,34 +24,142 @@ namespace evoplex
 {
 
 PRG::PRG(unsigned int seed)
-    : m_mteng(seed)
-    , m_doubleZeroOne(0.,1.)
-    , m_floatZeroOne(0.f,1.f)
+    : m_key({{ seed, 0 }})
+    , m_counter(0)
+    , m_buf({{ 0, 0, 0, 0 }})
+    , m_idx(4)
 {
 }
 
-double PRG::randD(double min, double max)
+PRG PRG::split(std::uint64_t streamId) const
 {
-    std::uniform_real_distribution<double> dis(min, max);
-    return dis(m_mteng);
+    // the child key is a Philox block of the streamId; the last word
+    // keeps it apart from the counters used to draw numbers
+    const Philox4x32::Counter k = Philox4x32::generate(
+            {{ static_cast<std::uint32_t>(streamId),
+               static_cast<std::uint32_t>(streamId >> 32), 0, 0x53504C54 }}, m_key);
+    PRG child(0);
+    child.m_key = {{ k[0], k[1] }};
+    return child;
 }
 
-float PRG::randF(float min, float max)
+void PRG::jump(std::uint64_t n)
 {
-    std::uniform_real_distribution<float> dis(min, max);
-    return dis(m_mteng);
+    const std::uint64_t pos = 4 * m_counter + m_idx - 4 + n;
+    m_counter = pos / 4;
+    m_idx = 4;
+    const int skip = static_cast<int>(pos % 4);
+    if (skip) {
+        refill();
+        m_idx = skip;
+    }
 }
 
-int PRG::randI(int min, int max)
+size_t PRG::randS(size_t min, size_t max)
 {
-    std::uniform_int_distribution<int> dis(min, max);
-    return dis(m_mteng);
+    const std::uint64_t range = std::uint64_t(max) - std::uint64_t(min);
+    if (range < 0xFFFFFFFF) {
+        return min + bounded(static_cast<std::uint32_t>(range + 1));
+    }
+    // wider ranges are rare; use a bitmask with rejection
+    std::uint64_t mask = range;
+    mask |= mask >> 1; mask |= mask >> 2; mask |= mask >> 4;
+    mask |= mask >> 8; mask |= mask >> 16; mask |= mask >> 32;
+    std::uint64_t x;
+    do {
+        x = ((std::uint64_t((*this)()) << 32) | (*this)()) & mask;
+    } while (x > range);
+    return min + static_cast<size_t>(x);
 }
 
-size_t PRG::randS(size_t min, size_t max)
+void PRG::fill(std::uint32_t* out, size_t n)
+{
+    while (n && m_idx != 4) {
+        *out++ = (*this)();
+        --n;
+    }
+
+    // the blocks are independent from each other, so the
+    // compiler is free to unroll and vectorize this loop
+    const size_t numBlocks = n / 4;
+    for (size_t b = 0; b < numBlocks; ++b) {
+        const Philox4x32::Counter r = block(m_counter + b);
+        out[4*b] = r[0];
+        out[4*b+1] = r[1];
+        out[4*b+2] = r[2];
+        out[4*b+3] = r[3];
+    }
+    m_counter += numBlocks;
+
+    for (size_t i = 4 * numBlocks; i < n; ++i) {
+        out[i] = (*this)();
+    }
+}
+
+void PRG::fillD(double* out, size_t n)
+{
+    // align with the blocks, i.e., each block makes two doubles;
+    // if an odd number of 32-bit numbers was drawn, it never aligns
+    while (n && m_idx != 4) {
+        *out++ = randD();
+        --n;
+    }
+
+    if (m_idx == 4) {
+        const double k = 1.0 / 9007199254740992.0;
+        const size_t numBlocks = n / 2;
+        for (size_t b = 0; b < numBlocks; ++b) {
+            const Philox4x32::Counter r = block(m_counter + b);
+            out[2*b] = ((((std::uint64_t)r[0] << 32) | r[1]) >> 11) * k;
+            out[2*b+1] = ((((std::uint64_t)r[2] << 32) | r[3]) >> 11) * k;
+        }
+        m_counter += numBlocks;
+        out += 2 * numBlocks;
+        n -= 2 * numBlocks;
+    }
+
+    // tail
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = randD();
+    }
+}
+
+void PRG::fillI(int* out, size_t n, int min, int max)
+{
+    IntSampler(min, max).fill(*this, out, n);
+}
+
+/************************************************************************/
+
+IntSampler::IntSampler(int min, int max)
+    : m_min(min),
+      m_max(max),
+      m_range(static_cast<std::uint32_t>(max) - static_cast<std::uint32_t>(min) + 1),
+      m_threshold(m_range ? (0u - m_range) % m_range : 0)
+{
+}
+
+void IntSampler::fill(PRG& prg, int* out, size_t n) const
+{
+    // draw the raw bits in bulk and map them in place;
+    // the rare rejected ones are drawn again one by one
+    std::uint32_t* bits = reinterpret_cast<std::uint32_t*>(out);
+    prg.fill(bits, n);
+    for (size_t i = 0; i < n; ++i) {
+        if (!map(bits[i], out[i])) {
+            out[i] = (*this)(prg);
+        }
+    }
+}
+
+/************************************************************************/
+
+void RealSampler::fill(PRG& prg, double* out, size_t n) const
 {
-    std::uniform_int_distribution<size_t> dis(min, max);
-    return dis(m_mteng);
+    prg.fillD(out, n);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = m_min + out[i] * m_scale;
+    }
 }
 
 } // evoplex
@@ -0,0 +1,74 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rowring.h"
+
+namespace evoplex {
+
+RowRing::RowRing(int numCols, int segmentSize)
+    : m_numCols(numCols),
+      m_segmentSize(segmentSize),
+      m_spare(nullptr)
+{
+    Q_ASSERT_X(segmentSize > 0, "RowRing", "the segments must hold at least one row");
+    m_head = m_tail = new Segment(m_numCols, m_segmentSize);
+}
+
+RowRing::~RowRing()
+{
+    Segment* seg = m_head;
+    while (seg) {
+        Segment* next = seg->next.load(std::memory_order_relaxed);
+        delete seg;
+        seg = next;
+    }
+    delete m_spare.load(std::memory_order_relaxed);
+}
+
+void RowRing::clear()
+{
+    while (m_head != m_tail) {
+        Segment* next = m_head->next.load(std::memory_order_relaxed);
+        recycle(m_head);
+        m_head = next;
+    }
+    m_head->written.store(0, std::memory_order_relaxed);
+    m_head->read = 0;
+}
+
+RowRing::Segment* RowRing::newSegment()
+{
+    Segment* seg = m_spare.exchange(nullptr, std::memory_order_acquire);
+    if (!seg) {
+        return new Segment(m_numCols, m_segmentSize);
+    }
+    seg->written.store(0, std::memory_order_relaxed);
+    seg->read = 0;
+    seg->next.store(nullptr, std::memory_order_relaxed);
+    return seg;
+}
+
+void RowRing::recycle(Segment* seg) const
+{
+    // keeps a single spare segment; the producer takes it when it needs one
+    delete m_spare.exchange(seg, std::memory_order_acq_rel);
+}
+
+} // evoplex
@@ -0,0 +1,95 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include "sampling.h"
+
+namespace evoplex {
+
+Sampling::Sampling(Mode mode, int n)
+    : m_mode(mode),
+      m_n(n)
+{
+    Q_ASSERT_X(n > 0, "Sampling", "the number of steps must be positive");
+    if (m_mode != EveryN && m_mode != LogSpaced) {
+        m_n = 1;
+    } else if (m_mode == EveryN && m_n == 1) {
+        m_mode = EveryStep;
+    }
+}
+
+Sampling Sampling::fromString(const QString& str, bool* ok)
+{
+    if (ok) *ok = true;
+    if (str.isEmpty()) {
+        return Sampling();
+    } else if (str == "final") {
+        return Sampling(Final);
+    } else if (str == "change") {
+        return Sampling(OnChange);
+    }
+
+    Mode mode;
+    QString nStr;
+    if (str.startsWith("every")) {
+        mode = EveryN;
+        nStr = str.mid(5);
+    } else if (str.startsWith("log")) {
+        mode = LogSpaced;
+        nStr = str.mid(3);
+    } else {
+        if (ok) *ok = false;
+        return Sampling();
+    }
+
+    bool isInt;
+    const int n = nStr.toInt(&isInt);
+    if (!isInt || n < 1) {
+        if (ok) *ok = false;
+        return Sampling();
+    }
+    return Sampling(mode, n);
+}
+
+QString Sampling::toString() const
+{
+    switch (m_mode) {
+    case EveryN: return QString("every%1").arg(m_n);
+    case LogSpaced: return QString("log%1").arg(m_n);
+    case Final: return "final";
+    case OnChange: return "change";
+    default: return "";
+    }
+}
+
+bool Sampling::isLogDue(const int step) const
+{
+    // the first step in each of the N intervals per decade, that is,
+    // floor(N*log10(step)) is incremented at this step
+    if (step <= 1) {
+        return true;
+    }
+    const double eps = 1e-9; // log10(10^k) might not be exact
+    return std::floor(m_n * std::log10(static_cast<double>(step)) + eps)
+            > std::floor(m_n * std::log10(static_cast<double>(step - 1)) + eps);
+}
+
+} // evoplex
@@ -0,0 +1,187 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "stats.h"
+
+namespace evoplex {
+
+P2Quantile::P2Quantile(double p)
+    : m_p(p),
+      m_n(0)
+{
+    Q_ASSERT_X(p >= 0.0 && p <= 1.0, "P2Quantile", "the probability must be in [0,1]");
+    for (int i = 0; i < 5; ++i) {
+        m_q[i] = 0.0;
+        m_pos[i] = i + 1;
+    }
+    m_np[0] = 1.0;
+    m_np[1] = 1.0 + 2.0 * p;
+    m_np[2] = 1.0 + 4.0 * p;
+    m_np[3] = 3.0 + 2.0 * p;
+    m_np[4] = 5.0;
+    m_dn[0] = 0.0;
+    m_dn[1] = p / 2.0;
+    m_dn[2] = p;
+    m_dn[3] = (1.0 + p) / 2.0;
+    m_dn[4] = 1.0;
+}
+
+void P2Quantile::add(double x)
+{
+    if (m_n < 5) {
+        m_q[m_n++] = x;
+        if (m_n == 5) {
+            std::sort(m_q, m_q + 5);
+        }
+        return;
+    }
+
+    // find the cell of x, updating the extreme markers if needed
+    int k;
+    if (x < m_q[0]) {
+        m_q[0] = x;
+        k = 0;
+    } else if (x >= m_q[4]) {
+        m_q[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= m_q[k + 1]) {
+            ++k;
+        }
+    }
+    ++m_n;
+
+    for (int i = k + 1; i < 5; ++i) {
+        ++m_pos[i];
+    }
+    for (int i = 0; i < 5; ++i) {
+        m_np[i] += m_dn[i];
+    }
+
+    // adjust the heights of the middle markers
+    for (int i = 1; i < 4; ++i) {
+        const double d = m_np[i] - m_pos[i];
+        if ((d >= 1.0 && m_pos[i + 1] - m_pos[i] > 1)
+                || (d <= -1.0 && m_pos[i - 1] - m_pos[i] < -1)) {
+            const int s = d >= 0.0 ? 1 : -1;
+            const double q = parabolic(i, s);
+            m_q[i] = (m_q[i - 1] < q && q < m_q[i + 1]) ? q : linear(i, s);
+            m_pos[i] += s;
+        }
+    }
+}
+
+double P2Quantile::value() const
+{
+    if (m_n == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    } else if (m_n >= 5) {
+        // the extreme markers are the exact min and max
+        return m_p == 0.0 ? m_q[0] : (m_p == 1.0 ? m_q[4] : m_q[2]);
+    }
+    // few values; take the exact quantile
+    double q[5];
+    std::copy(m_q, m_q + m_n, q);
+    std::sort(q, q + m_n);
+    return q[static_cast<int>(std::floor(m_p * (m_n - 1) + 0.5))];
+}
+
+double P2Quantile::parabolic(int i, int d) const
+{
+    return m_q[i] + d / static_cast<double>(m_pos[i + 1] - m_pos[i - 1])
+            * ((m_pos[i] - m_pos[i - 1] + d) * (m_q[i + 1] - m_q[i]) / (m_pos[i + 1] - m_pos[i])
+             + (m_pos[i + 1] - m_pos[i] - d) * (m_q[i] - m_q[i - 1]) / (m_pos[i] - m_pos[i - 1]));
+}
+
+double P2Quantile::linear(int i, int d) const
+{
+    return m_q[i] + d * (m_q[i + d] - m_q[i]) / (m_pos[i + d] - m_pos[i]);
+}
+
+/*******************************************************/
+/*******************************************************/
+
+Summary::Summary(const std::vector<double>& binEdges, const std::vector<double>& probs)
+    : m_n(0),
+      m_shift(0.0),
+      m_sum(0.0),
+      m_sumSq(0.0),
+      m_min(0.0),
+      m_max(0.0),
+      m_binEdges(binEdges),
+      m_bins(binEdges.size(), 0)
+{
+    Q_ASSERT_X(std::is_sorted(binEdges.begin(), binEdges.end()), "Summary",
+               "the edges of the bins must be in ascending order");
+    m_quantiles.reserve(probs.size());
+    for (double p : probs) {
+        m_quantiles.emplace_back(p);
+    }
+}
+
+double Summary::mean() const
+{
+    if (m_n == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return m_shift + m_sum / m_n;
+}
+
+double Summary::variance() const
+{
+    if (m_n == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double var = (m_sumSq - m_sum * m_sum / m_n) / m_n;
+    return var > 0.0 ? var : 0.0;
+}
+
+int Summary::binCount(double lower, double upper) const
+{
+    int count = 0;
+    for (size_t i = 0; i < m_binEdges.size(); ++i) {
+        if (m_binEdges[i] >= lower && m_binEdges[i] < upper) {
+            count += m_bins[i];
+        }
+    }
+    return count;
+}
+
+double Summary::quantileOf(double p) const
+{
+    for (const P2Quantile& q : m_quantiles) {
+        if (q.probability() == p) {
+            return q.value();
+        }
+    }
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+double Summary::min() const
+{ return m_n ? m_min : std::numeric_limits<double>::quiet_NaN(); }
+
+double Summary::max() const
+{ return m_n ? m_max : std::numeric_limits<double>::quiet_NaN(); }
+
+} // evoplex
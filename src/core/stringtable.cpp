@@ -0,0 +1,148 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QMutex>
+#include <atomic>
+#include <cstring>
+#include <unordered_map>
+
+#include "arena.h"
+#include "stringtable.h"
+
+namespace evoplex {
+
+namespace {
+
+struct Key {
+    const char* s;
+    int len;
+};
+
+struct KeyHash {
+    // http://www.cse.yorku.ca/~oz/hash.html
+    size_t operator()(const Key& k) const {
+        size_t h = 5381;
+        for (int i = 0; i < k.len; ++i) {
+            h = ((h << 5) + h) + static_cast<unsigned char>(k.s[i]);
+        }
+        return h;
+    }
+};
+
+struct KeyEqual {
+    bool operator()(const Key& a, const Key& b) const
+    { return a.len == b.len && std::memcmp(a.s, b.s, a.len) == 0; }
+};
+
+// Symbols are looked up without locking. The strings are kept in chunks
+// which are never moved, so a symbol can be resolved while another
+// thread is interning a new string.
+class Table
+{
+public:
+    static const quint32 kChunkBits = 16;
+    static const quint32 kChunkSize = 1u << kChunkBits;
+    static const quint32 kMaxChunks = 1u << (32 - kChunkBits);
+
+    Table() : m_size(0) {
+        for (quint32 i = 0; i < kMaxChunks; ++i) {
+            m_chunks[i].store(nullptr, std::memory_order_relaxed);
+        }
+        intern("", 0);
+    }
+
+    ~Table() {
+        for (quint32 i = 0; i < kMaxChunks; ++i) {
+            delete [] m_chunks[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    quint32 intern(const char* str, int len) {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_symbols.find(Key{str, len});
+        if (it != m_symbols.end()) {
+            return it->second;
+        }
+
+        Q_ASSERT_X(m_size < kChunkSize * kMaxChunks, "StringTable", "too many strings");
+        char* s = static_cast<char*>(m_arena.allocate(len + 1, 1));
+        std::memcpy(s, str, len);
+        s[len] = '\0';
+
+        const quint32 symbol = m_size;
+        const char** chunk = m_chunks[symbol >> kChunkBits].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new const char*[kChunkSize];
+            m_chunks[symbol >> kChunkBits].store(chunk, std::memory_order_release);
+        }
+        chunk[symbol & (kChunkSize - 1)] = s;
+        m_symbols.insert({Key{s, len}, symbol});
+        ++m_size;
+        return symbol;
+    }
+
+    inline const char* str(quint32 symbol) const {
+        const char* const* chunk = m_chunks[symbol >> kChunkBits].load(std::memory_order_acquire);
+        Q_ASSERT_X(chunk, "StringTable", "invalid symbol");
+        return chunk[symbol & (kChunkSize - 1)];
+    }
+
+    inline quint32 size() const {
+        QMutexLocker locker(&m_mutex);
+        return m_size;
+    }
+
+private:
+    mutable QMutex m_mutex;
+    Arena m_arena;
+    std::unordered_map<Key, quint32, KeyHash, KeyEqual> m_symbols;
+    std::atomic<const char**> m_chunks[kMaxChunks];
+    quint32 m_size;
+};
+
+Table& table()
+{
+    static Table t;
+    return t;
+}
+
+} // namespace
+
+quint32 StringTable::intern(const char* str)
+{
+    return str ? table().intern(str, static_cast<int>(std::strlen(str))) : 0;
+}
+
+quint32 StringTable::intern(const char* str, int len)
+{
+    return (str && len > 0) ? table().intern(str, len) : 0;
+}
+
+const char* StringTable::str(quint32 symbol)
+{
+    return table().str(symbol);
+}
+
+int StringTable::size()
+{
+    return static_cast<int>(table().size());
+}
+
+} // evoplex
@@ -0,0 +1,146 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "textfile.h"
+
+namespace evoplex {
+
+bool TextFile::open(const QString& fpath)
+{
+    close();
+    m_file.setFileName(fpath);
+    if (!m_file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    if (size > 0) {
+        m_map = m_file.map(0, size);
+    }
+    if (m_map) {
+        m_begin = reinterpret_cast<const char*>(m_map);
+        m_end = m_begin + size;
+        return true;
+    }
+
+    // empty files cannot be mapped, and some file systems do not support it
+    m_buf = m_file.readAll();
+    m_begin = m_buf.constData();
+    m_end = m_begin + m_buf.size();
+    return m_buf.size() == size;
+}
+
+void TextFile::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_buf.clear();
+    m_begin = m_end = nullptr;
+}
+
+bool TextFile::parseDouble(const char*& p, const char* end, double& value)
+{
+    // powers of ten which are exact in a double
+    static const double kPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* cellEnd = end;
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t')) {
+        --end;
+    }
+    const char* begin = p;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    // the significant digits are accumulated into an integer, which is
+    // exact up to 2^53; longer ones are left to the slow path
+    qint64 mantissa = 0;
+    int numDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    auto addDigit = [&mantissa, &numDigits](char c) {
+        if ((mantissa || c != '0') && ++numDigits <= 15) {
+            mantissa = mantissa * 10 + (c - '0');
+        }
+    };
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        addDigit(*p);
+        hasDigits = true;
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+            addDigit(*p);
+            hasDigits = true;
+            --exponent;
+        }
+    }
+    if (hasDigits && p < end && (*p == 'e' || *p == 'E')) {
+        int e;
+        ++p;
+        if (p < end && *p != ' ' && *p != '\t' && parseInt(p, end, e) && e >= -22 && e <= 22) {
+            exponent += e;
+        } else {
+            p = begin; // handled by the slow path
+        }
+    }
+
+    if (hasDigits && p == end && numDigits <= 15 && exponent >= -22 && exponent <= 22) {
+        const double m = static_cast<double>(mantissa);
+        value = exponent < 0 ? m / kPow10[-exponent] : m * kPow10[exponent];
+        value = negative ? -value : value;
+        p = cellEnd;
+        return true;
+    }
+
+    // e.g., more digits, 'inf' or 'nan'
+    bool ok = false;
+    value = QByteArray(begin, static_cast<int>(end - begin)).toDouble(&ok);
+    p = cellEnd;
+    return ok;
+}
+
+std::vector<Span<char>> TextFile::chunks(const char* from, qint64 chunkSize) const
+{
+    std::vector<Span<char>> ret;
+    const char* p = from;
+    while (p < m_end) {
+        const char* chunkEnd = (m_end - p > chunkSize) ? p + chunkSize : m_end;
+        while (chunkEnd < m_end && chunkEnd[-1] != '\n') {
+            ++chunkEnd;
+        }
+        ret.emplace_back(p, chunkEnd);
+        p = chunkEnd;
+    }
+    return ret;
+}
+
+} // evoplex
@@ -0,0 +1,131 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEXTFILE_H
+#define TEXTFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <vector>
+
+#include "span.h"
+
+namespace evoplex {
+
+/**
+ *  @brief A read-only view of the bytes of a (text) file.
+ *
+ *  The file is memory-mapped when possible, so it is not copied and the
+ *  OS pages it in as it is parsed; otherwise, it is read into memory.
+ *  The bytes can be split into chunks of whole lines, which can then be
+ *  parsed in parallel.
+ */
+class TextFile
+{
+public:
+    TextFile() : m_map(nullptr) {}
+    ~TextFile() { close(); }
+
+    TextFile(const TextFile&) = delete;
+    TextFile& operator=(const TextFile&) = delete;
+
+    bool open(const QString& fpath);
+    void close();
+
+    inline const char* begin() const { return m_begin; }
+    inline const char* end() const { return m_end; }
+    inline qint64 size() const { return m_end - m_begin; }
+
+    // Splits [from, end()) into chunks of about 'chunkSize' bytes.
+    // All chunks but the last one end right after a line break.
+    std::vector<Span<char>> chunks(const char* from, qint64 chunkSize) const;
+
+    // Returns the line starting at 'p', without the line break (i.e., '\n'
+    // or "\r\n"), and moves 'p' to the beginning of the next line.
+    static inline Span<char> readLine(const char*& p, const char* end);
+
+    // Parses a decimal integer, surrounded or not by blanks, and moves 'p'
+    // to the first character after it. Returns false if 'p' does not
+    // point to an integer or if it does not fit in an int.
+    static inline bool parseInt(const char*& p, const char* end, int& value);
+
+    // Parses the number in [p, end), surrounded or not by blanks, and moves
+    // 'p' to 'end'. Plain decimals (e.g., "-1.25e3") of up to 15 digits are
+    // converted exactly in place; the others go through QByteArray::toDouble().
+    static bool parseDouble(const char*& p, const char* end, double& value);
+
+private:
+    QFile m_file;
+    uchar* m_map;
+    QByteArray m_buf; // used when the file cannot be mapped
+    const char* m_begin = nullptr;
+    const char* m_end = nullptr;
+};
+
+/************************************************************************
+   TextFile: Inline member functions
+ ************************************************************************/
+
+inline Span<char> TextFile::readLine(const char*& p, const char* end)
+{
+    const char* begin = p;
+    while (p < end && *p != '\n') {
+        ++p;
+    }
+    const char* lineEnd = (p > begin && p[-1] == '\r') ? p - 1 : p;
+    if (p < end) {
+        ++p; // skip '\n'
+    }
+    return Span<char>(begin, lineEnd);
+}
+
+inline bool TextFile::parseInt(const char*& p, const char* end, int& value)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    if (p == end || *p < '0' || *p > '9') {
+        return false;
+    }
+    // accumulates as a negative number, as its range is larger
+    const long long min = negative ? -2147483648LL : -2147483647LL;
+    long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 - (*p - '0');
+        if (v < min) {
+            return false;
+        }
+        ++p;
+    }
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    value = static_cast<int>(negative ? v : -v);
+    return true;
+}
+
+} // evoplex
+#endif // TEXTFILE_H
@@ -0,0 +1,86 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <QFileInfo>
+
+#include "topologycache.h"
+
+namespace evoplex {
+
+EdgeListPtr TopologyCache::edges(const QString& filePath, int graphType,
+                                 int numNodes, QString* errMsg)
+{
+    const QFileInfo fileInfo(filePath);
+    const Key key(fileInfo.absoluteFilePath(),
+                  fileInfo.lastModified().toMSecsSinceEpoch(), graphType, numNodes);
+
+    // the entry is added before reading the file, so the trials which
+    // need it wait for it instead of reading it again
+    std::promise<Entry> promise;
+    std::shared_future<Entry> future;
+    bool isReader = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_edges.find(key);
+        if (it != m_edges.end()) {
+            future = it->second;
+        } else {
+            // older versions of the file are no longer needed
+            for (it = m_edges.begin(); it != m_edges.end();) {
+                if (std::get<0>(it->first) == std::get<0>(key) && std::get<1>(it->first) != std::get<1>(key)) {
+                    it = m_edges.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            future = promise.get_future().share();
+            m_edges.emplace(key, future);
+            isReader = true;
+        }
+    }
+
+    if (isReader) {
+        Entry entry;
+        EdgeList edges = EdgeList::fromFile(filePath, numNodes, &entry.error);
+        if (entry.error.isEmpty()) {
+            entry.edges = std::make_shared<const EdgeList>(std::move(edges));
+        } else {
+            // not cached, so it can be read again later
+            QMutexLocker locker(&m_mutex);
+            m_edges.erase(key);
+        }
+        promise.set_value(entry);
+    }
+
+    const Entry& entry = future.get();
+    if (!entry.edges && errMsg) {
+        *errMsg = entry.error;
+    }
+    return entry.edges;
+}
+
+void TopologyCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_edges.clear();
+}
+
+} // evoplex
@@ -28,16 +28,6 @@ Value::Value() : m_type(INVALID)
 {
 }
 
-Value::Value(const Value& value) : m_type(value.type())
-{
-    if (m_type == INT) m_data.i = value.toInt();
-    else if (m_type == DOUBLE) m_data.d = value.toDouble();
-    else if (m_type == BOOL) m_data.b = value.toBool();
-    else if (m_type == CHAR) m_data.c = value.toChar();
-    else if (m_type == STRING) m_data.s = qstrdup(value.toString());
-    else if (m_type != INVALID) qFatal("non-existent type");
-}
-
 Value::Value(const bool value) : m_type(BOOL)
 {
     m_data.b = value;
@@ -60,24 +50,14 @@ Value::Value(const int value) : m_type(INT)
 
 Value::Value(const char* value) : m_type(STRING)
 {
-    // considering that Value(const QString& value) needs to call a new char[],
-    // which must be deleted in this class, for consistency, let's do the same
-    // here as well, and we can safely use delete[] whenever it's a STRING
-    m_data.s = qstrdup(value);
+    m_data.s = StringTable::intern(value);
 }
 
-// converts the QString to a char*
+// stores the QString as UTF-8
 Value::Value(const QString& value) : m_type(STRING)
 {
     QByteArray text = value.toUtf8();
-    m_data.s = qstrdup(text.constData());
-}
-
-Value::~Value()
-{
-    if (m_type == STRING) {
-        delete [] m_data.s;
-    }
+    m_data.s = StringTable::intern(text.constData(), text.size());
 }
 
 QString Value::toQString(char format, int precision) const
@@ -87,28 +67,12 @@ QString Value::toQString(char format, int precision) const
     case DOUBLE: return QString::number(m_data.d, format, precision);
     case BOOL: return QString::number(m_data.b);
     case CHAR: return QString(m_data.c);
-    case STRING: return QString::fromUtf8(m_data.s);
+    case STRING: return QString::fromUtf8(toString());
     case INVALID: return QString();
     }
     throw std::invalid_argument("invalid type of Value");
 }
 
-Value& Value::operator=(const Value& v)
-{
-    if(this != &v) { // check for self-assignment
-        m_type = v.m_type;
-        switch (m_type) {
-        case INT: m_data.i = v.m_data.i; break;
-        case DOUBLE: m_data.d = v.m_data.d; break;
-        case BOOL: m_data.b = v.m_data.b; break;
-        case CHAR: m_data.c = v.m_data.c; break;
-        case STRING: m_data.s = qstrdup(v.toString()); break;
-        case INVALID: /* nothing-to-copy */ break;
-        }
-    }
-    return *this;
-}
-
 bool Value::operator==(const Value& v) const
 {
     if (m_type != v.m_type) {
@@ -120,7 +84,7 @@ bool Value::operator==(const Value& v) const
     case DOUBLE: return qFuzzyCompare(m_data.d, v.m_data.d);
     case BOOL: return m_data.b == v.m_data.b;
     case CHAR: return m_data.c == v.m_data.c;
-    case STRING: return strcmp (m_data.s, v.m_data.s) == 0;
+    case STRING: return m_data.s == v.m_data.s;
     default: throw std::invalid_argument("invalid type of Value");
     }
 }
@@ -136,7 +100,7 @@ bool Value::operator!=(const Value& v) const
     case DOUBLE: return !qFuzzyCompare(m_data.d, v.m_data.d);
     case BOOL: return m_data.b != v.m_data.b;
     case CHAR: return m_data.c != v.m_data.c;
-    case STRING: return strcmp (m_data.s, v.m_data.s) != 0;
+    case STRING: return m_data.s != v.m_data.s;
     default: throw std::invalid_argument("invalid type of Value");
     }
 }
@@ -153,6 +153,13 @@ ExperimentDesigner::ExperimentDesigner(MainApp* mainApp, QWidget *parent)
     // -- avgTrials
     QCheckBox* outAvgTrials = new QCheckBox("average trials");
     addTreeWidget(m_treeItemOutputs, OUTPUT_AVGTRIALS, QVariant::fromValue(outAvgTrials));
+    // -- file format
+    QComboBox* outFormat = new QComboBox(m_ui->treeWidget);
+    outFormat->addItems({"csv", "bin", "binz"});
+    outFormat->setToolTip("csv: text file\n"
+                          "bin: binary columns (smaller and faster)\n"
+                          "binz: compressed binary columns");
+    addTreeWidget(m_treeItemOutputs, OUTPUT_FORMAT, QVariant::fromValue(outFormat));
 /*    // -- steps to save
     QRadioButton* outAllSteps = new QRadioButton("all");
     outAllSteps->setChecked(true);
@@ -172,11 +179,12 @@ ExperimentDesigner::ExperimentDesigner(MainApp* mainApp, QWidget *parent)
     m_ui->treeWidget->setItemWidget(itemOut, 1, outStepsLayout->parentWidget());
 */
     connect(m_enableOutputs, &QCheckBox::toggled,
-            [outDir, outBrowseDir, outHeader, outBuildHeader](bool b) {
+            [outDir, outBrowseDir, outHeader, outBuildHeader, outFormat](bool b) {
                 outDir->setEnabled(b);
                 outBrowseDir->setEnabled(b);
                 outHeader->setEnabled(b);
                 outBuildHeader->setEnabled(b);
+                outFormat->setEnabled(b);
 //                outAvgTrials->setEnabled(b);
     });
     m_enableOutputs->setChecked(true);
@@ -420,8 +428,8 @@ ExpInputs* ExperimentDesigner::readInputs(const int expId, QString& error) const
     }
 
     if (!m_enableOutputs->isChecked()) {
-        header << OUTPUT_DIR << OUTPUT_HEADER;
-        values << "" << "";
+        header << OUTPUT_DIR << OUTPUT_HEADER << OUTPUT_FORMAT;
+        values << "" << "" << "csv";
     }
 
     QString errorMsg;
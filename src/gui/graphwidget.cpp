@@ -256,8 +256,9 @@ void GraphWidget::updateInspector(const NodePtr& node)
 {
     m_ui->nodeId->setValue(node->id());
     m_ui->neighbors->setText(QString::number(node->outDegree()));
-    for (int id = 0; id < node->attrs().size(); ++id) {
-        m_attrs.at(id)->setText(node->attr(id).toQString());
+    const Attributes attrs = node->attrs();
+    for (int id = 0; id < attrs.size(); ++id) {
+        m_attrs.at(id)->setText(attrs.value(id).toQString());
     }
 }
 
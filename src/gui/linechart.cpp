@@ -208,14 +208,14 @@ void LineChart::updateSeries()
         int i = 0;
         bool lastWasDuplicated = false;
         do {
-            const Cache::Row& row = s.cache->readFrontRow(m_currTrialId);
-            Q_ASSERT_X(row.second.size() == 1, "LineChart", "it must have only one column");
-
-            x = row.first;
-            if (row.second.at(0).type() == Value::INT) {
-                y = row.second.at(0).toInt();
-            } else if (row.second.at(0).type() == Value::DOUBLE) {
-                y = row.second.at(0).toDouble();
+            const Cache::Row row = s.cache->readFrontRow(m_currTrialId);
+            Q_ASSERT_X(row.size() == 1, "LineChart", "it must have only one column");
+
+            x = row.step();
+            if (row.at(0).type() == Value::INT) {
+                y = row.at(0).toInt();
+            } else if (row.at(0).type() == Value::DOUBLE) {
+                y = row.at(0).toDouble();
             } else {
                 qFatal("the type is invalid!");
             }
@@ -53,7 +53,7 @@ NodesGeneratorDlg::NodesGeneratorDlg(QWidget* parent, const AttributesScope& nod
 
     connect(m_ui->browseFile, &QPushButton::pressed, [this]() {
         QString path = QFileDialog::getOpenFileName(this, "Initial Population",
-                m_ui->filepath->text(), "Text Files (*.csv *.txt)");
+                m_ui->filepath->text(), "Text Files (*.csv *.txt);;Graph Snapshots (*.evg)");
         if (!path.isEmpty()) {
             m_ui->filepath->setText(path);
         }
@@ -116,14 +116,23 @@ void NodesGeneratorDlg::slotSaveAs()
     QString path = QFileDialog::getSaveFileName(this,
                                                 "Save Nodes",
                                                 m_ui->filepath->text(),
-                                                "Text Files (*.csv)");
+                                                "Text Files (*.csv);;Compressed Text Files (*.csv.gz);;"
+                                                "Graph Snapshots (*.evg)");
     if (path.isEmpty()) {
         return;
     }
 
     bool saved = false;
     if (m_ui->bFromFile->isChecked()) {
-        saved = QFile::copy(m_ui->filepath->text(), path);
+        // the file is copied as it is, unless it is saved in another format
+        const QString srcPath = m_ui->filepath->text();
+        if (QFileInfo(srcPath).completeSuffix() == QFileInfo(path).completeSuffix()) {
+            saved = QFile::copy(srcPath, path);
+        } else {
+            QString errMsg;
+            Nodes nodes = Nodes::fromFile(srcPath, m_nodeAttrsScope, AbstractGraph::Undirected, &errMsg);
+            saved = errMsg.isEmpty() && !nodes.empty() && nodes.saveToFile(path);
+        }
     } else {
         QString cmd = readCommand();
         if (cmd.isEmpty()) {
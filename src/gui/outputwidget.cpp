@@ -60,10 +60,12 @@ OutputWidget::OutputWidget(const ModelPlugin* modelPlugin, const std::vector<int
     m_ui->table->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
     m_ui->table->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Stretch);
     m_ui->table->horizontalHeader()->setSectionResizeMode(4, QHeaderView::Stretch);
+    m_ui->table->horizontalHeader()->setSectionResizeMode(5, QHeaderView::ResizeToContents);
 
     // init table
     for (const Cache* cache : init) {
         const int rootId = m_ui->table->rowCount();
+        const QString samplingStr = cache->output()->sampling().toString();
         DefaultOutputPtr df = std::dynamic_pointer_cast<DefaultOutput>(cache->output());
         if (df) {
             const QString entityStr = df->entity() == DefaultOutput::E_Nodes
@@ -74,14 +76,15 @@ OutputWidget::OutputWidget(const ModelPlugin* modelPlugin, const std::vector<int
                 rowInfo.id = m_ui->table->rowCount();
                 rowInfo.equalToId = rowInfo.id == rootId ? -1 : rootId;
                 insertRow(rowInfo, df->functionStr(), DefaultFunc, entityStr, df->entity(),
-                          df->attrRange()->attrName(), input.toQString());
+                          df->attrRange()->attrName(), input.toQString(), samplingStr);
             }
         } else if (std::dynamic_pointer_cast<CustomOutput>(cache->output())) {
             for (Value func : cache->inputs()) {
                 RowInfo rowInfo;
                 rowInfo.id = m_ui->table->rowCount();
                 rowInfo.equalToId = rowInfo.id == rootId ? -1 : rootId;
-                insertRow(rowInfo, func.toQString(), CustomFunc);
+                insertRow(rowInfo, func.toQString(), CustomFunc, "", DefaultOutput::E_Nodes,
+                          "", "", samplingStr);
             }
         } else {
             qFatal("invalid Output object.");
@@ -125,6 +128,7 @@ void OutputWidget::slotClose(bool canceled)
         QString attr = m_ui->table->item(row, 3)->text();
         QString inputStr = m_ui->table->item(row, 4)->text();
         RowInfo rinfo = m_ui->table->item(row, 4)->data(Qt::UserRole).value<RowInfo>();
+        const Sampling sampling = Sampling::fromString(m_ui->table->item(row, 5)->text());
 
         const AttributeRange* entityAttrRange;
         if (entity == DefaultOutput::E_Nodes) {
@@ -136,13 +140,13 @@ void OutputWidget::slotClose(bool canceled)
         if (rinfo.equalToId == -1) {
             Cache* cache = nullptr;
             if (funcType == DefaultFunc) {
-                Value input = entityAttrRange->validate(inputStr);
                 DefaultOutput::Function func = DefaultOutput::funcFromString(funcStr);
+                Value input = DefaultOutput::validateInput(func, entityAttrRange, inputStr);
                 Q_ASSERT(func != DefaultOutput::F_Invalid && input.isValid());
-                OutputPtr newOutput (new DefaultOutput(func, entity, entityAttrRange));
+                OutputPtr newOutput (new DefaultOutput(func, entity, entityAttrRange, sampling));
                 cache = newOutput->addCache({input}, m_trialIds);
             } else {
-                OutputPtr newOutput (new CustomOutput());
+                OutputPtr newOutput (new CustomOutput(sampling));
                 cache = newOutput->addCache({Value(funcStr)}, m_trialIds);
             }
             m_allCaches.insert({rinfo.id, cache});
@@ -150,7 +154,8 @@ void OutputWidget::slotClose(bool canceled)
             OutputPtr existingOutput = m_allCaches.at(rinfo.equalToId)->output();
             Value input;
             if (funcType == DefaultFunc) {
-                input = entityAttrRange->validate(inputStr);
+                input = DefaultOutput::validateInput(DefaultOutput::funcFromString(funcStr),
+                                                     entityAttrRange, inputStr);
             } else {
                 input = Value(funcStr);
             }
@@ -195,14 +200,25 @@ void OutputWidget::slotEntityChanged(bool isNode)
 
 void OutputWidget::slotAdd()
 {
+    bool validSampling;
+    const Sampling sampling = Sampling::fromString(m_ui->sampling->text().trimmed(), &validSampling);
+    if (!validSampling) {
+        QMessageBox::warning(this, "Evoplex",
+                             "The 'sampling' is not valid.\n"
+                             "Expected: empty (every step), everyN, logN, final or change.");
+        return;
+    }
+
     m_hasChanges = true;
 
+    // outputs which differ only in the sampling are different outputs
     RowInfo rowInfo;
     for (int row = 0; row < m_ui->table->rowCount(); ++row) {
         if (m_ui->table->item(row, 1)->data(Qt::UserRole) == m_ui->func->currentData() &&
             m_ui->table->item(row, 1)->text() == m_ui->func->currentText() &&
             m_ui->table->item(row, 2)->data(Qt::UserRole).toInt() == m_currEntity &&
-            m_ui->table->item(row, 3)->text() == m_ui->attr->currentText())
+            m_ui->table->item(row, 3)->text() == m_ui->attr->currentText() &&
+            m_ui->table->item(row, 5)->text() == sampling.toString())
         {
             if (m_ui->table->item(row, 4)->text() == m_ui->input->text()) {
                 QMessageBox::warning(this, "Evoplex", "It's already in the table.");
@@ -220,21 +236,37 @@ void OutputWidget::slotAdd()
     }
 
     if (m_ui->func->currentData().toInt() == DefaultFunc) {
-        if (!entityAttrRange->validate(m_ui->input->text()).isValid()) {
+        const DefaultOutput::Function func = DefaultOutput::funcFromString(m_ui->func->currentText());
+        if (!DefaultOutput::isSupported(func, entityAttrRange)) {
+            QMessageBox::warning(this, "Evoplex",
+                                 "The 'function' does not support the current 'attribute'.\n"
+                                 "Only numeric attributes can be reduced.");
+            return;
+        } else if (!DefaultOutput::validateInput(func, entityAttrRange, m_ui->input->text()).isValid()) {
+            QString expected = entityAttrRange->attrRangeStr();
+            if (DefaultOutput::isScalar(func)) {
+                expected = "an empty input";
+            } else if (func == DefaultOutput::F_Hist) {
+                expected = "the lower bound of a bin";
+            } else if (func == DefaultOutput::F_Quantile) {
+                expected = "a probability in [0,1]";
+            }
             QMessageBox::warning(this, "Evoplex",
                                  "The 'input' is not valid for the current 'attribute'.\n"
-                                 "Expected: " + entityAttrRange->attrRangeStr());
+                                 "Expected: " + expected);
             return;
         }
     }
 
     rowInfo.id = m_ui->table->rowCount();
     insertRow(rowInfo, m_ui->func->currentText(), (FuncType) m_ui->func->currentData().toInt(),
-              m_currEntityStr, m_currEntity, m_ui->attr->currentText(), m_ui->input->text());
+              m_currEntityStr, m_currEntity, m_ui->attr->currentText(), m_ui->input->text(),
+              sampling.toString());
 }
 
 void OutputWidget::insertRow(const RowInfo rowInfo, const QString& funcStr, const FuncType funcType,
-                             QString entityStr, DefaultOutput::Entity entity, QString attr, QString input)
+                             QString entityStr, DefaultOutput::Entity entity, QString attr, QString input,
+                             QString sampling)
 {
     m_ui->table->insertRow(rowInfo.id);
 
@@ -253,6 +285,8 @@ void OutputWidget::insertRow(const RowInfo rowInfo, const QString& funcStr, cons
     QTableWidgetItem* itemInput = new QTableWidgetItem(input);
     itemInput->setData(Qt::UserRole, QVariant::fromValue(rowInfo));
     m_ui->table->setItem(rowInfo.id, 4, itemInput);
+
+    m_ui->table->setItem(rowInfo.id, 5, new QTableWidgetItem(sampling));
 }
 
 } // evoplex
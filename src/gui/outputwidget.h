@@ -79,7 +79,7 @@ private:
 
     void insertRow(const RowInfo rowInfo, const QString& funcStr, const FuncType funcType,
                    QString entityStr="", DefaultOutput::Entity entity=DefaultOutput::E_Nodes,
-                   QString attr="", QString input="");
+                   QString attr="", QString input="", QString sampling="");
 };
 } // evoplex
 
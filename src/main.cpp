@@ -28,6 +28,7 @@
 #include <QStyleFactory>
 
 #include "config.h"
+#include "core/include/columnfile.h"
 #include "core/logger.h"
 #include "core/mainapp.h"
 #include "gui/maingui.h"
@@ -47,6 +48,19 @@ int main(int argc, char* argv[])
     if (!qstrcmp(argv[1], "-version")) {
         printf("%s-%s\n", EVOPLEX_VERSION, EVOPLEX_RELEASE);
         return 0;
+    } else if (!qstrcmp(argv[1], "-bin2csv")) {
+        if (argc != 4) {
+            printf("usage: %s -bin2csv <input.evb> <output.csv>\n", argv[0]);
+            return 1;
+        }
+        QString error;
+        evoplex::ColumnFileReader reader;
+        if (!reader.open(QString::fromLocal8Bit(argv[2]), error)
+                || !reader.toCsv(QString::fromLocal8Bit(argv[3]), error)) {
+            printf("%s\n", qPrintable(error));
+            return 1;
+        }
+        return 0;
     }
 
     QScopedPointer<QCoreApplication> coreApp(createApp(argc, argv));
@@ -18,8 +18,6 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <QFile>
-
 #include "plugin.h"
 
 namespace evoplex {
@@ -41,72 +39,17 @@ bool CustomGraph::init()
 
 void CustomGraph::reset()
 {
-    m_edges.clear();
-
-    QFile file(m_filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "unable to read csv file with the set of nodes." << m_filePath;
-        return;
-    }
-
-    QTextStream in(&file);
-
-    // read and validate header
-    QStringList header;
-    if (!in.atEnd()) {
-        header = in.readLine().split(",");
-        if (header.size() < 2 || header.at(0) != "origin" || header.at(1) != "target") {
-            header.clear();
-        }
-    }
+    removeAllEdges();
 
-    if (header.isEmpty()) {
-        qWarning() << "the header is invalid."
-                   << "It should have at least two columns: 'origin' and 'target'."
-                   << m_filePath;
+    QString errMsg;
+    const EdgeListPtr edges = readEdgeList(m_filePath, &errMsg);
+    if (!edges) {
+        qWarning() << errMsg;
         return;
     }
-
-    // create edges
-    int row = 0;
-    bool isValid = true;
-    while (!in.atEnd()) {
-        QStringList values = in.readLine().split(",");
-        if (values.size() != header.size()) {
-            qWarning() << "rows must have the same number of columns!"
-                       << m_filePath << "Row: " << row;
-            isValid = false;
-            break;
-        }
-
-        bool ok1, ok2;
-        int originId = values.at(0).toInt(&ok1);
-        int targetId = values.at(1).toInt(&ok2);
-        if (!ok1 || !ok2) {
-            qWarning() << "invalid values."
-                       << "The values for 'origin' and 'target' must be integers."
-                       << m_filePath << "Row: " << row;
-            isValid = false;
-            break;
-        } else if (originId < 0 || originId >= numNodes() ||
-                   targetId < 0 || targetId >= numNodes()) {
-            qWarning() << "invalid values. 'origin' or 'target' are not in the set of nodes."
-                          << m_filePath << "Row: " << row;
-            isValid = false;
-            break;
-        }
-
-        addEdge(originId, targetId, new Attributes());
-        ++row;
-    }
-    file.close();
-
-    if (!isValid) {
-        m_edges.clear();
-    }
+    addEdges(*edges);
 }
 
-
 } // evoplex
 REGISTER_GRAPH(CustomGraph)
 #include "plugin.moc"
@@ -58,7 +58,7 @@ bool SquareGrid::init()
 
 void SquareGrid::reset()
 {
-    m_edges.clear();
+    removeAllEdges();
 
     edgesFunc func;
     if (m_numNeighbours == 4) {
@@ -102,7 +102,7 @@ void SquareGrid::createPeriodicEdges(const int id, edgesFunc func)
 
         int nId = Utils::linearIdx(neighbor, m_width);
         Q_ASSERT_X(nId < numNodes(), "SquareGrid::createEdges", "neighbor must exist");
-        addEdge(node(id), node(nId), new Attributes());
+        addEdge(node(id), node(nId));
     }
 }
 
@@ -116,7 +116,7 @@ void SquareGrid::createFixedEdges(const int id, edgesFunc func)
         }
         int nId = Utils::linearIdx(neighbor, m_width);
         Q_ASSERT_X(nId < numNodes(), "SquareGrid::createEdges", "neighbor must exist");
-        addEdge(node(id), node(nId), new Attributes());
+        addEdge(node(id), node(nId));
     }
 }
 
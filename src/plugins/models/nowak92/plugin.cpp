@@ -25,46 +25,51 @@ namespace evoplex {
 bool ModelNowak::init()
 {
     m_temptation = attr("temptation", -1.0).toDouble();
+    m_strategy = nodeAttr<int>("strategy");
+    m_score = nodeAttr<double>("score");
+    if (!m_strategy.isValid() || !m_score.isValid()) {
+        return false;
+    }
+    setDoubleBuffered(m_strategy);
     return m_temptation >=1.0 && m_temptation <= 2.0;
 }
 
 bool ModelNowak::algorithmStep()
 {
+    const CSR& csr = graph()->csr();
+    const int* strategy = currState(m_strategy);
+    int* nextStrategy = nextState(m_strategy);
+    double* score = graph()->nodeColumns().data<double>(m_score.column());
+
     // 1. each agent accumulates the payoff obtained by playing the game with all its neighbours and itself
-    for (const Nodes::Pair& np : nodes()) {
-        const int sX = np.node()->attr(Strategy).toInt();
-        double score = playGame(sX, sX);
-        for (const Edges::Pair& ep : np.node()->outEdges()) {
-            score += playGame(sX, ep.edge()->neighbour()->attr(Strategy).toInt());
+    parallelForNodes([&](int begin, int end) {
+        for (int row = begin; row < end; ++row) {
+            const int sX = strategy[row];
+            double payoff = playGame(sX, sX);
+            for (const int nb : csr.outNeighbours(row)) {
+                payoff += playGame(sX, strategy[nb]);
+            }
+            score[row] = payoff;
         }
-        np.node()->setAttr(Score, score);
-    }
-
-    std::vector<char> bestStrategies;
-    bestStrategies.reserve(nodes().size());
+    });
 
     // 2. the best agent in the neighbourhood is selected to reproduce
-    for (const Nodes::Pair& np : nodes()) {
-        int bestStrategy = np.node()->attr(Strategy).toInt();
-        double highestScore = np.node()->attr(Score).toDouble();
-        for (const Edges::Pair& ep : np.node()->outEdges()) {
-            const double neighbourScore = ep.edge()->neighbour()->attr(Score).toDouble();
-            if (neighbourScore > highestScore) {
-                highestScore = neighbourScore;
-                bestStrategy = ep.edge()->neighbour()->attr(Strategy).toInt();
+    parallelForNodes([&](int begin, int end) {
+        for (int row = begin; row < end; ++row) {
+            int bestStrategy = strategy[row];
+            double highestScore = score[row];
+            for (const int nb : csr.outNeighbours(row)) {
+                if (score[nb] > highestScore) {
+                    highestScore = score[nb];
+                    bestStrategy = strategy[nb];
+                }
             }
+            // prepare the next generation
+            const int s = binarize(strategy[row]);
+            bestStrategy = binarize(bestStrategy);
+            nextStrategy[row] = (s == bestStrategy) ? s : bestStrategy + 2;
         }
-        bestStrategies.emplace_back(binarize(bestStrategy));
-    }
-
-    // 3. prepare the next generation
-    int i = 0;
-    for (const Nodes::Pair& np : nodes()) {
-        int s = binarize(np.node()->attr(Strategy).toInt());
-        s = (s == bestStrategies.at(i)) ? s : bestStrategies.at(i) + 2;
-        np.node()->setAttr(Strategy, s);
-        ++i;
-    }
+    });
 
     return false;
 }
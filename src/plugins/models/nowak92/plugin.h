@@ -31,8 +31,8 @@ public:
     virtual bool algorithmStep();
 
 private:
-    enum NodeAttr { Strategy, Score };
-
+    AttrHandle<int> m_strategy;
+    AttrHandle<double> m_score;
     double m_temptation;
 
     double playGame(const int sX, const int sY) const;
@@ -0,0 +1,144 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <abstractgraph.h>
+#include <edgelist.h>
+
+using namespace evoplex;
+
+// Measures how fast an edge list is read, in MB/s of csv, compared with
+// reading it line by line with QTextStream, which was how CustomGraph
+// used to read it. It also measures adding the edges to a graph in bulk.
+class BenchEdgeList: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase() {}
+    void bench_fromFile();
+    void bench_textStream();
+    void bench_addEdges();
+
+private:
+    class Graph : public AbstractGraph
+    {
+    public:
+        Graph() : AbstractGraph("bench") {}
+        bool init() override { return true; }
+        void reset() override {}
+    };
+
+    static const int kNodes = 100000;
+    static const int kEdges = 5000000;
+    QTemporaryDir m_dir;
+    QString m_filePath;
+    qint64 m_fileSize;
+
+    void report(qint64 msecs, int iterations) const;
+};
+
+void BenchEdgeList::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_filePath = m_dir.path() + "/edges.csv";
+    QFile file(m_filePath);
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+
+    PRG prg(0);
+    QByteArray buf("origin,target\n");
+    for (int i = 0; i < kEdges; ++i) {
+        buf += QByteArray::number(prg.randI(kNodes - 1)) + ","
+             + QByteArray::number(prg.randI(kNodes - 1)) + "\n";
+        if (buf.size() > (1 << 20)) {
+            QVERIFY(file.write(buf) == buf.size());
+            buf.clear();
+        }
+    }
+    QVERIFY(file.write(buf) == buf.size());
+    m_fileSize = file.size();
+}
+
+void BenchEdgeList::report(qint64 msecs, int iterations) const
+{
+    const double mb = iterations * m_fileSize / (1024.0 * 1024.0);
+    qDebug() << "throughput (MB/s):" << mb * 1000 / qMax<qint64>(msecs, 1);
+}
+
+void BenchEdgeList::bench_fromFile()
+{
+    qint64 msecs = 0;
+    int iterations = 0;
+    QBENCHMARK {
+        QElapsedTimer timer;
+        timer.start();
+        QString error;
+        const EdgeList edges = EdgeList::fromFile(m_filePath, kNodes, &error);
+        msecs += timer.elapsed();
+        ++iterations;
+        QCOMPARE(edges.size(), kEdges);
+    }
+    report(msecs, iterations);
+}
+
+void BenchEdgeList::bench_textStream()
+{
+    qint64 msecs = 0;
+    int iterations = 0;
+    QBENCHMARK {
+        QElapsedTimer timer;
+        timer.start();
+        QFile file(m_filePath);
+        QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+        QTextStream in(&file);
+        in.readLine(); // header
+        EdgeList edges;
+        while (!in.atEnd()) {
+            const QStringList values = in.readLine().split(",");
+            edges.add(values.at(0).toInt(), values.at(1).toInt());
+        }
+        msecs += timer.elapsed();
+        ++iterations;
+        QCOMPARE(edges.size(), kEdges);
+    }
+    report(msecs, iterations);
+}
+
+void BenchEdgeList::bench_addEdges()
+{
+    QString error;
+    const EdgeList edges = EdgeList::fromFile(m_filePath, kNodes, &error);
+    QBENCHMARK {
+        Graph graph;
+        for (int i = 0; i < kNodes; ++i) {
+            graph.addNode(Attributes());
+        }
+        graph.addEdges(edges);
+        QCOMPARE(graph.numEdges(), kEdges);
+    }
+}
+
+QTEST_MAIN(BenchEdgeList)
+#include "bench_edgelist.moc"
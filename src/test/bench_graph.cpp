@@ -0,0 +1,110 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <iterator>
+#include <abstractgraph.h>
+
+using namespace evoplex;
+
+// Compares Node::randNeighbour with walking the edges map,
+// which was how a random neighbour used to be picked.
+class BenchGraph: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase() {}
+    void bench_randNeighbour_data();
+    void bench_randNeighbour();
+    void bench_randNeighbour_map_data();
+    void bench_randNeighbour_map();
+
+private:
+    class Graph : public AbstractGraph
+    {
+    public:
+        Graph() : AbstractGraph("bench") {}
+        bool init() override { return true; }
+        void reset() override {}
+    };
+
+    static const int kDraws = 10000;
+    Graph m_graph;
+    std::vector<NodePtr> m_hubs; // hubs of degree 10, 100, ..., 10^5
+};
+
+void BenchGraph::initTestCase()
+{
+    for (int degree = 10; degree <= 100000; degree *= 10) {
+        const int hub = m_graph.addNode(Attributes())->id();
+        for (int i = 0; i < degree; ++i) {
+            m_graph.addEdge(hub, m_graph.addNode(Attributes())->id());
+        }
+        m_hubs.emplace_back(m_graph.node(hub));
+    }
+}
+
+void BenchGraph::bench_randNeighbour_data()
+{
+    QTest::addColumn<int>("hub");
+    for (int i = 0; i < static_cast<int>(m_hubs.size()); ++i) {
+        QTest::newRow(qPrintable(QString("degree %1").arg(m_hubs[i]->outDegree()))) << i;
+    }
+}
+
+void BenchGraph::bench_randNeighbour()
+{
+    QFETCH(int, hub);
+    const NodePtr& node = m_hubs[hub];
+    PRG prg(0);
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < kDraws; ++i) {
+            sum += node->randNeighbour(&prg)->id();
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+void BenchGraph::bench_randNeighbour_map_data()
+{
+    bench_randNeighbour_data();
+}
+
+void BenchGraph::bench_randNeighbour_map()
+{
+    QFETCH(int, hub);
+    const NodePtr& node = m_hubs[hub];
+    const Edges& edges = node->outEdges();
+    PRG prg(0);
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < kDraws; ++i) {
+            auto it = std::next(edges.cbegin(), prg.randI(static_cast<int>(edges.size()) - 1));
+            sum += it->second->neighbour()->id();
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+QTEST_MAIN(BenchGraph)
+#include "bench_graph.moc"
@@ -0,0 +1,106 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <core/filewriter.h>
+
+using namespace evoplex;
+
+// Measures how fast the FileWriter writes the outputs of a trial in each
+// format, and how large the files are. The rows are typical outputs, i.e.,
+// mostly doubles and a few integers.
+class BenchOutput: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() { QVERIFY(m_dir.isValid()); }
+    void cleanupTestCase() {}
+    void bench_csv() { bench(FileWriter::CSV, "csv"); }
+    void bench_bin() { bench(FileWriter::Binary, "bin"); }
+    void bench_binz() { bench(FileWriter::CompressedBinary, "binz"); }
+
+private:
+    static const int kCols = 16;
+    static const int kRowsPerBlock = 256;
+    static const int kBlocks = 400;
+    QTemporaryDir m_dir;
+
+    void bench(FileWriter::Format format, const QString& name);
+    static FileWriter::Block block(int firstStep);
+};
+
+FileWriter::Block BenchOutput::block(int firstStep)
+{
+    FileWriter::Block b;
+    b.numCols = kCols;
+    b.hasSteps = true;
+    b.cells.reserve(kCols * kRowsPerBlock);
+    for (int step = firstStep; step < firstStep + kRowsPerBlock; ++step) {
+        b.steps.emplace_back(step);
+        for (int col = 0; col < kCols; ++col) {
+            if (col % 4 == 0) {
+                b.cells.emplace_back(step * col);
+            } else {
+                b.cells.emplace_back(step / (col + 0.7));
+            }
+        }
+    }
+    return b;
+}
+
+void BenchOutput::bench(FileWriter::Format format, const QString& name)
+{
+    const QString fpath = m_dir.path() + "/bench." + name;
+    QByteArray header;
+    for (int col = 0; col < kCols; ++col) {
+        header += "column" + QByteArray::number(col) + (col + 1 < kCols ? "," : "");
+    }
+    if (format == FileWriter::CSV) {
+        header = "step," + header + "\n";
+    }
+
+    qint64 msecs = 0;
+    int iterations = 0;
+    QBENCHMARK {
+        FileWriter writer;
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY(writer.create(fpath, header, format));
+        for (int i = 0; i < kBlocks; ++i) {
+            QVERIFY(writer.write(fpath, block(i * kRowsPerBlock)));
+        }
+        QVERIFY(writer.close(fpath));
+        msecs += timer.elapsed();
+        ++iterations;
+    }
+
+    const double cells = static_cast<double>(kCols) * kRowsPerBlock * kBlocks;
+    const double rawMB = iterations * cells * sizeof(double) / (1024 * 1024);
+    const double fileMB = QFileInfo(fpath).size() / (1024.0 * 1024.0);
+    qDebug() << name << "file size (MB):" << fileMB
+             << "throughput (MB/s of raw cells):" << rawMB * 1000 / qMax<qint64>(msecs, 1);
+}
+
+QTEST_MAIN(BenchOutput)
+#include "bench_output.moc"
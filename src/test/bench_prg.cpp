@@ -0,0 +1,121 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <random>
+#include <vector>
+#include <prg.h>
+
+using namespace evoplex;
+
+// Compares the PRG's samplers and bulk APIs with drawing numbers
+// through a std distribution constructed on every call.
+class BenchPRG: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void bench_randI_mt19937();
+    void bench_randI();
+    void bench_intSampler();
+    void bench_fillI();
+    void bench_randD_mt19937();
+    void bench_randD();
+    void bench_fillD();
+
+private:
+    static const int kN = 1 << 20;
+    std::vector<int> m_ints = std::vector<int>(kN);
+    std::vector<double> m_doubles = std::vector<double>(kN);
+};
+
+void BenchPRG::bench_randI_mt19937()
+{
+    std::mt19937 mt(0);
+    QBENCHMARK {
+        for (int i = 0; i < kN; ++i) {
+            std::uniform_int_distribution<int> dis(0, 99);
+            m_ints[i] = dis(mt);
+        }
+    }
+}
+
+void BenchPRG::bench_randI()
+{
+    PRG prg(0);
+    QBENCHMARK {
+        for (int i = 0; i < kN; ++i) {
+            m_ints[i] = prg.randI(0, 99);
+        }
+    }
+}
+
+void BenchPRG::bench_intSampler()
+{
+    PRG prg(0);
+    IntSampler sampler(0, 99);
+    QBENCHMARK {
+        for (int i = 0; i < kN; ++i) {
+            m_ints[i] = sampler(prg);
+        }
+    }
+}
+
+void BenchPRG::bench_fillI()
+{
+    PRG prg(0);
+    QBENCHMARK {
+        prg.fillI(m_ints.data(), kN, 0, 99);
+    }
+}
+
+void BenchPRG::bench_randD_mt19937()
+{
+    std::mt19937 mt(0);
+    QBENCHMARK {
+        for (int i = 0; i < kN; ++i) {
+            std::uniform_real_distribution<double> dis(0.0, 1.0);
+            m_doubles[i] = dis(mt);
+        }
+    }
+}
+
+void BenchPRG::bench_randD()
+{
+    PRG prg(0);
+    QBENCHMARK {
+        for (int i = 0; i < kN; ++i) {
+            m_doubles[i] = prg.randD();
+        }
+    }
+}
+
+void BenchPRG::bench_fillD()
+{
+    PRG prg(0);
+    QBENCHMARK {
+        prg.fillD(m_doubles.data(), kN);
+    }
+}
+
+QTEST_MAIN(BenchPRG)
+#include "bench_prg.moc"
@@ -0,0 +1,152 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <atomic>
+#include <cstdlib>
+#include <forward_list>
+#include <new>
+#include <unordered_map>
+#include <vector>
+#include <value.h>
+
+using namespace evoplex;
+
+// counts the heap allocations made by the benchmarks
+static std::atomic<size_t> s_allocations(0);
+
+void* operator new(size_t size)
+{
+    ++s_allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+// Measures the cost of the operations the output pipeline performs on
+// Values, i.e., building, copying and counting rows of mixed types.
+// Besides the time, each benchmark reports the heap allocations per row.
+class BenchValue: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase() {}
+    void bench_copyRows();
+    void bench_growRows();
+    void bench_countStrings();
+
+private:
+    static const int kCols = 32;
+    static const int kRows = 10000;
+    Values m_row;
+
+    static void report(size_t allocations, int rows);
+};
+
+void BenchValue::initTestCase()
+{
+    const char* strs[] = { "cooperator", "defector", "a longer string than the others" };
+    for (int i = 0; i < kCols; ++i) {
+        switch (i % 3) {
+        case 0: m_row.emplace_back(i); break;
+        case 1: m_row.emplace_back(i * 0.5); break;
+        default: m_row.emplace_back(strs[i % 3]);
+        }
+    }
+}
+
+void BenchValue::report(size_t allocations, int rows)
+{
+    qDebug() << "heap allocations per row:" << static_cast<double>(allocations) / rows;
+}
+
+// like Output::updateCaches: one row of Values per step
+void BenchValue::bench_copyRows()
+{
+    std::forward_list<Values> rows;
+    size_t allocations = 0;
+    int n = 0;
+    QBENCHMARK {
+        rows.clear();
+        const size_t before = s_allocations;
+        auto last = rows.before_begin();
+        for (int r = 0; r < kRows; ++r) {
+            Values row;
+            row.reserve(kCols);
+            for (const Value& v : m_row) {
+                row.emplace_back(v);
+            }
+            last = rows.emplace_after(last, std::move(row));
+        }
+        allocations += s_allocations - before;
+        n += kRows;
+    }
+    report(allocations, n);
+}
+
+// growing a vector relocates the Values
+void BenchValue::bench_growRows()
+{
+    size_t allocations = 0;
+    int n = 0;
+    QBENCHMARK {
+        const size_t before = s_allocations;
+        Values values;
+        for (int r = 0; r < kRows; ++r) {
+            values.insert(values.end(), m_row.begin(), m_row.end());
+        }
+        allocations += s_allocations - before;
+        n += kRows;
+    }
+    report(allocations, n);
+}
+
+// like Stats::count: a histogram of string values
+void BenchValue::bench_countStrings()
+{
+    std::unordered_map<Value, int> hist;
+    for (const Value& v : m_row) {
+        hist.insert({v, 0});
+    }
+    size_t allocations = 0;
+    int n = 0;
+    QBENCHMARK {
+        const size_t before = s_allocations;
+        for (int r = 0; r < kRows; ++r) {
+            for (const Value& v : m_row) {
+                ++hist[v];
+            }
+        }
+        allocations += s_allocations - before;
+        n += kRows;
+    }
+    report(allocations, n);
+}
+
+QTEST_MAIN(BenchValue)
+#include "bench_value.moc"
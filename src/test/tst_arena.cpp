@@ -0,0 +1,106 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <cstdint>
+#include <arena.h>
+#include <node.h>
+
+using namespace evoplex;
+
+class TestArena: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_allocate();
+    void tst_recycle();
+    void tst_sharedOwnership();
+};
+
+void TestArena::tst_allocate()
+{
+    Arena arena;
+    QCOMPARE(arena.bytesReserved(), size_t(0));
+
+    char* a = static_cast<char*>(arena.allocate(10));
+    char* b = static_cast<char*>(arena.allocate(10));
+    QVERIFY(a && b && a != b);
+    QCOMPARE(reinterpret_cast<std::uintptr_t>(a) % 16, std::uintptr_t(0));
+    QVERIFY(arena.bytesReserved() > 0);
+
+    void* c = arena.allocate(100, 64);
+    QCOMPARE(reinterpret_cast<std::uintptr_t>(c) % 64, std::uintptr_t(0));
+
+    // larger than a block
+    const size_t reserved = arena.bytesReserved();
+    void* d = arena.allocate(8 * 1024 * 1024);
+    QVERIFY(d);
+    QVERIFY(arena.bytesReserved() >= reserved + 8 * 1024 * 1024);
+}
+
+// small blocks are reused by allocations of the same size class
+void TestArena::tst_recycle()
+{
+    Arena arena;
+    void* a = arena.allocate(24);
+    arena.deallocate(a, 24);
+    QCOMPARE(arena.allocate(32), a);
+
+    const size_t reserved = arena.bytesReserved();
+    for (int i = 0; i < 100000; ++i) {
+        arena.deallocate(arena.allocate(48), 48);
+    }
+    QCOMPARE(arena.bytesReserved(), reserved);
+
+    // an over-aligned block is recycled as a whole block of its class
+    char* b = static_cast<char*>(arena.allocate(20, 64));
+    QCOMPARE(reinterpret_cast<std::uintptr_t>(b) % 64, std::uintptr_t(0));
+    char* c = static_cast<char*>(arena.allocate(600, 4));
+    arena.deallocate(b, 20);
+    char* d = static_cast<char*>(arena.allocate(32));
+    QVERIFY(d + 32 <= c || d >= c + 600);
+}
+
+// objects created with std::allocate_shared keep the arena alive
+void TestArena::tst_sharedOwnership()
+{
+    Attributes attrs(1);
+    attrs.replace(0, "a", 7);
+
+    NodePtr node;
+    std::weak_ptr<Arena> weak;
+    {
+        ArenaPtr arena = std::make_shared<Arena>();
+        weak = arena;
+        node = makeNode<UNode>(arena, 0, attrs, 1, 2);
+        QVERIFY(node->clone(arena));
+    }
+    QVERIFY(!weak.expired());
+    QCOMPARE(node->attr(0), Value(7));
+    QCOMPARE(node->y(), 2);
+    node.reset();
+    QVERIFY(weak.expired());
+}
+
+QTEST_MAIN(TestArena)
+#include "tst_arena.moc"
@@ -0,0 +1,354 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <cmath>
+#include <attributecolumns.h>
+
+using namespace evoplex;
+
+class TestAttributeColumns: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_empty();
+    void tst_appendRow();
+    void tst_setValue();
+    void tst_convert();
+    void tst_removeRow();
+    void tst_doubleBuffer();
+    void tst_copyOnWrite();
+    void tst_handles();
+    void tst_histograms();
+    void tst_histogramsNearlyEqual();
+
+private: // auxiliary functions
+    Attributes _row(int i, double d, const char* s);
+};
+
+Attributes TestAttributeColumns::_row(int i, double d, const char* s)
+{
+    Attributes a;
+    a.push_back("i", i);
+    a.push_back("d", d);
+    a.push_back("s", s);
+    return a;
+}
+
+void TestAttributeColumns::tst_empty()
+{
+    AttributeColumns c;
+    QCOMPARE(c.numRows(), 0);
+    QCOMPARE(c.numColumns(), 0);
+    QVERIFY(c.names().empty());
+    QCOMPARE(c.indexOf("abc"), -1);
+    QVERIFY_EXCEPTION_THROWN(c.type(0), std::out_of_range);
+}
+
+// the first row defines the layout of the columns
+void TestAttributeColumns::tst_appendRow()
+{
+    AttributeColumns c;
+    QCOMPARE(c.appendRow(_row(1, 1.5, "a")), 0);
+    QCOMPARE(c.appendRow(_row(2, 2.5, "b")), 1);
+    QCOMPARE(c.numRows(), 2);
+    QCOMPARE(c.numColumns(), 3);
+
+    QCOMPARE(c.indexOf("d"), 1);
+    QCOMPARE(c.name(2), QString("s"));
+    QCOMPARE(c.type(0), Value::INT);
+    QCOMPARE(c.type(1), Value::DOUBLE);
+    QCOMPARE(c.type(2), Value::STRING);
+
+    QCOMPARE(c.value(1, 0), Value(2));
+    QCOMPARE(c.value(0, 1), Value(1.5));
+    QCOMPARE(c.value(1, 2), Value("b"));
+
+    // fixed-width columns are contiguous
+    const int* ints = c.data<int>(0);
+    QCOMPARE(ints[0], 1);
+    QCOMPARE(ints[1], 2);
+
+    const Attributes a = c.row(1);
+    QCOMPARE(a.names(), c.names());
+    QCOMPARE(a.value("i"), Value(2));
+    QCOMPARE(a.value("s"), Value("b"));
+}
+
+void TestAttributeColumns::tst_setValue()
+{
+    AttributeColumns c;
+    c.appendRow(_row(1, 1.5, "a"));
+    c.setValue(0, 0, 10);
+    c.setValue(0, 2, "z");
+    QCOMPARE(c.value(0, 0), Value(10));
+    QCOMPARE(c.value(0, 2), Value("z"));
+
+    c.data<double>(1)[0] = 3.0;
+    QCOMPARE(c.value(0, 1), Value(3.0));
+}
+
+// numeric values are converted to the type of the column
+void TestAttributeColumns::tst_convert()
+{
+    AttributeColumns c;
+    c.appendRow(_row(1, 1.5, "a"));
+    c.setValue(0, 1, Value(0));
+    QCOMPARE(c.value(0, 1), Value(0.0));
+    c.setValue(0, 1, Value(7));
+    QCOMPARE(c.value(0, 1), Value(7.0));
+    c.setValue(0, 0, Value(2.9));
+    QCOMPARE(c.value(0, 0), Value(2));
+    c.setValue(0, 0, Value(true));
+    QCOMPARE(c.value(0, 0), Value(1));
+
+    // as well as the values of new rows
+    Attributes a = _row(2, 0, "b");
+    a.setValue(1, Value(-3));
+    QCOMPARE(c.appendRow(a), 1);
+    QCOMPARE(c.value(1, 1), Value(-3.0));
+
+    // other values are not written
+    c.setValue(0, 1, Value("x"));
+    QCOMPARE(c.value(0, 1), Value(7.0));
+    c.setValue(0, 1, Value());
+    QCOMPARE(c.value(0, 1), Value(7.0));
+}
+
+// removing a row moves the last one into its place
+void TestAttributeColumns::tst_removeRow()
+{
+    AttributeColumns c;
+    for (int i = 0; i < 4; ++i) {
+        c.appendRow(_row(i, i * 0.5, QString::number(i).toLocal8Bit().constData()));
+    }
+
+    c.removeRow(1);
+    QCOMPARE(c.numRows(), 3);
+    QCOMPARE(c.value(1, 0), Value(3));
+    QCOMPARE(c.value(1, 1), Value(1.5));
+    QCOMPARE(c.value(1, 2), Value("3"));
+
+    c.removeRow(2); // last row
+    QCOMPARE(c.numRows(), 2);
+    QCOMPARE(c.value(0, 0), Value(0));
+    QCOMPARE(c.value(1, 0), Value(3));
+
+    c.removeRow(0);
+    c.removeRow(0);
+    QCOMPARE(c.numRows(), 0);
+}
+
+void TestAttributeColumns::tst_doubleBuffer()
+{
+    AttributeColumns c;
+    c.appendRow(_row(1, 1.5, "a"));
+    c.appendRow(_row(2, 2.5, "b"));
+    QVERIFY(!c.isDoubleBuffered(0));
+
+    // the back buffer starts as a copy of the front one
+    c.setDoubleBuffered(0, true);
+    QVERIFY(c.isDoubleBuffered(0));
+    QCOMPARE(c.backData<int>(0)[1], 2);
+
+    // writing into the back buffer does not change the current state
+    c.backData<int>(0)[0] = 10;
+    c.backData<int>(0)[1] = 20;
+    QCOMPARE(c.value(0, 0), Value(1));
+
+    c.swapBuffers();
+    QCOMPARE(c.value(0, 0), Value(10));
+    QCOMPARE(c.value(1, 0), Value(20));
+    QCOMPARE(c.backData<int>(0)[0], 1);
+    QCOMPARE(c.value(0, 1), Value(1.5)); // not double-buffered
+
+    // rows are added/removed in both buffers
+    c.appendRow(_row(3, 3.5, "c"));
+    QCOMPARE(c.backData<int>(0)[2], 3);
+    c.removeRow(0);
+    QCOMPARE(c.value(0, 0), Value(3));
+    QCOMPARE(c.backData<int>(0)[0], 3);
+
+    c.setDoubleBuffered(0, false);
+    QVERIFY(!c.isDoubleBuffered(0));
+    c.swapBuffers();
+    QCOMPARE(c.value(0, 0), Value(3));
+}
+
+// copies share the columns until they change them
+void TestAttributeColumns::tst_copyOnWrite()
+{
+    AttributeColumns a;
+    a.appendRow(_row(1, 1.5, "a"));
+    a.appendRow(_row(2, 2.5, "b"));
+
+    AttributeColumns b = a;
+    QVERIFY(a.isShared(0) && a.isShared(1) && a.isShared(2));
+    const AttributeColumns& ca = a;
+    const AttributeColumns& cb = b;
+    QCOMPARE(cb.data<int>(0), ca.data<int>(0));
+
+    b.setValue(0, 0, Value(10));
+    b.setValue(1, 2, Value("z"));
+    QVERIFY(!b.isShared(0) && !a.isShared(0));
+    QVERIFY(b.isShared(1));
+    QVERIFY(!b.isShared(2));
+    QCOMPARE(a.value(0, 0), Value(1));
+    QCOMPARE(b.value(0, 0), Value(10));
+    QCOMPARE(a.value(1, 2), Value("b"));
+    QCOMPARE(b.value(1, 2), Value("z"));
+
+    // structural changes detach all columns
+    AttributeColumns c = a;
+    c.removeRow(0);
+    QCOMPARE(a.numRows(), 2);
+    QCOMPARE(a.value(0, 1), Value(1.5));
+    QCOMPARE(c.value(0, 1), Value(2.5));
+
+    // so does swapping the buffers
+    AttributeColumns d = a;
+    d.setDoubleBuffered(0, true);
+    d.backData<int>(0)[0] = 7;
+    d.swapBuffers();
+    QCOMPARE(d.value(0, 0), Value(7));
+    QCOMPARE(a.value(0, 0), Value(1));
+}
+
+// handles are resolved once and then access the columns directly
+void TestAttributeColumns::tst_handles()
+{
+    AttributeColumns c;
+    c.appendRow(_row(1, 1.5, "a"));
+    c.appendRow(_row(2, 2.5, "b"));
+
+    QCOMPARE(c.indexOf(QString("d")), 1);
+    QCOMPARE(c.indexOf(QString("x")), -1);
+    QCOMPARE(c.indexOf("d"), 1);
+    QCOMPARE(c.indexOf("x"), -1);
+
+    // names are not restricted to latin-1
+    AttributeColumns u;
+    Attributes a;
+    a.push_back("i", 1);
+    a.push_back(QString::fromUtf8("\xce\xb2eta"), 0.5);
+    u.appendRow(a);
+    QCOMPARE(u.indexOf("\xce\xb2eta"), 1);
+    QCOMPARE(a.indexOf("\xce\xb2eta"), 1);
+
+    AttrHandle<int> hi = c.handle<int>("i");
+    AttrHandle<double> hd = c.handle<double>("d");
+    QVERIFY(hi.isValid());
+    QVERIFY(hd.isValid());
+    QCOMPARE(hd.column(), 1);
+    QCOMPARE(c.value(1, hi), 2);
+    QCOMPARE(c.value(0, hd), 1.5);
+
+    c.setValue(0, hi, 7);
+    QCOMPARE(c.value(0, 0), Value(7));
+
+    // unknown names, wrong types and non-fixed-width columns are rejected
+    QVERIFY(!c.handle<int>("x").isValid());
+    QVERIFY(!c.handle<double>("i").isValid());
+    QVERIFY(!c.handle<int>("s").isValid());
+    QVERIFY(!AttrHandle<int>().isValid());
+
+    c.clear();
+    QCOMPARE(c.indexOf(QString("d")), -1);
+}
+
+// the counts are updated in place, unless the raw arrays are written
+void TestAttributeColumns::tst_histograms()
+{
+    AttributeColumns c;
+    c.appendRow(_row(1, 1.5, "a"));
+    c.appendRow(_row(2, 2.5, "b"));
+    c.appendRow(_row(1, 3.5, "a"));
+    QVERIFY(!c.hasHistogram(0));
+
+    c.setHistogramEnabled(0, true);
+    c.setHistogramEnabled(2, true);
+    QVERIFY(c.hasHistogram(0));
+    QCOMPARE(c.histograms().count(0, Value(1)), 2);
+    QCOMPARE(c.histograms().count(0, Value(2)), 1);
+    QCOMPARE(c.histograms().count(2, Value("a")), 2);
+
+    c.setValue(1, 0, Value(1));
+    QCOMPARE(c.histograms().count(0, Value(1)), 3);
+    QCOMPARE(c.histograms().count(0, Value(2)), 0);
+
+    c.setValue(0, c.handle<int>("i"), 5);
+    QCOMPARE(c.histograms().count(0, Value(1)), 2);
+    QCOMPARE(c.histograms().count(0, Value(5)), 1);
+
+    c.appendRow(_row(5, 4.5, "c"));
+    QCOMPARE(c.histograms().count(0, Value(5)), 2);
+    c.removeRow(0);
+    QCOMPARE(c.histograms().count(0, Value(5)), 1);
+    QCOMPARE(c.histograms().count(2, Value("a")), 1);
+
+    // the raw arrays are not tracked, so the histogram is rebuilt
+    c.data<int>(0)[0] = 7;
+    QCOMPARE(c.histograms().count(0, Value(7)), 1);
+    QCOMPARE(c.histograms().count(0, Value(5)), 0);
+
+    c.setDoubleBuffered(0, true);
+    for (int row = 0; row < c.numRows(); ++row) {
+        c.backData<int>(0)[row] = 9;
+    }
+    c.swapBuffers();
+    QCOMPARE(c.histograms().count(0, Value(9)), c.numRows());
+
+    c.setHistogramEnabled(0, false);
+    QVERIFY(!c.hasHistogram(0));
+    QVERIFY(c.hasHistogram(2));
+}
+
+// doubles are counted bit-exactly, even if Value::operator==() says they are equal
+void TestAttributeColumns::tst_histogramsNearlyEqual()
+{
+    const double a = 0.1;
+    const double b = std::nextafter(a, 1.0);
+    QVERIFY(Value(a) == Value(b));
+
+    AttributeColumns c;
+    c.appendRow(_row(1, a, "a"));
+    c.appendRow(_row(2, a, "b"));
+    c.setHistogramEnabled(1, true);
+    QCOMPARE(c.histograms().count(1, Value(a)), 2);
+
+    c.setValue(0, 1, Value(b));
+    QCOMPARE(c.histograms().count(1, Value(a)), 1);
+    QCOMPARE(c.histograms().count(1, Value(b)), 1);
+
+    c.setValue(0, 1, Value(a));
+    QCOMPARE(c.histograms().count(1, Value(a)), 2);
+    QCOMPARE(c.histograms().count(1, Value(b)), 0);
+
+    c.setValue(1, 1, Value(b));
+    c.removeRow(1);
+    QCOMPARE(c.histograms().count(1, Value(a)), 1);
+    QCOMPARE(c.histograms().count(1, Value(b)), 0);
+}
+
+QTEST_MAIN(TestAttributeColumns)
+#include "tst_attributecolumns.moc"
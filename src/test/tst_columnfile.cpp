@@ -0,0 +1,264 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <vector>
+#include <columnfile.h>
+#include <core/filewriter.h>
+
+using namespace evoplex;
+
+class TestColumnFile: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() { QVERIFY(m_dir.isValid()); }
+    void cleanupTestCase() {}
+    void tst_roundTrip();
+    void tst_mixedAndEmpty();
+    void tst_missingIndex();
+    void tst_toCsv();
+    void tst_fileWriter();
+    void tst_invalid();
+
+private:
+    QTemporaryDir m_dir;
+
+    static void writeFile(const QString& fpath, const QByteArray& bytes);
+    static QByteArray readAll(const QString& fpath);
+};
+
+void TestColumnFile::writeFile(const QString& fpath, const QByteArray& bytes)
+{
+    QFile file(fpath);
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+    QCOMPARE(file.write(bytes), static_cast<qint64>(bytes.size()));
+}
+
+QByteArray TestColumnFile::readAll(const QString& fpath)
+{
+    QFile file(fpath);
+    if (!file.open(QFile::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+void TestColumnFile::tst_roundTrip()
+{
+    for (bool compressed : {false, true}) {
+        const QString fpath = m_dir.path() + QString("/roundTrip%1.evb").arg(compressed);
+        ColumnFileWriter writer(compressed);
+        QCOMPARE(writer.isCompressed(), compressed);
+
+        // three columns (int, double, bool) and two chunks
+        QByteArray bytes = writer.begin("a,b,c");
+        std::vector<int> steps;
+        Values cells;
+        for (int step = 0; step < 100; ++step) {
+            steps.emplace_back(step);
+            cells.emplace_back(step);
+            cells.emplace_back(step * 0.5);
+            cells.emplace_back(step % 2 == 0);
+        }
+        bytes += writer.chunk(3, steps, cells);
+        bytes += writer.chunk(3, {100}, {Value(-1), Value(1e-300), Value(false)});
+        bytes += writer.end();
+        writeFile(fpath, bytes);
+
+        QString error;
+        ColumnFileReader reader;
+        QVERIFY(reader.open(fpath, error));
+        QVERIFY(error.isEmpty());
+        QCOMPARE(reader.header(), QString("a,b,c"));
+        QCOMPARE(reader.isCompressed(), compressed);
+        QCOMPARE(reader.numChunks(), 2);
+        QCOMPARE(reader.numRows(), static_cast<qint64>(101));
+        QCOMPARE(reader.chunkInfo(0).numRows, 100);
+        QCOMPARE(reader.chunkInfo(0).firstStep, 0);
+        QCOMPARE(reader.chunkInfo(0).lastStep, 99);
+        QCOMPARE(reader.chunkInfo(1).firstStep, 100);
+        QCOMPARE(reader.chunkInfo(1).lastStep, 100);
+
+        int numCols = 0;
+        std::vector<int> rSteps;
+        Values rCells;
+        QVERIFY(reader.readChunk(0, numCols, rSteps, rCells, error));
+        QCOMPARE(numCols, 3);
+        QVERIFY(rSteps == steps);
+        QVERIFY(rCells == cells);
+
+        QVERIFY(reader.readChunk(1, numCols, rSteps, rCells, error));
+        QVERIFY(rSteps == std::vector<int>({100}));
+        QCOMPARE(rCells.at(0), Value(-1));
+        QCOMPARE(rCells.at(1), Value(1e-300));
+        QCOMPARE(rCells.at(2), Value(false));
+    }
+}
+
+// columns with mixed types are stored as strings; empty cells remain empty
+void TestColumnFile::tst_mixedAndEmpty()
+{
+    const QString fpath = m_dir.path() + "/mixed.evb";
+    ColumnFileWriter writer(false);
+    QByteArray bytes = writer.begin("mixed,sparse,empty,chars");
+    bytes += writer.chunk(4, {0, 5, 10}, {
+        Value(1),      Value(),     Value(), Value('x'),
+        Value("two"),  Value(3.5),  Value(), Value(),
+        Value(true),   Value(),     Value(), Value('z') });
+    bytes += writer.end();
+    writeFile(fpath, bytes);
+
+    QString error;
+    ColumnFileReader reader;
+    QVERIFY(reader.open(fpath, error));
+    int numCols = 0;
+    std::vector<int> steps;
+    Values cells;
+    QVERIFY(reader.readChunk(0, numCols, steps, cells, error));
+    QCOMPARE(numCols, 4);
+    QVERIFY(steps == std::vector<int>({0, 5, 10}));
+    QCOMPARE(cells.size(), static_cast<size_t>(12));
+
+    QCOMPARE(cells.at(0), Value("1"));
+    QCOMPARE(cells.at(4), Value("two"));
+    QCOMPARE(cells.at(8), Value("1"));
+
+    QVERIFY(!cells.at(1).isValid());
+    QCOMPARE(cells.at(5), Value(3.5));
+    QVERIFY(!cells.at(9).isValid());
+
+    QVERIFY(!cells.at(2).isValid());
+    QVERIFY(!cells.at(6).isValid());
+    QVERIFY(!cells.at(10).isValid());
+
+    QCOMPARE(cells.at(3), Value('x'));
+    QVERIFY(!cells.at(7).isValid());
+    QCOMPARE(cells.at(11), Value('z'));
+}
+
+// a file which was not closed properly has no index, but it can be read
+void TestColumnFile::tst_missingIndex()
+{
+    for (bool compressed : {false, true}) {
+        const QString fpath = m_dir.path() + QString("/missingIndex%1.evb").arg(compressed);
+        ColumnFileWriter writer(compressed);
+        QByteArray bytes = writer.begin("a");
+        bytes += writer.chunk(1, {1, 2}, {Value(10), Value(20)});
+        bytes += writer.chunk(1, {3, 4, 5}, {Value(30), Value(40), Value(50)});
+        const QByteArray complete = bytes;
+        bytes += writer.chunk(1, {6}, {Value(60)});
+        bytes.resize(bytes.size() - 1); // the last chunk is truncated
+        writeFile(fpath, bytes);
+
+        QString error;
+        ColumnFileReader reader;
+        QVERIFY(reader.open(fpath, error));
+        QCOMPARE(reader.numChunks(), 2);
+        QCOMPARE(reader.numRows(), static_cast<qint64>(5));
+        QCOMPARE(reader.chunkInfo(1).firstStep, 3);
+        QCOMPARE(reader.chunkInfo(1).lastStep, 5);
+
+        int numCols = 0;
+        std::vector<int> steps;
+        Values cells;
+        QVERIFY(reader.readChunk(1, numCols, steps, cells, error));
+        QVERIFY(steps == std::vector<int>({3, 4, 5}));
+        QCOMPARE(cells.at(2), Value(50));
+
+        writeFile(fpath, complete);
+        QVERIFY(reader.open(fpath, error));
+        QCOMPARE(reader.numChunks(), 2);
+    }
+}
+
+void TestColumnFile::tst_toCsv()
+{
+    const QString fpath = m_dir.path() + "/toCsv.evb";
+    ColumnFileWriter writer(true);
+    QByteArray bytes = writer.begin("a,b");
+    bytes += writer.chunk(2, {0, 10}, {Value(1), Value(0.5), Value("x"), Value()});
+    bytes += writer.chunk(2, {20}, {Value(true), Value('c')});
+    bytes += writer.end();
+    writeFile(fpath, bytes);
+
+    QString error;
+    ColumnFileReader reader;
+    QVERIFY(reader.open(fpath, error));
+    const QString csvPath = m_dir.path() + "/toCsv.csv";
+    QVERIFY(reader.toCsv(csvPath, error));
+    QCOMPARE(readAll(csvPath), QByteArray("step,a,b\n0,1,0.5\n10,x,\n20,1,c\n"));
+}
+
+// the FileWriter encodes each block as a chunk
+void TestColumnFile::tst_fileWriter()
+{
+    const QString fpath = m_dir.path() + "/fileWriter.evb";
+    {
+        FileWriter fw;
+        QVERIFY(fw.create(fpath, "a,b", FileWriter::CompressedBinary));
+        for (int i = 0; i < 10; ++i) {
+            FileWriter::Block block;
+            block.numCols = 2;
+            block.steps = {2 * i, 2 * i + 1};
+            block.cells = {Value(i), Value(i * 0.25), Value(-i), Value()};
+            QVERIFY(fw.write(fpath, std::move(block)));
+        }
+        QVERIFY(fw.close(fpath));
+    }
+
+    QString error;
+    ColumnFileReader reader;
+    QVERIFY(reader.open(fpath, error));
+    QCOMPARE(reader.header(), QString("a,b"));
+    QVERIFY(reader.isCompressed());
+    QCOMPARE(reader.numChunks(), 10);
+    QCOMPARE(reader.numRows(), static_cast<qint64>(20));
+
+    int numCols = 0;
+    std::vector<int> steps;
+    Values cells;
+    QVERIFY(reader.readChunk(9, numCols, steps, cells, error));
+    QVERIFY(steps == std::vector<int>({18, 19}));
+    QCOMPARE(cells.at(0), Value(9));
+    QCOMPARE(cells.at(1), Value(2.25));
+    QCOMPARE(cells.at(2), Value(-9));
+    QVERIFY(!cells.at(3).isValid());
+}
+
+void TestColumnFile::tst_invalid()
+{
+    QString error;
+    ColumnFileReader reader;
+    QVERIFY(!reader.open(m_dir.path() + "/doesNotExist.evb", error));
+    QVERIFY(!error.isEmpty());
+
+    const QString fpath = m_dir.path() + "/invalid.evb";
+    writeFile(fpath, "a,b\n1,2\n");
+    error.clear();
+    QVERIFY(!reader.open(fpath, error));
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_MAIN(TestColumnFile)
+#include "tst_columnfile.moc"
@@ -0,0 +1,193 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <edgelist.h>
+#include <core/textfile.h>
+
+using namespace evoplex;
+
+class TestEdgeList: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() { QVERIFY(m_dir.isValid()); }
+    void cleanupTestCase() {}
+    void tst_parseInt();
+    void tst_chunks();
+    void tst_fromFile();
+    void tst_manyChunks();
+    void tst_invalid();
+
+private:
+    QTemporaryDir m_dir;
+
+    QString writeFile(const QString& name, const QByteArray& bytes);
+};
+
+QString TestEdgeList::writeFile(const QString& name, const QByteArray& bytes)
+{
+    const QString fpath = m_dir.path() + "/" + name;
+    QFile file(fpath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(bytes) != bytes.size()) {
+        return QString();
+    }
+    return fpath;
+}
+
+void TestEdgeList::tst_parseInt()
+{
+    auto parse = [](const char* str, int& v) {
+        const char* p = str;
+        const bool ok = TextFile::parseInt(p, str + strlen(str), v);
+        return ok ? static_cast<int>(p - str) : -1; // consumed chars
+    };
+    int v = 0;
+    QCOMPARE(parse("0", v), 1);
+    QCOMPARE(v, 0);
+    QCOMPARE(parse("123,4", v), 3);
+    QCOMPARE(v, 123);
+    QCOMPARE(parse(" -42 ,", v), 5);
+    QCOMPARE(v, -42);
+    QCOMPARE(parse("+7", v), 2);
+    QCOMPARE(v, 7);
+    QCOMPARE(parse("2147483647", v), 10);
+    QCOMPARE(v, 2147483647);
+    QCOMPARE(parse("-2147483648", v), 11);
+    QCOMPARE(v, -2147483647 - 1);
+    QCOMPARE(parse("2147483648", v), -1);
+    QCOMPARE(parse("", v), -1);
+    QCOMPARE(parse("-", v), -1);
+    QCOMPARE(parse("a1", v), -1);
+}
+
+void TestEdgeList::tst_chunks()
+{
+    const QString fpath = writeFile("chunks.csv", "ab\ncd\r\nef\n\ngh");
+    TextFile file;
+    QVERIFY(file.open(fpath));
+    QCOMPARE(file.size(), static_cast<qint64>(13));
+
+    // chunks end at line breaks, even if they get larger
+    const std::vector<Span<char>> chunks = file.chunks(file.begin(), 2);
+    QCOMPARE(chunks.size(), static_cast<size_t>(4));
+    QCOMPARE(QByteArray(chunks[0].data(), chunks[0].size()), QByteArray("ab\n"));
+    QCOMPARE(QByteArray(chunks[1].data(), chunks[1].size()), QByteArray("cd\r\n"));
+    QCOMPARE(QByteArray(chunks[2].data(), chunks[2].size()), QByteArray("ef\n"));
+    QCOMPARE(QByteArray(chunks[3].data(), chunks[3].size()), QByteArray("\ngh"));
+    QCOMPARE(file.chunks(file.begin(), 100).size(), static_cast<size_t>(1));
+
+    const char* p = file.begin();
+    QCOMPARE(TextFile::readLine(p, file.end()).size(), 2);
+    Span<char> line = TextFile::readLine(p, file.end());
+    QCOMPARE(QByteArray(line.data(), line.size()), QByteArray("cd"));
+    TextFile::readLine(p, file.end());
+    QVERIFY(TextFile::readLine(p, file.end()).empty());
+    line = TextFile::readLine(p, file.end());
+    QCOMPARE(QByteArray(line.data(), line.size()), QByteArray("gh"));
+    QVERIFY(p == file.end());
+
+    // empty files cannot be mapped, but they can be opened
+    QVERIFY(file.open(writeFile("empty.csv", "")));
+    QCOMPARE(file.size(), static_cast<qint64>(0));
+    QVERIFY(file.chunks(file.begin(), 2).empty());
+    QVERIFY(!file.open(m_dir.path() + "/doesNotExist.csv"));
+}
+
+void TestEdgeList::tst_fromFile()
+{
+    QString error;
+    EdgeList edges = EdgeList::fromFile(writeFile("edges.csv",
+            "origin,target,weight\n0,1,0.5\r\n2, 3,1\n3,0,\n"), 4, &error);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(edges.size(), 3);
+    QCOMPARE(edges.origin(0), 0);
+    QCOMPARE(edges.target(0), 1);
+    QCOMPARE(edges.origin(1), 2);
+    QCOMPARE(edges.target(1), 3);
+    QCOMPARE(edges.origin(2), 3);
+    QCOMPARE(edges.target(2), 0);
+
+    // without the last line break and without the other columns
+    edges = EdgeList::fromFile(writeFile("edges2.csv", "origin,target\n1,0"), 2, &error);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(edges.size(), 1);
+    QCOMPARE(edges.origin(0), 1);
+
+    // only the header
+    edges = EdgeList::fromFile(writeFile("edges3.csv", "origin,target\n"), 2, &error);
+    QVERIFY(error.isEmpty());
+    QVERIFY(edges.isEmpty());
+}
+
+// the rows of all chunks are kept in order
+void TestEdgeList::tst_manyChunks()
+{
+    const int kNodes = 1000;
+    const int kEdges = 1000000;
+    QByteArray bytes("origin,target\n");
+    bytes.reserve(kEdges * 8);
+    for (int i = 0; i < kEdges; ++i) {
+        bytes += QByteArray::number(i % kNodes) + "," + QByteArray::number((i * 7) % kNodes) + "\n";
+    }
+
+    QString error;
+    const EdgeList edges = EdgeList::fromFile(writeFile("many.csv", bytes), kNodes, &error);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(edges.size(), kEdges);
+    for (int i = 0; i < kEdges; i += 997) {
+        QCOMPARE(edges.origin(i), i % kNodes);
+        QCOMPARE(edges.target(i), (i * 7) % kNodes);
+    }
+
+    // the row of an error is counted across the chunks
+    bytes += "0,x\n";
+    EdgeList::fromFile(writeFile("many.csv", bytes), kNodes, &error);
+    QVERIFY(error.contains(QString("Row: %1").arg(kEdges)));
+}
+
+void TestEdgeList::tst_invalid()
+{
+    auto check = [this](const QByteArray& bytes) {
+        QString error;
+        const EdgeList edges = EdgeList::fromFile(writeFile("invalid.csv", bytes), 3, &error);
+        return edges.isEmpty() && !error.isEmpty();
+    };
+    QVERIFY(check(""));
+    QVERIFY(check("origin\n0\n"));
+    QVERIFY(check("target,origin\n0,1\n"));
+    QVERIFY(check("origin,target\n0,1,2\n"));   // more columns than the header
+    QVERIFY(check("origin,target,w\n0,1\n"));   // less columns than the header
+    QVERIFY(check("origin,target\n0,a\n"));
+    QVERIFY(check("origin,target\n0,1.5\n"));
+    QVERIFY(check("origin,target\n0,3\n"));     // node 3 does not exist
+    QVERIFY(check("origin,target\n-1,0\n"));
+    QVERIFY(check("origin,target\n0,1\n\n1,2\n"));
+
+    QString error;
+    QVERIFY(EdgeList::fromFile(m_dir.path() + "/doesNotExist.csv", 3, &error).isEmpty());
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_MAIN(TestEdgeList)
+#include "tst_edgelist.moc"
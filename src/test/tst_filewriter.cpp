@@ -0,0 +1,166 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <thread>
+#include <vector>
+#include <core/filewriter.h>
+
+using namespace evoplex;
+
+class TestFileWriter: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() { QVERIFY(m_dir.isValid()); }
+    void cleanupTestCase() {}
+    void tst_rows();
+    void tst_backpressure();
+    void tst_failure();
+    void tst_concurrent();
+
+private:
+    QTemporaryDir m_dir;
+
+    static FileWriter::Block block(int firstStep, int numRows);
+    static QByteArray readAll(const QString& fpath);
+};
+
+// rows with two columns: the step and twice the step
+FileWriter::Block TestFileWriter::block(int firstStep, int numRows)
+{
+    FileWriter::Block b;
+    b.numCols = 2;
+    for (int step = firstStep; step < firstStep + numRows; ++step) {
+        b.steps.emplace_back(step);
+        b.cells.emplace_back(step);
+        b.cells.emplace_back(2 * step);
+    }
+    return b;
+}
+
+QByteArray TestFileWriter::readAll(const QString& fpath)
+{
+    QFile file(fpath);
+    if (!file.open(QFile::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+void TestFileWriter::tst_rows()
+{
+    const QString fpath = m_dir.path() + "/rows.csv";
+    FileWriter writer;
+    QVERIFY(writer.create(fpath, "step,a,b\n"));
+
+    FileWriter::Block b;
+    b.numCols = 2;
+    b.hasSteps = true;
+    b.steps = {0, 10};
+    b.cells = {Value(1), Value(0.5), Value("x"), Value()};
+    QVERIFY(writer.write(fpath, std::move(b)));
+    QVERIFY(writer.write(fpath, FileWriter::Block())); // nothing to write
+    QVERIFY(writer.close(fpath));
+    QCOMPARE(readAll(fpath), QByteArray("step,a,b\n0,1,0.5\n10,x,\n"));
+
+    // closing it again does nothing
+    QVERIFY(writer.close(fpath));
+
+    // creating it again truncates the file
+    QVERIFY(writer.create(fpath, "a,b\n"));
+    QVERIFY(writer.write(fpath, block(3, 1)));
+    QVERIFY(writer.close(fpath));
+    QCOMPARE(readAll(fpath), QByteArray("a,b\n3,6\n"));
+}
+
+// a tiny queue makes the producer wait for the writer; no row is lost
+void TestFileWriter::tst_backpressure()
+{
+    const QString fpath = m_dir.path() + "/backpressure.csv";
+    FileWriter writer(4);
+    QCOMPARE(writer.capacity(), 4);
+    QVERIFY(writer.create(fpath, ""));
+
+    QByteArray expected;
+    for (int step = 0; step < 1000; ++step) {
+        QVERIFY(writer.write(fpath, block(step, 1)));
+        expected += QByteArray::number(step) + "," + QByteArray::number(2 * step) + "\n";
+    }
+    // a block larger than the capacity is still accepted
+    QVERIFY(writer.write(fpath, block(1000, 10)));
+    for (int step = 1000; step < 1010; ++step) {
+        expected += QByteArray::number(step) + "," + QByteArray::number(2 * step) + "\n";
+    }
+    QVERIFY(writer.close(fpath));
+    QCOMPARE(readAll(fpath), expected);
+}
+
+void TestFileWriter::tst_failure()
+{
+    const QString fpath = m_dir.path() + "/missingDir/failure.csv";
+    FileWriter writer;
+    QVERIFY(!writer.create(fpath, "a,b\n"));
+    QVERIFY(!writer.write(fpath, block(0, 1)));
+    QVERIFY(!writer.close(fpath));
+
+    // writing to a file which was never created fails at close
+    const QString fpath2 = m_dir.path() + "/neverCreated.csv";
+    QVERIFY(writer.write(fpath2, block(0, 1)));
+    QVERIFY(!writer.close(fpath2));
+    // and the failure is cleared
+    QVERIFY(writer.close(fpath2));
+}
+
+// each thread writes its own file, as the trials do
+void TestFileWriter::tst_concurrent()
+{
+    const int kThreads = 4;
+    const int kBlocks = 500;
+    FileWriter writer(64);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&writer, t, this]() {
+            const QString fpath = m_dir.path() + QString("/concurrent%1.csv").arg(t);
+            writer.create(fpath, "a,b\n");
+            for (int i = 0; i < kBlocks; ++i) {
+                writer.write(fpath, block(i * 3, 3));
+            }
+            writer.close(fpath);
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    QByteArray expected("a,b\n");
+    for (int step = 0; step < kBlocks * 3; ++step) {
+        expected += QByteArray::number(step) + "," + QByteArray::number(2 * step) + "\n";
+    }
+    for (int t = 0; t < kThreads; ++t) {
+        QCOMPARE(readAll(m_dir.path() + QString("/concurrent%1.csv").arg(t)), expected);
+    }
+}
+
+QTEST_MAIN(TestFileWriter)
+#include "tst_filewriter.moc"
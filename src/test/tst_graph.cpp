@@ -0,0 +1,215 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <set>
+#include <abstractgraph.h>
+
+using namespace evoplex;
+
+class TestGraph: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_randNeighbour();
+    void tst_edgeHandles();
+    void tst_edgeHistograms();
+    void tst_addEdges();
+    void tst_outliveGraph();
+};
+
+// a bare graph; nodes and edges are added by the tests
+class Graph : public AbstractGraph
+{
+public:
+    Graph() : AbstractGraph("test") {}
+    bool init() override { return true; }
+    void reset() override {}
+};
+
+// randNeighbour must stay uniform over the remaining neighbours
+void TestGraph::tst_randNeighbour()
+{
+    const int kDegree = 50;
+    Graph graph;
+    // edges keep references to the graph's NodePtrs
+    const NodePtr& hub = graph.node(graph.addNode(Attributes())->id());
+    std::vector<EdgePtr> edges;
+    for (int i = 0; i < kDegree; ++i) {
+        const int id = graph.addNode(Attributes())->id();
+        edges.emplace_back(graph.addEdge(hub->id(), id));
+    }
+    QCOMPARE(hub->outDegree(), kDegree);
+
+    std::set<int> remaining;
+    for (int i = 0; i < kDegree; ++i) {
+        if (i % 3 == 0) {
+            graph.removeEdge(edges[i]);
+        } else {
+            remaining.insert(edges[i]->neighbour()->id());
+        }
+    }
+    QCOMPARE(hub->outDegree(), static_cast<int>(remaining.size()));
+
+    PRG prg(0);
+    std::set<int> drawn;
+    for (int i = 0; i < 10000; ++i) {
+        const int id = hub->randNeighbour(&prg)->id();
+        QVERIFY(remaining.count(id));
+        drawn.insert(id);
+    }
+    QCOMPARE(drawn, remaining);
+}
+
+// an edge is seen from both ends and only owns attributes if given some
+void TestGraph::tst_edgeHandles()
+{
+    Graph graph;
+    const NodePtr& a = graph.node(graph.addNode(Attributes())->id());
+    const NodePtr& b = graph.node(graph.addNode(Attributes())->id());
+
+    EdgePtr ab = graph.addEdge(a->id(), b->id());
+    QVERIFY(ab);
+    QVERIFY(!ab.isReversed());
+    QCOMPARE(ab->origin(), a);
+    QCOMPARE(ab->neighbour(), b);
+    QVERIFY(!ab->attrs());
+    QVERIFY_EXCEPTION_THROWN(ab->attr(0), std::out_of_range);
+
+    const EdgePtr& ba = b->inEdges().at(ab->id());
+    QVERIFY(ba.isReversed());
+    QCOMPARE(ba.get(), ab.get());
+    QCOMPARE(ba->origin(), b);
+    QCOMPARE(ba->neighbour(), a);
+
+    Attributes* attrs = new Attributes();
+    attrs->push_back("w", Value(1.5));
+    EdgePtr ba2 = graph.addEdge(b, a, attrs);
+    QVERIFY(ba2->attrs() == attrs);
+    ba2->setAttr(0, Value(2.5));
+    QCOMPARE(a->inEdges().at(ba2->id())->attr("w"), Value(2.5));
+    QCOMPARE(graph.numEdges(), 2);
+
+    // removing through the reversed handle removes the edge itself
+    graph.removeEdge(a->inEdges().at(ba2->id()));
+    QCOMPARE(graph.numEdges(), 1);
+    QCOMPARE(b->outDegree(), 0);
+    QCOMPARE(a->inDegree(), 0);
+    QCOMPARE(a->outEdges().at(ab->id())->neighbour(), b);
+}
+
+// the counts follow the edges which are added, changed and removed
+void TestGraph::tst_edgeHistograms()
+{
+    Graph graph;
+    const NodePtr& a = graph.node(graph.addNode(Attributes())->id());
+    const NodePtr& b = graph.node(graph.addNode(Attributes())->id());
+    auto w = [](int v) {
+        Attributes* attrs = new Attributes();
+        attrs->push_back("w", Value(v));
+        return attrs;
+    };
+
+    EdgePtr e1 = graph.addEdge(a, b, w(1));
+    graph.addEdge(b, a, w(1));
+    QVERIFY(!graph.edgeHistograms().isTracked(0));
+    graph.setEdgeHistogramEnabled(0, true);
+    QCOMPARE(graph.edgeHistograms().count(0, Value(1)), 2);
+
+    EdgePtr e3 = graph.addEdge(a, b, w(2));
+    QCOMPARE(graph.edgeHistograms().count(0, Value(2)), 1);
+
+    e1->setAttr(0, Value(2));
+    QCOMPARE(graph.edgeHistograms().count(0, Value(1)), 1);
+    QCOMPARE(graph.edgeHistograms().count(0, Value(2)), 2);
+
+    graph.removeEdge(e3);
+    QCOMPARE(graph.edgeHistograms().count(0, Value(2)), 1);
+    QCOMPARE(graph.edgeHistograms().count(0, Value(3)), 0);
+
+    graph.removeAllEdges();
+    QCOMPARE(graph.edgeHistograms().count(0, Value(1)), 0);
+    QCOMPARE(graph.edgeHistograms().count(0, Value(2)), 0);
+
+    graph.setEdgeHistogramEnabled(0, false);
+    QVERIFY(!graph.edgeHistograms().isTracked(0));
+}
+
+// adding the edges in bulk is the same as adding them one by one
+void TestGraph::tst_addEdges()
+{
+    Graph graph;
+    std::vector<int> ids;
+    for (int i = 0; i < 4; ++i) {
+        ids.emplace_back(graph.addNode(Attributes())->id());
+    }
+    EdgeList edges;
+    edges.add(ids[0], ids[1]);
+    edges.add(ids[1], ids[2]);
+    edges.add(ids[0], ids[3]);
+    edges.add(ids[0], ids[1]); // parallel edge
+
+    graph.freeze();
+    graph.addEdges(edges);
+    QVERIFY(!graph.isFrozen());
+    QCOMPARE(graph.numEdges(), 4);
+    QCOMPARE(graph.node(ids[0])->outDegree(), 3);
+    QCOMPARE(graph.node(ids[1])->inDegree(), 2);
+    QCOMPARE(graph.node(ids[1])->outDegree(), 1);
+    QCOMPARE(graph.node(ids[3])->inDegree(), 1);
+    for (auto const& p : graph.node(ids[1])->inEdges()) {
+        QCOMPARE(p.second->neighbour(), graph.node(ids[0]));
+        QVERIFY(!p.second->attrs());
+    }
+
+    graph.addEdges(EdgeList());
+    QCOMPARE(graph.numEdges(), 4);
+    graph.addEdge(ids[3], ids[2]);
+    QCOMPARE(graph.numEdges(), 5);
+}
+
+// nodes held outside the graph keep their attributes, but not their edges
+void TestGraph::tst_outliveGraph()
+{
+    NodePtr node;
+    {
+        Graph graph;
+        Attributes attrs;
+        attrs.push_back("a", Value(5));
+        const int id = graph.addNode(attrs)->id();
+        const int id2 = graph.addNode(attrs)->id();
+        graph.addEdge(id, id2);
+        graph.addEdge(id2, id);
+        node = graph.node(id);
+        QCOMPARE(node->outDegree(), 1);
+        QCOMPARE(node->inDegree(), 1);
+    }
+    QCOMPARE(node->outDegree(), 0);
+    QCOMPARE(node->inDegree(), 0);
+    QVERIFY(node->outEdges().empty());
+    QVERIFY(node->inEdges().empty());
+    QCOMPARE(node->attr(0), Value(5));
+}
+
+QTEST_MAIN(TestGraph)
+#include "tst_graph.moc"
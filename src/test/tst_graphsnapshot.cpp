@@ -0,0 +1,365 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <abstractgraph.h>
+#include <edgelist.h>
+#include <nodes.h>
+#include <core/graphsnapshot.h>
+
+using namespace evoplex;
+
+class TestGraphSnapshot: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() { QVERIFY(m_dir.isValid()); }
+    void cleanupTestCase() {}
+    void tst_roundTrip();
+    void tst_copyOnWrite();
+    void tst_nodes();
+    void tst_edgeList();
+    void tst_sparseIds();
+    void tst_invalid();
+
+private:
+    QTemporaryDir m_dir;
+
+    // saves a graph of 4 nodes and 3 edges to 'name'
+    QString saveGraph(const QString& name);
+};
+
+// a bare graph; nodes and edges are added by the tests
+class Graph : public AbstractGraph
+{
+public:
+    Graph() : AbstractGraph("test") {}
+    bool init() override { return true; }
+    void reset() override {}
+};
+
+QString TestGraphSnapshot::saveGraph(const QString& name)
+{
+    Graph graph;
+    std::vector<int> ids;
+    for (int i = 0; i < 4; ++i) {
+        Attributes attrs;
+        attrs.push_back("alive", Value(i % 2 == 0));
+        attrs.push_back("n", Value(i * 2));
+        attrs.push_back("w", Value(i + 0.5));
+        attrs.push_back("tag", Value(QString("node-%1").arg(i)));
+        ids.emplace_back(graph.addNode(attrs, i, 10 * i)->id());
+    }
+    auto weight = [](double w) {
+        Attributes* attrs = new Attributes();
+        attrs->push_back("weight", Value(w));
+        return attrs;
+    };
+    graph.addEdge(ids[2], ids[0], weight(2.0));
+    graph.addEdge(ids[0], ids[3], weight(0.5));
+    graph.addEdge(ids[0], ids[1], weight(1.0));
+
+    const QString fpath = m_dir.path() + "/" + name;
+    QString error;
+    return graph.saveToFile(fpath, &error) ? fpath : QString();
+}
+
+void TestGraphSnapshot::tst_roundTrip()
+{
+    const QString fpath = saveGraph("roundTrip.evg");
+    QVERIFY(!fpath.isEmpty());
+    QVERIFY(GraphSnapshot::isSnapshot(fpath));
+
+    QString error;
+    GraphSnapshotPtr s = GraphSnapshot::open(fpath, &error);
+    QVERIFY(s);
+    QVERIFY(error.isEmpty());
+    QVERIFY(!s->isDirected());
+    QCOMPARE(s->numNodes(), 4);
+    QCOMPARE(s->numEdges(), 3);
+    for (int row = 0; row < 4; ++row) {
+        QCOMPARE(s->nodeIds()[row], row);
+        QCOMPARE(s->nodeX()[row], row);
+        QCOMPARE(s->nodeY()[row], 10 * row);
+    }
+
+    // edges are grouped by origin and sorted by id
+    const std::vector<int> offsets = {0, 2, 2, 3, 3};
+    const std::vector<int> targets = {3, 1, 0};
+    QCOMPARE(std::vector<int>(s->edgeOffsets().begin(), s->edgeOffsets().end()), offsets);
+    QCOMPARE(std::vector<int>(s->edgeTargets().begin(), s->edgeTargets().end()), targets);
+
+    const AttributeColumns& nodeAttrs = s->nodeAttrs();
+    QCOMPARE(nodeAttrs.numRows(), 4);
+    QCOMPARE(nodeAttrs.numColumns(), 4);
+    QCOMPARE(nodeAttrs.type(nodeAttrs.indexOf("alive")), Value::BOOL);
+    QCOMPARE(nodeAttrs.type(nodeAttrs.indexOf("n")), Value::INT);
+    QCOMPARE(nodeAttrs.type(nodeAttrs.indexOf("w")), Value::DOUBLE);
+    QCOMPARE(nodeAttrs.type(nodeAttrs.indexOf("tag")), Value::STRING);
+    for (int row = 0; row < 4; ++row) {
+        QCOMPARE(nodeAttrs.value(row, 0), Value(row % 2 == 0));
+        QCOMPARE(nodeAttrs.value(row, 1), Value(row * 2));
+        QCOMPARE(nodeAttrs.value(row, 2), Value(row + 0.5));
+        QCOMPARE(nodeAttrs.value(row, 3), Value(QString("node-%1").arg(row)));
+    }
+
+    // the fixed-width columns point to the aligned sections of the file
+    QCOMPARE(reinterpret_cast<quintptr>(nodeAttrs.data<int>(1)) % GraphSnapshot::Alignment, quintptr(0));
+    QCOMPARE(reinterpret_cast<quintptr>(nodeAttrs.data<double>(2)) % GraphSnapshot::Alignment, quintptr(0));
+    QVERIFY(nodeAttrs.isShared(1));
+
+    const AttributeColumns& edgeAttrs = s->edgeAttrs();
+    QCOMPARE(edgeAttrs.numRows(), 3);
+    QCOMPARE(edgeAttrs.name(0), QString("weight"));
+    QCOMPARE(edgeAttrs.value(0, 0), Value(0.5));
+    QCOMPARE(edgeAttrs.value(1, 0), Value(1.0));
+    QCOMPARE(edgeAttrs.value(2, 0), Value(2.0));
+}
+
+// the mapped columns are copied only when they are changed
+void TestGraphSnapshot::tst_copyOnWrite()
+{
+    const QString fpath = saveGraph("copyOnWrite.evg");
+    GraphSnapshotPtr s = GraphSnapshot::open(fpath);
+    QVERIFY(s);
+
+    AttributeColumns a = s->nodeAttrs();
+    AttributeColumns b = a;
+    const AttributeColumns& ca = a;
+    const AttributeColumns& cb = b;
+    QCOMPARE(ca.data<int>(1), s->nodeAttrs().data<int>(1));
+    b.setValue(2, 1, Value(42));
+    QVERIFY(cb.data<int>(1) != s->nodeAttrs().data<int>(1));
+    QVERIFY(!b.isShared(1));
+    QVERIFY(a.isShared(1));
+    QCOMPARE(b.value(2, 1), Value(42));
+    QCOMPARE(a.value(2, 1), Value(4));
+    QCOMPARE(s->nodeAttrs().value(2, 1), Value(4));
+
+    // the mapping outlives the snapshot while a column uses it
+    s.reset();
+    QCOMPARE(a.value(3, 1), Value(6));
+    a.removeRow(0);
+    QCOMPARE(a.numRows(), 3);
+    QCOMPARE(a.value(0, 1), Value(6));
+
+    a.setDoubleBuffered(2, true);
+    a.backData<double>(2)[0] = 9.5;
+    a.swapBuffers();
+    QCOMPARE(a.value(0, 2), Value(9.5));
+}
+
+void TestGraphSnapshot::tst_nodes()
+{
+    const QString fpath = saveGraph("nodes.evg");
+    AttributesScope scope;
+    scope.insert("n", AttributeRange::parse(0, "n", "int[0,6]"));
+    scope.insert("alive", AttributeRange::parse(1, "alive", "bool"));
+
+    // the columns follow the scope and are read in place
+    QString error;
+    AttributeColumns attrs;
+    Nodes nodes = Nodes::fromSnapshot(fpath, scope, AbstractGraph::Directed, attrs, &error);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(nodes.size(), size_t(4));
+    QCOMPARE(attrs.numColumns(), 2);
+    QCOMPARE(attrs.name(0), QString("n"));
+    QCOMPARE(attrs.name(1), QString("alive"));
+    QVERIFY(attrs.isShared(0));
+    QCOMPARE(attrs.value(3, 0), Value(6));
+    QCOMPARE(nodes.at(3)->y(), 30);
+    QCOMPARE(nodes.at(3)->attrs().size(), 0);
+
+    // or copied into the nodes; the progress is per mille, as for csv files
+    int lastProgress = -1;
+    nodes = Nodes::fromFile(fpath, scope, AbstractGraph::Undirected, &error,
+                            [&lastProgress](int p) { lastProgress = p; });
+    QVERIFY(error.isEmpty());
+    QCOMPARE(nodes.size(), size_t(4));
+    QCOMPARE(lastProgress, 1000);
+    QCOMPARE(nodes.at(2)->attr("n"), Value(4));
+    QCOMPARE(nodes.at(2)->attr("alive"), Value(true));
+    QCOMPARE(nodes.at(2)->x(), 2);
+
+    // round trip through Nodes::saveToFile
+    const QString fpath2 = m_dir.path() + "/nodes2.evg";
+    QVERIFY(nodes.saveToFile(fpath2));
+    Nodes nodes2 = Nodes::fromFile(fpath2, scope, AbstractGraph::Undirected, &error);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(nodes2.size(), size_t(4));
+    for (int id = 0; id < 4; ++id) {
+        QCOMPARE(nodes2.at(id)->attr("n"), nodes.at(id)->attr("n"));
+        QCOMPARE(nodes2.at(id)->attr("alive"), nodes.at(id)->attr("alive"));
+        QCOMPARE(nodes2.at(id)->y(), nodes.at(id)->y());
+    }
+
+    // values out of the range of the scope
+    delete scope.take("n");
+    scope.insert("n", AttributeRange::parse(0, "n", "int[0,5]"));
+    nodes = Nodes::fromSnapshot(fpath, scope, AbstractGraph::Directed, attrs, &error);
+    QVERIFY(nodes.empty());
+    QVERIFY(!error.isEmpty());
+
+    // types which differ from the scope
+    error.clear();
+    delete scope.take("n");
+    scope.insert("n", AttributeRange::parse(0, "n", "double[0,6]"));
+    nodes = Nodes::fromSnapshot(fpath, scope, AbstractGraph::Directed, attrs, &error);
+    QVERIFY(nodes.empty());
+    QVERIFY(!error.isEmpty());
+    qDeleteAll(scope);
+}
+
+void TestGraphSnapshot::tst_edgeList()
+{
+    const QString fpath = saveGraph("edges.evg");
+    QString error;
+    EdgeList edges = EdgeList::fromFile(fpath, 4, &error);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(edges.size(), 3);
+    QCOMPARE(edges.origin(0), 0);
+    QCOMPARE(edges.target(0), 3);
+    QCOMPARE(edges.origin(2), 2);
+    QCOMPARE(edges.target(2), 0);
+    QCOMPARE(edges.attrs().numRows(), 3);
+    QCOMPARE(edges.attrs().value(2, 0), Value(2.0));
+
+    Graph graph;
+    for (int i = 0; i < 4; ++i) {
+        graph.addNode(Attributes());
+    }
+    graph.addEdges(edges);
+    QCOMPARE(graph.numEdges(), 3);
+    QCOMPARE(graph.node(0)->outDegree(), 2);
+
+    // the node ids must be in [0, numNodes)
+    edges = EdgeList::fromFile(fpath, 3, &error);
+    QVERIFY(edges.isEmpty());
+    QVERIFY(!error.isEmpty());
+}
+
+// the ids saved after removing nodes have gaps; they are renumbered
+void TestGraphSnapshot::tst_sparseIds()
+{
+    // as if the node 1 (and its edge) had been removed from the graph
+    const QString fpath = m_dir.path() + "/sparse.evg";
+    {
+        Graph graph;
+        for (int i = 0; i < 4; ++i) {
+            Attributes attrs;
+            attrs.push_back("n", Value(i * 2));
+            graph.addNode(attrs, i, 10 * i);
+        }
+        const std::vector<NodePtr> nodes = { graph.node(0), graph.node(2), graph.node(3) };
+        const std::vector<EdgePtr> edges = { graph.addEdge(2, 0), graph.addEdge(0, 3) };
+        graph.addEdge(0, 1);
+        QString error;
+        QVERIFY(GraphSnapshot::save(fpath, false, nodes, edges, &error));
+    }
+    AttributesScope scope;
+    scope.insert("n", AttributeRange::parse(0, "n", "int[0,6]"));
+
+    QString error;
+    Nodes nodes = Nodes::fromFile(fpath, scope, AbstractGraph::Undirected, &error);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(nodes.size(), size_t(3));
+    for (int id = 0; id < 3; ++id) {
+        QCOMPARE(nodes.at(id)->id(), id);
+    }
+    QCOMPARE(nodes.at(1)->attr("n"), Value(4));
+    QCOMPARE(nodes.at(2)->y(), 30);
+
+    // edges follow the new ids: 2->0 is now 1->0, and 0->3 is now 0->2
+    EdgeList edges = EdgeList::fromFile(fpath, 3, &error);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(edges.size(), 2);
+    QCOMPARE(edges.origin(0), 0);
+    QCOMPARE(edges.target(0), 2);
+    QCOMPARE(edges.origin(1), 1);
+    QCOMPARE(edges.target(1), 0);
+
+    Graph graph;
+    for (int i = 0; i < 3; ++i) {
+        graph.addNode(Attributes());
+    }
+    graph.addEdges(edges);
+    QCOMPARE(graph.numEdges(), 2);
+    QCOMPARE(graph.node(0)->outDegree(), 1);
+    QCOMPARE(graph.node(0)->inDegree(), 1);
+    qDeleteAll(scope);
+}
+
+void TestGraphSnapshot::tst_invalid()
+{
+    const QString fpath = saveGraph("invalid.evg");
+    QFile file(fpath);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray bytes = file.readAll();
+    file.close();
+
+    auto openBytes = [this](const QByteArray& b) {
+        const QString p = m_dir.path() + "/broken.evg";
+        QFile f(p);
+        if (!f.open(QFile::WriteOnly | QFile::Truncate) || f.write(b) != b.size()) {
+            return false;
+        }
+        f.close();
+        QString error;
+        const bool ok = static_cast<bool>(GraphSnapshot::open(p, &error));
+        return ok || error.isEmpty();
+    };
+
+    QVERIFY(openBytes(bytes));
+    QVERIFY(!openBytes(QByteArray("origin,target\n0,1\n")));
+    QVERIFY(!openBytes(bytes.left(bytes.size() / 2)));
+
+    QByteArray version = bytes;
+    version[8] = 2;
+    QVERIFY(!openBytes(version));
+
+    // a target out of range: the last int of the EdgeTargets section is
+    // found through the section table
+    QByteArray target = bytes;
+    quint32 numSections;
+    std::memcpy(&numSections, bytes.constData() + 24, 4);
+    for (quint32 i = 0; i < numSections; ++i) {
+        const char* entry = bytes.constData() + 64 + i * 32;
+        quint32 kind;
+        quint64 offset, size;
+        std::memcpy(&kind, entry, 4);
+        std::memcpy(&offset, entry + 16, 8);
+        std::memcpy(&size, entry + 24, 8);
+        if (kind == GraphSnapshot::EdgeTargets) {
+            const int bad = 99;
+            std::memcpy(target.data() + offset + size - 4, &bad, 4);
+        }
+    }
+    QVERIFY(!openBytes(target));
+
+    QString error;
+    QVERIFY(!GraphSnapshot::open(m_dir.path() + "/doesNotExist.evg", &error));
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_MAIN(TestGraphSnapshot)
+#include "tst_graphsnapshot.moc"
@@ -42,9 +42,9 @@ constructors:
      DNode(int id, Attributes attrs, int x, int y)
 
 functions:
-    inline const Attributes& attrs() const;
-    inline const Value& attr(const char* name) const;
-    inline const Value& attr(const int id) const;
+    inline Attributes attrs() const;
+    inline Value attr(const char* name) const;
+    inline Value attr(const int id) const;
     inline void setAttr(const int id, const Value& value);
 
     inline int id() const;
@@ -0,0 +1,362 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <abstractgraph.h>
+#include <nodes.h>
+#include <core/textfile.h>
+
+using namespace evoplex;
+
+class TestNodes: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase() { qDeleteAll(m_scope); }
+    void tst_parseDouble();
+    void tst_fromFile();
+    void tst_manyChunks();
+    void tst_invalid();
+    void tst_saveToFile();
+    void tst_saveCompressed();
+
+private:
+    QTemporaryDir m_dir;
+    AttributesScope m_scope;
+
+    QString writeFile(const QString& name, const QByteArray& bytes);
+    // reads 'bytes' as a csv file; returns the error message, if any
+    QString read(const QByteArray& bytes, Nodes& nodes);
+    // 'numNodes' nodes with ids in descending order of insertion
+    Nodes makeNodes(int numNodes) const;
+};
+
+void TestNodes::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_scope.insert("n", AttributeRange::parse(0, "n", "int[0,100]"));
+    m_scope.insert("w", AttributeRange::parse(1, "w", "double[-1,1]"));
+    m_scope.insert("alive", AttributeRange::parse(2, "alive", "bool"));
+    m_scope.insert("k", AttributeRange::parse(3, "k", "int{2,4,8}"));
+    m_scope.insert("tag", AttributeRange::parse(4, "tag", "string"));
+}
+
+QString TestNodes::writeFile(const QString& name, const QByteArray& bytes)
+{
+    const QString fpath = m_dir.path() + "/" + name;
+    QFile file(fpath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(bytes) != bytes.size()) {
+        return QString();
+    }
+    return fpath;
+}
+
+QString TestNodes::read(const QByteArray& bytes, Nodes& nodes)
+{
+    QString error;
+    nodes = Nodes::fromFile(writeFile("nodes.csv", bytes), m_scope,
+                            AbstractGraph::Undirected, &error);
+    return error;
+}
+
+Nodes TestNodes::makeNodes(int numNodes) const
+{
+    Nodes nodes;
+    for (int id = numNodes - 1; id >= 0; --id) {
+        Attributes attrs(m_scope.size());
+        attrs.replace(0, "n", Value(id % 101));
+        attrs.replace(1, "w", Value((id % 5) * 0.25 - 0.5));
+        attrs.replace(2, "alive", Value(id % 3 == 0));
+        attrs.replace(3, "k", Value(2 << (id % 3)));
+        attrs.replace(4, "tag", Value(QString("t%1").arg(id)));
+        nodes.insert({id, std::make_shared<UNode>(id, attrs, id % 7, -id)});
+    }
+    return nodes;
+}
+
+void TestNodes::tst_parseDouble()
+{
+    auto parse = [](const char* str, double& v) {
+        const char* p = str;
+        const char* end = str + strlen(str);
+        return TextFile::parseDouble(p, end, v) && p == end;
+    };
+    double v = 0.;
+    QVERIFY(parse("0", v));
+    QCOMPARE(v, 0.);
+    QVERIFY(parse("0.1", v));
+    QCOMPARE(v, 0.1);
+    QVERIFY(parse(" -1.25 ", v));
+    QCOMPARE(v, -1.25);
+    QVERIFY(parse("+3.", v));
+    QCOMPARE(v, 3.);
+    QVERIFY(parse(".5", v));
+    QCOMPARE(v, 0.5);
+    QVERIFY(parse("1e-3", v));
+    QCOMPARE(v, 0.001);
+    QVERIFY(parse("2.5E+2", v));
+    QCOMPARE(v, 250.);
+    QVERIFY(parse("123456789.123456789", v));
+    QCOMPARE(v, 123456789.123456789);
+    QVERIFY(parse("1e300", v));
+    QCOMPARE(v, 1e300);
+    QVERIFY(parse("2.2250738585072014e-308", v));
+    QCOMPARE(v, 2.2250738585072014e-308);
+    QVERIFY(!parse("", v));
+    QVERIFY(!parse("-", v));
+    QVERIFY(!parse(".", v));
+    QVERIFY(!parse("1e", v));
+    QVERIFY(!parse("1.2.3", v));
+    QVERIFY(!parse("a1", v));
+    QVERIFY(!parse("1 2", v));
+    QVERIFY(!parse("1e 2", v));
+}
+
+void TestNodes::tst_fromFile()
+{
+    Nodes nodes;
+    QString error = read("tag,x,k,alive,y,w,n\n"
+                         "a,1,2,true,-1,0.5,10\n"
+                         "b b,2,4,0, 2,-1e-1,0\r\n"
+                         ",3,8,1,3,1,100", nodes);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(nodes.size(), size_t(3));
+
+    const NodePtr& n0 = nodes.at(0);
+    QCOMPARE(n0->id(), 0);
+    QCOMPARE(n0->x(), 1);
+    QCOMPARE(n0->y(), -1);
+    QCOMPARE(n0->attrs().size(), m_scope.size());
+    QCOMPARE(n0->attr("n"), Value(10));
+    QCOMPARE(n0->attr("w"), Value(0.5));
+    QCOMPARE(n0->attr("alive"), Value(true));
+    QCOMPARE(n0->attr("k"), Value(2));
+    QCOMPARE(n0->attr("tag"), Value(QString("a")));
+
+    const NodePtr& n1 = nodes.at(1);
+    QCOMPARE(n1->y(), 2);
+    QCOMPARE(n1->attr("w"), Value(-0.1));
+    QCOMPARE(n1->attr("alive"), Value(false));
+    QCOMPARE(n1->attr("tag"), Value(QString("b b")));
+
+    QCOMPARE(nodes.at(2)->attr("n"), Value(100));
+    QCOMPARE(nodes.at(2)->attr("tag"), Value(QString("")));
+
+    // without coordinates, nodes are placed in a column
+    error = read("n,w,alive,k,tag\n5,0,false,4,x\n6,0,true,4,y\n", nodes);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(nodes.size(), size_t(2));
+    QCOMPARE(nodes.at(1)->x(), 0);
+    QCOMPARE(nodes.at(1)->y(), 1);
+    QCOMPARE(nodes.at(1)->attr("n"), Value(6));
+
+    // just the header
+    error = read("n,w,alive,k,tag\n", nodes);
+    QVERIFY(error.isEmpty());
+    QVERIFY(nodes.empty());
+}
+
+void TestNodes::tst_manyChunks()
+{
+    // a few MB, so the rows are split into several chunks
+    const int kRows = 500000;
+    QByteArray bytes("n,w,alive,k,tag\n");
+    bytes.reserve(kRows * 24);
+    for (int i = 0; i < kRows; ++i) {
+        bytes += QByteArray::number(i % 101) + "," + QByteArray::number((i % 5) * 0.25 - 0.5)
+               + (i % 2 ? ",true,8," : ",false,2,") + QByteArray::number(i) + "\n";
+    }
+    const QString fpath = writeFile("many.csv", bytes);
+
+    QString error;
+    int lastProgress = -1;
+    bool isMonotonic = true;
+    Nodes nodes = Nodes::fromFile(fpath, m_scope, AbstractGraph::Directed, &error,
+            [&lastProgress, &isMonotonic](int p) {
+                isMonotonic = isMonotonic && p > lastProgress;
+                lastProgress = p;
+            });
+    QVERIFY(error.isEmpty());
+    QVERIFY(isMonotonic);
+    QCOMPARE(lastProgress, 1000);
+    QCOMPARE(nodes.size(), static_cast<size_t>(kRows));
+    for (int i = 0; i < kRows; i += 997) {
+        const NodePtr& node = nodes.at(i);
+        QCOMPARE(node->id(), i);
+        QCOMPARE(node->y(), i);
+        QCOMPARE(node->attr("n"), Value(i % 101));
+        QCOMPARE(node->attr("w"), Value((i % 5) * 0.25 - 0.5));
+        QCOMPARE(node->attr("alive"), Value(i % 2 == 1));
+        QCOMPARE(node->attr("tag"), Value(QString::number(i)));
+    }
+
+    // the row of an error is counted across chunks
+    bytes.insert(bytes.size() - 1, ",1");
+    QVERIFY(!writeFile("many.csv", bytes).isEmpty());
+    nodes = Nodes::fromFile(fpath, m_scope, AbstractGraph::Directed, &error);
+    QVERIFY(nodes.empty());
+    QVERIFY(error.contains(QString("row: %1").arg(kRows - 1)));
+}
+
+void TestNodes::tst_invalid()
+{
+    Nodes nodes;
+    const QByteArray header("n,w,alive,k,tag\n");
+    auto invalid = [this, &nodes](const QByteArray& bytes, const QString& msg) {
+        const QString error = read(bytes, nodes);
+        return nodes.empty() && error.contains(msg);
+    };
+
+    // header
+    QVERIFY(invalid("n,w,alive,k\n1,0,true,2\n", "header is imcompatible"));
+    QVERIFY(invalid("n,w,alive,k,tags\n1,0,true,2,a\n", "header is imcompatible"));
+    QVERIFY(invalid("n,w,alive,k,tag,x\n1,0,true,2,a,0\n", "missing 'x' or 'y'"));
+    QVERIFY(invalid("n,w,alive,k,tag,n\n", "duplicated keys"));
+
+    // number of columns
+    QVERIFY(invalid(header + "1,0,true,2,a\n1,0,true,2\n", "same number of columns!\n row: 1"));
+    QVERIFY(invalid(header + "1,0,true,2,a,b\n", "same number of columns!\n row: 0"));
+    QVERIFY(invalid(header + "1,0,true,2,a\n\n", "row: 1"));
+
+    // values
+    QVERIFY(invalid(header + "101,0,true,2,a\n", "invalid value at column: 0"));
+    QVERIFY(invalid(header + "1a,0,true,2,a\n", "invalid value at column: 0"));
+    QVERIFY(invalid(header + "1,1.5,true,2,a\n", "invalid value at column: 1"));
+    QVERIFY(invalid(header + "1,nan,true,2,a\n", "invalid value at column: 1"));
+    QVERIFY(invalid(header + "1,0,yes,2,a\n", "invalid value at column: 2"));
+    QVERIFY(invalid(header + "1,0,true,3,a\n", "invalid value at column: 3"));
+    QVERIFY(invalid("n,w,alive,k,tag,x,y\n1,0,true,2,a,0,b\n", "invalid value at column: 6"));
+
+    // columns which are not in the scope
+    QVERIFY(invalid("n,w,alive,k,tag,z\n1,0,true,2,a,0\n", "invalid value at column: 5"));
+}
+
+void TestNodes::tst_saveToFile()
+{
+    const int kNodes = 150000; // a few chunks
+    const Nodes nodes = makeNodes(kNodes);
+    const QString fpath = m_dir.path() + "/saved.csv";
+    int lastProgress = 0;
+    QVERIFY(nodes.saveToFile(fpath, [&lastProgress](int p) { lastProgress = p; }));
+    QCOMPARE(lastProgress, kNodes);
+
+    QFile file(fpath);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray bytes = file.readAll();
+    file.close();
+    QVERIFY(bytes.startsWith("n,w,alive,k,tag,x,y\n0,-0.5,1,2,t0,0,0\n1,-0.25,0,4,t1,1,-1\n"));
+    QVERIFY(bytes.endsWith(QByteArray("\n") + QString("%1,0.5,0,8,t%2,%3,%4\n")
+            .arg((kNodes - 1) % 101).arg(kNodes - 1).arg((kNodes - 1) % 7).arg(1 - kNodes).toUtf8()));
+
+    // the rows are in order of ids, so they keep their ids when read back
+    QString error;
+    const Nodes nodes2 = Nodes::fromFile(fpath, m_scope, AbstractGraph::Undirected, &error);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(nodes2.size(), nodes.size());
+    for (int id = 0; id < kNodes; id += 991) {
+        const NodePtr& a = nodes.at(id);
+        const NodePtr& b = nodes2.at(id);
+        QCOMPARE(b->x(), a->x());
+        QCOMPARE(b->y(), a->y());
+        for (int attr = 0; attr < m_scope.size(); ++attr) {
+            QCOMPARE(b->attr(attr), a->attr(attr));
+        }
+    }
+
+    QVERIFY(!Nodes().saveToFile(fpath));
+}
+
+void TestNodes::tst_saveCompressed()
+{
+    const Nodes nodes = makeNodes(150000);
+    const QString csvPath = m_dir.path() + "/plain.csv";
+    const QString gzPath = m_dir.path() + "/compressed.csv.gz";
+    QVERIFY(nodes.saveToFile(csvPath));
+    QVERIFY(nodes.saveToFile(gzPath));
+
+    QFile csvFile(csvPath);
+    QFile gzFile(gzPath);
+    QVERIFY(csvFile.open(QFile::ReadOnly) && gzFile.open(QFile::ReadOnly));
+    const QByteArray csv = csvFile.readAll();
+    const QByteArray gz = gzFile.readAll();
+    QVERIFY(gz.size() < csv.size() / 2);
+
+    auto le32 = [](const char* p) {
+        const uchar* u = reinterpret_cast<const uchar*>(p);
+        return quint32(u[0]) | quint32(u[1]) << 8 | quint32(u[2]) << 16 | quint32(u[3]) << 24;
+    };
+    auto crc32 = [](const QByteArray& data) {
+        quint32 crc = 0xFFFFFFFFu;
+        for (const char c : data) {
+            crc ^= static_cast<uchar>(c);
+            for (int k = 0; k < 8; ++k) {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+            }
+        }
+        return ~crc;
+    };
+    auto adler32 = [](const QByteArray& data) {
+        quint32 a = 1, b = 0;
+        for (const char c : data) {
+            a = (a + static_cast<uchar>(c)) % 65521;
+            b = (b + a) % 65521;
+        }
+        return b << 16 | a;
+    };
+
+    // The file is made of one gzip member per chunk. Each member is turned
+    // into the format of qCompress() to check that it inflates to the same
+    // bytes as the plain file.
+    const QByteArray magic("\x1f\x8b\x08\0\0\0\0\0\0\xff", 10);
+    QVERIFY(gz.startsWith(magic));
+    int numMembers = 0;
+    int csvPos = 0;
+    for (int pos = 0; pos < gz.size(); ++numMembers) {
+        int next = gz.indexOf(magic, pos + magic.size());
+        next = next < 0 ? gz.size() : next;
+        const int size = static_cast<int>(le32(gz.constData() + next - 4));
+        const QByteArray expected = csv.mid(csvPos, size);
+        QCOMPARE(le32(gz.constData() + next - 8), crc32(expected));
+
+        QByteArray zlib;
+        for (int i = 24; i >= 0; i -= 8) {
+            zlib.append(static_cast<char>((size >> i) & 0xFF));
+        }
+        zlib.append("\x78\x9c", 2);
+        zlib.append(gz.mid(pos + magic.size(), next - 8 - pos - magic.size()));
+        const quint32 adler = adler32(expected);
+        for (int i = 24; i >= 0; i -= 8) {
+            zlib.append(static_cast<char>((adler >> i) & 0xFF));
+        }
+        QCOMPARE(qUncompress(zlib), expected);
+
+        csvPos += size;
+        pos = next;
+    }
+    QCOMPARE(csvPos, csv.size());
+    QCOMPARE(numMembers, 3);
+}
+
+QTEST_MAIN(TestNodes)
+#include "tst_nodes.moc"
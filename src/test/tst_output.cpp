@@ -0,0 +1,197 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <tuple>
+#include <abstractgraph.h>
+#include <abstractmodel.h>
+#include <output.h>
+
+using namespace evoplex;
+
+class TestOutput: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void tst_final();
+    void tst_onChange();
+    void tst_groups();
+
+private:
+    AttributeRange* m_n;
+    AttributeRange* m_w;
+};
+
+// a bare graph; the nodes are added by the tests
+class Graph : public AbstractGraph
+{
+public:
+    Graph() : AbstractGraph("test") {}
+    bool init() override { return true; }
+    void reset() override {}
+};
+
+// a model which is stepped by the tests
+class Model : public AbstractModel
+{
+public:
+    // nodes with 'n' = i % 3 and 'w' = 0.5 * i
+    explicit Model(int numNodes) {
+        m_graph = new Graph();
+        for (int i = 0; i < numNodes; ++i) {
+            Attributes attrs(2);
+            attrs.replace(0, "n", Value(i % 3));
+            attrs.replace(1, "w", Value(0.5 * i));
+            m_graph->addNode(attrs);
+        }
+    }
+    bool init() override { return true; }
+    bool algorithmStep() override { return false; }
+    inline void setStep(int step) { m_currStep = step; }
+};
+
+void TestOutput::initTestCase()
+{
+    m_n = AttributeRange::parse(0, "n", "int[0,10]");
+    m_w = AttributeRange::parse(1, "w", "double[0,100]");
+    QVERIFY(m_n->isValid() && m_w->isValid());
+}
+
+void TestOutput::cleanupTestCase()
+{
+    delete m_n;
+    delete m_w;
+}
+
+// only the last step of the trial is evaluated
+void TestOutput::tst_final()
+{
+    Model model(4); // w: 0, 0.5, 1, 1.5
+    auto sum = std::make_shared<DefaultOutput>(DefaultOutput::F_Sum, DefaultOutput::E_Nodes,
+                                               m_w, Sampling(Sampling::Final));
+    Cache* cache = sum->addCache({Value("")}, {0});
+    OutputPlanner planner;
+    planner.plan({sum});
+
+    for (int step = 0; step < 5; ++step) {
+        model.setStep(step);
+        QCOMPARE(planner.doOperation(0, &model, false), 0);
+        QVERIFY(cache->isEmpty(0));
+    }
+    QCOMPARE(planner.doOperation(0, &model, true), 1);
+    QVERIFY(!cache->isEmpty(0));
+    const Cache::Row row = cache->readFrontRow(0);
+    QCOMPARE(row.step(), 4);
+    QCOMPARE(row.size(), 1);
+    QCOMPARE(row.at(0), Value(3.0));
+    cache->flushFrontRow(0);
+    QVERIFY(cache->isEmpty(0));
+}
+
+// a row is only added when any of its values changes, and at the last step
+void TestOutput::tst_onChange()
+{
+    Model model(6); // n: 0, 1, 2, 0, 1, 2
+    auto count = std::make_shared<DefaultOutput>(DefaultOutput::F_Count, DefaultOutput::E_Nodes,
+                                                 m_n, Sampling(Sampling::OnChange));
+    Cache* cache = count->addCache({Value(0), Value(2)}, {0});
+    OutputPlanner planner;
+    planner.plan({count});
+
+    // the first step always adds a row; the counts are read from the
+    // histogram, which is built only once
+    model.setStep(0);
+    QCOMPARE(planner.doOperation(0, &model, false), 1);
+    for (int step = 1; step < 4; ++step) {
+        model.setStep(step);
+        QCOMPARE(planner.doOperation(0, &model, false), 0);
+    }
+    model.node(1)->setAttr(0, Value(2));
+    model.setStep(4);
+    planner.doOperation(0, &model, false);
+    model.setStep(5);
+    planner.doOperation(0, &model, false);
+    model.setStep(6);
+    planner.doOperation(0, &model, true);
+
+    const std::vector<std::tuple<int, int, int>> expected = {
+        std::make_tuple(0, 2, 2), std::make_tuple(4, 2, 3), std::make_tuple(6, 2, 3)
+    };
+    for (const auto& e : expected) {
+        QVERIFY(!cache->isEmpty(0));
+        const Cache::Row row = cache->readFrontRow(0);
+        QCOMPARE(row.step(), std::get<0>(e));
+        QCOMPARE(row.at(0), Value(std::get<1>(e)));
+        QCOMPARE(row.at(1), Value(std::get<2>(e)));
+        cache->flushFrontRow(0);
+    }
+    QVERIFY(cache->isEmpty(0));
+}
+
+// the outputs of an attribute share a single pass over its values
+void TestOutput::tst_groups()
+{
+    Model model(4); // n: 0, 1, 2, 0; w: 0, 0.5, 1, 1.5
+    auto meanN = std::make_shared<DefaultOutput>(DefaultOutput::F_Mean, DefaultOutput::E_Nodes, m_n);
+    auto maxN = std::make_shared<DefaultOutput>(DefaultOutput::F_Max, DefaultOutput::E_Nodes, m_n);
+    auto countN = std::make_shared<DefaultOutput>(DefaultOutput::F_Count, DefaultOutput::E_Nodes, m_n);
+    auto sumW = std::make_shared<DefaultOutput>(DefaultOutput::F_Sum, DefaultOutput::E_Nodes, m_w,
+                                                Sampling(Sampling::EveryN, 2));
+    Cache* cMeanN = meanN->addCache({Value("")}, {0});
+    Cache* cMaxN = maxN->addCache({Value("")}, {0});
+    Cache* cCountN = countN->addCache({Value(0)}, {0});
+    Cache* cSumW = sumW->addCache({Value("")}, {0});
+    OutputPlanner planner;
+    planner.plan({meanN, maxN, countN, sumW});
+    QCOMPARE(planner.numGroups(), 2);
+
+    // n and w, plus building the histogram of n
+    model.setStep(0);
+    QCOMPARE(planner.doOperation(0, &model, false), 3);
+    QCOMPARE(cMeanN->readFrontRow(0).at(0), Value(0.75));
+    QCOMPARE(cMaxN->readFrontRow(0).at(0), Value(2.0));
+    QCOMPARE(cCountN->readFrontRow(0).at(0), Value(2));
+    QCOMPARE(cSumW->readFrontRow(0).at(0), Value(3.0));
+
+    // w is not due
+    model.setStep(1);
+    QCOMPARE(planner.doOperation(0, &model, false), 1);
+    model.setStep(2);
+    QCOMPARE(planner.doOperation(0, &model, false), 2);
+
+    for (Cache* c : {cMeanN, cMaxN, cCountN}) {
+        for (int step = 0; step < 3; ++step) {
+            QCOMPARE(c->readFrontRow(0).step(), step);
+            c->flushFrontRow(0);
+        }
+        QVERIFY(c->isEmpty(0));
+    }
+    for (int step = 0; step < 3; step += 2) {
+        QCOMPARE(cSumW->readFrontRow(0).step(), step);
+        cSumW->flushFrontRow(0);
+    }
+    QVERIFY(cSumW->isEmpty(0));
+}
+
+QTEST_MAIN(TestOutput)
+#include "tst_output.moc"
@@ -0,0 +1,96 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <atomic>
+#include <vector>
+#include <parallelfor.h>
+
+using namespace evoplex;
+
+class TestParallelFor: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_empty();
+    void tst_blocks();
+    void tst_coverage();
+};
+
+void TestParallelFor::tst_empty()
+{
+    int calls = 0;
+    ParallelFor::run(0, [&calls](int, int) { ++calls; });
+    QCOMPARE(calls, 0);
+
+    // a single block runs in the calling thread
+    ParallelFor::run(10, [&calls](int begin, int end) {
+        QCOMPARE(begin, 0);
+        QCOMPARE(end, 10);
+        ++calls;
+    });
+    QCOMPARE(calls, 1);
+}
+
+// the block boundaries only depend on the size and block size
+void TestParallelFor::tst_blocks()
+{
+    const int kSize = 1003;
+    const int kBlockSize = 100;
+    std::vector<int> blockBegin(11, -1);
+    std::vector<int> blockEnd(11, -1);
+    ParallelFor::run(kSize, [&](int begin, int end) {
+        const int block = begin / kBlockSize;
+        blockBegin[block] = begin;
+        blockEnd[block] = end;
+    }, kBlockSize);
+
+    for (int b = 0; b < 10; ++b) {
+        QCOMPARE(blockBegin[b], b * kBlockSize);
+        QCOMPARE(blockEnd[b], (b + 1) * kBlockSize);
+    }
+    QCOMPARE(blockBegin[10], 1000);
+    QCOMPARE(blockEnd[10], kSize);
+}
+
+// every row is visited exactly once
+void TestParallelFor::tst_coverage()
+{
+    const int kSize = ParallelFor::kBlockSize * 50 + 7;
+    std::vector<int> visits(kSize, 0);
+    std::atomic<int> rows(0);
+    ParallelFor::run(kSize, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+        rows += end - begin;
+    });
+
+    QCOMPARE(rows.load(), kSize);
+    for (int v : visits) {
+        QCOMPARE(v, 1);
+    }
+}
+
+QTEST_MAIN(TestParallelFor)
+#include "tst_parallelfor.moc"
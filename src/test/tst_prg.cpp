@@ -19,6 +19,8 @@
  */
 
 #include <QtTest>
+#include <climits>
+#include <vector>
 #include <prg.h>
 
 using namespace evoplex;
@@ -35,6 +37,11 @@ private slots:
     void tst_randI();
     void tst_randS();
     void tst_randF();
+    void tst_philox();
+    void tst_split();
+    void tst_jump();
+    void tst_fill();
+    void tst_samplers();
 };
 
 void TestPRG::tst_prg()
@@ -190,5 +197,137 @@ void TestPRG::tst_randF()
 
     delete prg;
 }
+
+// known-answer tests from the Random123 library
+void TestPRG::tst_philox()
+{
+    Philox4x32::Counter r = Philox4x32::generate({{0, 0, 0, 0}}, {{0, 0}});
+    QCOMPARE(r[0], 0x6627e8d5u);
+    QCOMPARE(r[1], 0xe169c58du);
+    QCOMPARE(r[2], 0xbc57ac4cu);
+    QCOMPARE(r[3], 0x9b00dbd8u);
+
+    r = Philox4x32::generate({{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+                             {{0xffffffff, 0xffffffff}});
+    QCOMPARE(r[0], 0x408f276du);
+    QCOMPARE(r[1], 0x41c83b0eu);
+    QCOMPARE(r[2], 0xa20bc7c6u);
+    QCOMPARE(r[3], 0x6d5451fdu);
+
+    r = Philox4x32::generate({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+                             {{0xa4093822, 0x299f31d0}});
+    QCOMPARE(r[0], 0xd16cfe09u);
+    QCOMPARE(r[1], 0x94fdccebu);
+    QCOMPARE(r[2], 0x5001e420u);
+    QCOMPARE(r[3], 0x24126ea1u);
+}
+
+void TestPRG::tst_split()
+{
+    PRG prg(123);
+    PRG s1 = prg.split(1);
+    PRG s2 = prg.split(2);
+    QVERIFY(s1() != s2());
+
+    // it does not depend on the numbers drawn from the parent
+    prg.randD();
+    PRG s1b = prg.split(1);
+    PRG s1c = PRG(123).split(1);
+    const PRG::result_type v = s1c();
+    QCOMPARE(s1b(), v);
+
+    // nor on the seed only
+    QVERIFY(PRG(124).split(1)() != v);
+    QVERIFY(PRG(123).split(1).split(1)() != v);
+}
+
+void TestPRG::tst_jump()
+{
+    for (int drawn = 0; drawn < 6; ++drawn) {
+        for (int n = 0; n < 10; ++n) {
+            PRG prg1(7);
+            PRG prg2(7);
+            for (int i = 0; i < drawn; ++i) {
+                prg1();
+                prg2();
+            }
+            prg1.jump(n);
+            for (int i = 0; i < n; ++i) {
+                prg2();
+            }
+            QCOMPARE(prg1(), prg2());
+            QCOMPARE(prg1.randD(), prg2.randD());
+        }
+    }
+}
+
+void TestPRG::tst_fill()
+{
+    // fillD is the same as calling randD() n times
+    for (int drawn = 0; drawn < 6; ++drawn) {
+        PRG prg1(9);
+        PRG prg2(9);
+        for (int i = 0; i < drawn; ++i) {
+            prg1();
+            prg2();
+        }
+        std::vector<double> v(37);
+        prg1.fillD(v.data(), v.size());
+        for (double d : v) {
+            QCOMPARE(d, prg2.randD());
+            QVERIFY(d >= 0.0 && d < 1.0);
+        }
+        QCOMPARE(prg1(), prg2());
+    }
+
+    PRG prg(0);
+    std::vector<int> v(1000);
+    prg.fillI(v.data(), v.size(), -5, 5);
+    for (int i : v) {
+        QVERIFY(i >= -5 && i <= 5);
+    }
+}
+
+void TestPRG::tst_samplers()
+{
+    PRG prg(0);
+
+    // all values in the range are drawn
+    IntSampler is(-2, 2);
+    QCOMPARE(is.min(), -2);
+    QCOMPARE(is.max(), 2);
+    std::vector<int> count(5, 0);
+    for (int i = 0; i < 1000; ++i) {
+        const int v = is(prg);
+        QVERIFY(v >= -2 && v <= 2);
+        ++count[v + 2];
+    }
+    for (int c : count) {
+        QVERIFY(c > 0);
+    }
+
+    // full range and single value
+    IntSampler(INT_MIN, INT_MAX)(prg);
+    QCOMPARE(IntSampler(7, 7)(prg), 7);
+
+    std::vector<int> v(1001);
+    is.fill(prg, v.data(), v.size());
+    for (int i : v) {
+        QVERIFY(i >= -2 && i <= 2);
+    }
+
+    RealSampler rs(-1.0, 1.0);
+    std::vector<double> d(1001);
+    rs.fill(prg, d.data(), d.size());
+    for (double x : d) {
+        QVERIFY(x >= -1.0 && x < 1.0);
+    }
+
+    // bounded() is in [0, range)
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(prg.bounded(3) < 3u);
+    }
+}
+
 QTEST_MAIN(TestPRG)
 #include "tst_prg.moc"
@@ -0,0 +1,121 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <thread>
+#include <rowring.h>
+
+using namespace evoplex;
+
+class TestRowRing: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_pushPop();
+    void tst_segments();
+    void tst_clear();
+    void tst_concurrent();
+};
+
+void TestRowRing::tst_pushPop()
+{
+    RowRing ring(2);
+    QCOMPARE(ring.numCols(), 2);
+    QVERIFY(ring.isEmpty());
+
+    const Values row = {Value(1), Value("a")};
+    ring.push(7, [&](int col) { return row[col]; });
+    QVERIFY(!ring.isEmpty());
+
+    RowRing::Row r = ring.front();
+    QCOMPARE(r.step(), 7);
+    QCOMPARE(r.size(), 2);
+    QCOMPARE(r.at(0), Value(1));
+    QCOMPARE(r.at(1), Value("a"));
+    ring.pop();
+    QVERIFY(ring.isEmpty());
+}
+
+// rows keep their order across segments
+void TestRowRing::tst_segments()
+{
+    RowRing ring(3, 4);
+    for (int round = 0; round < 3; ++round) {
+        for (int step = 0; step < 10; ++step) {
+            ring.push(step, [&](int col) { return Value(step * 10 + col); });
+        }
+        for (int step = 0; step < 10; ++step) {
+            QVERIFY(!ring.isEmpty());
+            RowRing::Row r = ring.front();
+            QCOMPARE(r.step(), step);
+            for (int col = 0; col < 3; ++col) {
+                QCOMPARE(r.at(col), Value(step * 10 + col));
+            }
+            ring.pop();
+        }
+        QVERIFY(ring.isEmpty());
+    }
+}
+
+void TestRowRing::tst_clear()
+{
+    RowRing ring(1, 2);
+    for (int step = 0; step < 5; ++step) {
+        ring.push(step, [&](int) { return Value(step); });
+    }
+    ring.clear();
+    QVERIFY(ring.isEmpty());
+    ring.push(9, [](int) { return Value(9); });
+    QCOMPARE(ring.front().step(), 9);
+}
+
+// a reader thread consumes while the writer produces
+void TestRowRing::tst_concurrent()
+{
+    const int kRows = 100000;
+    RowRing ring(2, 64);
+    std::thread producer([&]() {
+        for (int step = 0; step < kRows; ++step) {
+            ring.push(step, [&](int col) { return Value(step + col); });
+        }
+    });
+
+    bool ordered = true;
+    int next = 0;
+    while (next < kRows) {
+        if (ring.isEmpty()) {
+            std::this_thread::yield();
+            continue;
+        }
+        RowRing::Row r = ring.front();
+        ordered &= r.step() == next && r.at(0) == Value(next) && r.at(1) == Value(next + 1);
+        ring.pop();
+        ++next;
+    }
+    producer.join();
+    QVERIFY(ordered);
+    QVERIFY(ring.isEmpty());
+}
+
+QTEST_MAIN(TestRowRing)
+#include "tst_rowring.moc"
@@ -0,0 +1,116 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <vector>
+#include <sampling.h>
+
+using namespace evoplex;
+
+class TestSampling: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_fromString();
+    void tst_everyN();
+    void tst_logSpaced();
+    void tst_final();
+
+private:
+    std::vector<int> dueSteps(const Sampling& s, int lastStep);
+};
+
+std::vector<int> TestSampling::dueSteps(const Sampling& s, int lastStep)
+{
+    std::vector<int> steps;
+    for (int step = 0; step <= lastStep; ++step) {
+        if (s.isDue(step, step == lastStep)) {
+            steps.emplace_back(step);
+        }
+    }
+    return steps;
+}
+
+void TestSampling::tst_fromString()
+{
+    bool ok;
+    QCOMPARE(Sampling::fromString("", &ok), Sampling());
+    QVERIFY(ok);
+    QCOMPARE(Sampling::fromString("every100", &ok), Sampling(Sampling::EveryN, 100));
+    QVERIFY(ok);
+    QCOMPARE(Sampling::fromString("log10", &ok), Sampling(Sampling::LogSpaced, 10));
+    QVERIFY(ok);
+    QCOMPARE(Sampling::fromString("final", &ok).mode(), Sampling::Final);
+    QVERIFY(ok);
+    QCOMPARE(Sampling::fromString("change", &ok).mode(), Sampling::OnChange);
+    QVERIFY(ok);
+
+    // every single step is the default
+    QCOMPARE(Sampling::fromString("every1", &ok), Sampling());
+    QVERIFY(ok);
+
+    for (const char* invalid : {"every", "every0", "every-5", "log", "logx", "always"}) {
+        QCOMPARE(Sampling::fromString(invalid, &ok), Sampling());
+        QVERIFY(!ok);
+    }
+
+    // round trip
+    for (const char* str : {"", "every7", "log3", "final", "change"}) {
+        QCOMPARE(Sampling::fromString(str).toString(), QString(str));
+    }
+}
+
+void TestSampling::tst_everyN()
+{
+    QCOMPARE(dueSteps(Sampling(), 3), std::vector<int>({0, 1, 2, 3}));
+    // the last step is always recorded
+    QCOMPARE(dueSteps(Sampling(Sampling::EveryN, 10), 25), std::vector<int>({0, 10, 20, 25}));
+    QCOMPARE(dueSteps(Sampling(Sampling::EveryN, 10), 30), std::vector<int>({0, 10, 20, 30}));
+}
+
+void TestSampling::tst_logSpaced()
+{
+    // one step per decade
+    QCOMPARE(dueSteps(Sampling(Sampling::LogSpaced, 1), 1000),
+             std::vector<int>({0, 1, 10, 100, 1000}));
+
+    // two steps per decade: the first step >= 10^(k/2)
+    QCOMPARE(dueSteps(Sampling(Sampling::LogSpaced, 2), 100),
+             std::vector<int>({0, 1, 4, 10, 32, 100}));
+
+    // the number of samples grows with the log of the number of steps
+    const Sampling s(Sampling::LogSpaced, 10);
+    const int n = static_cast<int>(dueSteps(s, 1000000).size());
+    QVERIFY(n <= 2 + 10 * 6);
+    QVERIFY(n >= 6 * 6);
+}
+
+void TestSampling::tst_final()
+{
+    QCOMPARE(dueSteps(Sampling(Sampling::Final), 50), std::vector<int>({50}));
+    // values have to be computed at every step to detect changes
+    QCOMPARE(dueSteps(Sampling(Sampling::OnChange), 3), std::vector<int>({0, 1, 2, 3}));
+}
+
+QTEST_MAIN(TestSampling)
+#include "tst_sampling.moc"
@@ -0,0 +1,143 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <cmath>
+#include <vector>
+#include <prg.h>
+#include <stats.h>
+
+using namespace evoplex;
+
+class TestStats: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_summary();
+    void tst_arrays();
+    void tst_hist();
+    void tst_quantiles();
+};
+
+void TestStats::tst_summary()
+{
+    Summary s;
+    QCOMPARE(s.count(), 0);
+    QVERIFY(std::isnan(s.mean()));
+    QVERIFY(std::isnan(s.min()));
+
+    for (double x : {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0}) {
+        s.add(x);
+    }
+    QCOMPARE(s.count(), 8);
+    QCOMPARE(s.sum(), 40.0);
+    QCOMPARE(s.mean(), 5.0);
+    QCOMPARE(s.variance(), 4.0);
+    QCOMPARE(s.min(), 2.0);
+    QCOMPARE(s.max(), 9.0);
+}
+
+// the lanes of the array reduction must agree with one value at a time
+void TestStats::tst_arrays()
+{
+    PRG prg(123);
+    std::vector<int> ints;
+    std::vector<double> doubles;
+    for (int i = 0; i < 1003; ++i) {
+        ints.emplace_back(prg.randI(-50, 50));
+        doubles.emplace_back(1e6 + prg.randD());
+    }
+
+    Summary a, b;
+    a.add(ints.data(), ints.data() + ints.size());
+    for (int x : ints) {
+        b.add(x);
+    }
+    QCOMPARE(a.count(), b.count());
+    QCOMPARE(a.sum(), b.sum());
+    QCOMPARE(a.min(), b.min());
+    QCOMPARE(a.max(), b.max());
+    QVERIFY(std::abs(a.variance() - b.variance()) < 1e-9);
+
+    // the shift keeps the variance of large values accurate
+    Summary c, d;
+    c.add(doubles.data(), doubles.data() + doubles.size());
+    for (double x : doubles) {
+        d.add(x);
+    }
+    QVERIFY(std::abs(c.mean() - d.mean()) < 1e-6);
+    QVERIFY(std::abs(c.variance() - 1.0 / 12.0) < 0.01);
+    QVERIFY(std::abs(c.variance() - d.variance()) < 1e-9);
+}
+
+void TestStats::tst_hist()
+{
+    Summary s({0.0, 1.0, 2.5});
+    const std::vector<double> values = {-1.0, 0.0, 0.5, 1.0, 2.4, 2.5, 10.0};
+    s.add(values.data(), values.data() + values.size());
+    QCOMPARE(s.bins(), std::vector<int>({2, 2, 2}));
+    QCOMPARE(s.count(), 7);
+
+    // coarser bins are sums of the finer ones
+    QCOMPARE(s.binCount(0.0, 2.5), 4);
+    QCOMPARE(s.binCount(1.0, 100.0), 4);
+}
+
+void TestStats::tst_quantiles()
+{
+    // exact while there are fewer than five values
+    Summary few({}, {0.0, 0.5, 1.0});
+    for (double x : {3.0, 1.0, 2.0}) {
+        few.add(x);
+    }
+    QCOMPARE(few.quantile(0), 1.0);
+    QCOMPARE(few.quantile(1), 2.0);
+    QCOMPARE(few.quantile(2), 3.0);
+
+    // uniform values in [0,1)
+    Summary s({}, {0.1, 0.5, 0.9});
+    PRG prg(42);
+    for (int i = 0; i < 100000; ++i) {
+        s.add(prg.randD());
+    }
+    QVERIFY(std::abs(s.quantile(0) - 0.1) < 0.01);
+    QVERIFY(std::abs(s.quantile(1) - 0.5) < 0.01);
+    QVERIFY(std::abs(s.quantile(2) - 0.9) < 0.01);
+    QCOMPARE(s.quantileOf(0.5), s.quantile(1));
+    QVERIFY(std::isnan(s.quantileOf(0.25)));
+
+    // the extremes are exact
+    Summary e({}, {0.0, 1.0});
+    for (int i = 0; i < 100; ++i) {
+        e.add(i);
+    }
+    QCOMPARE(e.quantileOf(0.0), 0.0);
+    QCOMPARE(e.quantileOf(1.0), 99.0);
+
+    P2Quantile q(0.5);
+    QVERIFY(std::isnan(q.value()));
+    QCOMPARE(q.probability(), 0.5);
+}
+
+QTEST_MAIN(TestStats)
+#include "tst_stats.moc"
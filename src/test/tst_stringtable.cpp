@@ -0,0 +1,133 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <stringtable.h>
+#include <value.h>
+
+using namespace evoplex;
+
+class TestStringTable: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_intern();
+    void tst_roundTrip();
+    void tst_concurrent();
+};
+
+// each distinct string gets a single symbol, which never changes
+void TestStringTable::tst_intern()
+{
+    QCOMPARE(StringTable::intern(""), quint32(0));
+    QCOMPARE(StringTable::intern(nullptr), quint32(0));
+    QCOMPARE(StringTable::intern("abc", 0), quint32(0));
+    QCOMPARE(StringTable::str(0), "");
+
+    const int size = StringTable::size();
+    const quint32 a = StringTable::intern("tst_intern_a");
+    const quint32 b = StringTable::intern("tst_intern_b");
+    QVERIFY(a != 0 && b != 0 && a != b);
+    QCOMPARE(StringTable::size(), size + 2);
+
+    // the same string, however it is given, is not added again
+    QCOMPARE(StringTable::intern("tst_intern_a"), a);
+    QCOMPARE(StringTable::intern("tst_intern_a_suffix", 12), a);
+    const QByteArray copy("tst_intern_b");
+    QCOMPARE(StringTable::intern(copy.constData(), copy.size()), b);
+    QCOMPARE(StringTable::size(), size + 2);
+
+    // the strings are not moved by the later ones
+    const char* s = StringTable::str(a);
+    for (int i = 0; i < 1000; ++i) {
+        StringTable::intern((QByteArray("tst_intern_") + QByteArray::number(i)).constData());
+    }
+    QCOMPARE(StringTable::str(a), s);
+    QCOMPARE(StringTable::intern("tst_intern_a"), a);
+}
+
+// strings come back as they were given, through the table and through Value
+void TestStringTable::tst_roundTrip()
+{
+    const char* strs[] = { "x", "tst_roundTrip", "with spaces, and commas", "\xce\xb2eta" };
+    for (const char* str : strs) {
+        const quint32 symbol = StringTable::intern(str);
+        QCOMPARE(StringTable::str(symbol), str);
+
+        const Value v(str);
+        QVERIFY(v.isString());
+        QCOMPARE(v.toSymbol(), symbol);
+        QCOMPARE(v.toString(), str);
+        QCOMPARE(Value(QString::fromUtf8(str)).toSymbol(), symbol);
+        QCOMPARE(v.toQString(), QString::fromUtf8(str));
+    }
+}
+
+// symbols are resolved while another thread keeps adding strings,
+// enough of them to take more than one chunk of the table
+void TestStringTable::tst_concurrent()
+{
+    const int kStrings = 70000;
+    std::vector<quint32> symbols(kStrings);
+    std::atomic<int> published(0);
+
+    std::thread writer([&]() {
+        for (int i = 0; i < kStrings; ++i) {
+            const QByteArray str = QByteArray("tst_concurrent_") + QByteArray::number(i);
+            symbols[i] = StringTable::intern(str.constData(), str.size());
+            published.store(i + 1, std::memory_order_release);
+        }
+    });
+
+    auto read = [&](bool& ok, int stride) {
+        int i = 0;
+        while (i < kStrings) {
+            const int n = published.load(std::memory_order_acquire);
+            for (; i < n; i += stride) {
+                const QByteArray expected = QByteArray("tst_concurrent_") + QByteArray::number(i);
+                ok = ok && std::strcmp(StringTable::str(symbols[i]), expected.constData()) == 0
+                        && StringTable::intern(expected.constData(), expected.size()) == symbols[i];
+            }
+            std::this_thread::yield();
+        }
+    };
+    bool ok1 = true;
+    bool ok2 = true;
+    std::thread reader([&]() { read(ok1, 7); });
+    read(ok2, 3);
+    writer.join();
+    reader.join();
+    QVERIFY(ok1);
+    QVERIFY(ok2);
+
+    std::vector<quint32> sorted(symbols);
+    std::sort(sorted.begin(), sorted.end());
+    QVERIFY(std::unique(sorted.begin(), sorted.end()) == sorted.end());
+}
+
+QTEST_MAIN(TestStringTable)
+#include "tst_stringtable.moc"
@@ -0,0 +1,176 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#include <thread>
+#include <vector>
+#include <topologycache.h>
+
+using namespace evoplex;
+
+class TestTopologyCache: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() { QVERIFY(m_dir.isValid()); }
+    void cleanupTestCase() {}
+    void tst_shared();
+    void tst_keys();
+    void tst_changedFile();
+    void tst_invalid();
+    void tst_concurrent();
+
+private:
+    QTemporaryDir m_dir;
+
+    QString writeFile(const QString& name, const QByteArray& bytes);
+};
+
+QString TestTopologyCache::writeFile(const QString& name, const QByteArray& bytes)
+{
+    const QString fpath = m_dir.path() + "/" + name;
+    QFile file(fpath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(bytes) != bytes.size()) {
+        return QString();
+    }
+    return fpath;
+}
+
+// all the requests for the same file get the same edges
+void TestTopologyCache::tst_shared()
+{
+    const QString fpath = writeFile("shared.csv", "origin,target\n0,1\n1,2\n");
+    TopologyCache cache;
+    QString error;
+    EdgeListPtr e1 = cache.edges(fpath, 1, 3, &error);
+    QVERIFY(e1);
+    QCOMPARE(e1->size(), 2);
+    EdgeListPtr e2 = cache.edges(fpath, 1, 3, &error);
+    QCOMPARE(e1.get(), e2.get());
+    QCOMPARE(cache.size(), 1);
+
+    // the edges outlive the cache entries
+    cache.clear();
+    QCOMPARE(cache.size(), 0);
+    QCOMPARE(e1->target(1), 2);
+    EdgeListPtr e3 = cache.edges(fpath, 1, 3, &error);
+    QVERIFY(e3.get() != e1.get());
+    QCOMPARE(e3->size(), 2);
+}
+
+void TestTopologyCache::tst_keys()
+{
+    const QString fpath = writeFile("keys.csv", "origin,target\n0,1\n");
+    TopologyCache cache;
+    EdgeListPtr e1 = cache.edges(fpath, 1, 2);
+    EdgeListPtr e2 = cache.edges(fpath, 2, 2); // another graph type
+    EdgeListPtr e3 = cache.edges(fpath, 1, 5); // another number of nodes
+    QVERIFY(e1 && e2 && e3);
+    QVERIFY(e1.get() != e2.get());
+    QVERIFY(e1.get() != e3.get());
+    QCOMPARE(cache.size(), 3);
+
+    // the edges are validated against the number of nodes
+    QString error;
+    QVERIFY(!cache.edges(fpath, 1, 1, &error));
+    QVERIFY(!error.isEmpty());
+    QCOMPARE(cache.size(), 3);
+}
+
+// a file which changes on disk is read again
+void TestTopologyCache::tst_changedFile()
+{
+    const QString fpath = writeFile("changed.csv", "origin,target\n0,1\n");
+    TopologyCache cache;
+    EdgeListPtr e1 = cache.edges(fpath, 1, 3);
+    QVERIFY(e1);
+    QCOMPARE(e1->size(), 1);
+
+    const QDateTime lastModified = QFileInfo(fpath).lastModified();
+    for (int i = 0; i < 300 && QFileInfo(fpath).lastModified() == lastModified; ++i) {
+        QThread::msleep(10);
+        writeFile("changed.csv", "origin,target\n0,1\n1,2\n");
+    }
+    QVERIFY(QFileInfo(fpath).lastModified() != lastModified);
+
+    EdgeListPtr e2 = cache.edges(fpath, 1, 3);
+    QVERIFY(e2);
+    QCOMPARE(e2->size(), 2);
+    QCOMPARE(cache.size(), 1); // the old version was dropped
+    QCOMPARE(e1->size(), 1);
+}
+
+void TestTopologyCache::tst_invalid()
+{
+    TopologyCache cache;
+    QString error;
+    QVERIFY(!cache.edges(m_dir.path() + "/doesNotExist.csv", 1, 3, &error));
+    QVERIFY(!error.isEmpty());
+    QCOMPARE(cache.size(), 0);
+}
+
+// the trials of experiments ask for the same files at the same time
+void TestTopologyCache::tst_concurrent()
+{
+    QByteArray bytes("origin,target\n");
+    for (int i = 0; i < 10000; ++i) {
+        bytes += QByteArray::number(i % 100) + "," + QByteArray::number((i + 1) % 100) + "\n";
+    }
+    const QStringList fpaths = { writeFile("concurrent.csv", bytes),
+                                 writeFile("concurrent2.csv", bytes + "0,0\n") };
+
+    // each file is read once, whatever the others are doing; a file which
+    // fails (too few nodes) is reported to all the trials and not cached
+    TopologyCache cache;
+    std::vector<EdgeListPtr> edges(12);
+    std::vector<QString> errors(edges.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < edges.size(); ++t) {
+        threads.emplace_back([&cache, &edges, &errors, &fpaths, t]() {
+            const int file = static_cast<int>(t % 3);
+            edges[t] = cache.edges(fpaths.at(file % 2), 1, file < 2 ? 100 : 50, &errors[t]);
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    for (size_t t = 0; t < edges.size(); ++t) {
+        if (t % 3 == 2) {
+            QVERIFY(!edges[t]);
+            QVERIFY(!errors[t].isEmpty());
+        } else {
+            QVERIFY(edges[t]);
+            QVERIFY(errors[t].isEmpty());
+            QCOMPARE(edges[t].get(), edges[t % 3].get());
+        }
+    }
+    QCOMPARE(edges[0]->size(), 10000);
+    QCOMPARE(edges[1]->size(), 10001);
+    QCOMPARE(cache.size(), 2);
+}
+
+QTEST_MAIN(TestTopologyCache)
+#include "tst_topologycache.moc"
@@ -303,6 +303,16 @@ void TestValue::tst_valueString()
     QCOMPARE(Value(vString), vString);
     QCOMPARE(Value(vString).isString(), true);
     QCOMPARE(Value(vString).toString(), "evoplex");
+
+    // strings are interned, so equal strings share the symbol and the data
+    const Value v3(QString("abc$"));
+    QCOMPARE(v3, v1);
+    QCOMPARE(v3.toSymbol(), v1.toSymbol());
+    QVERIFY(v3.toString() == v1.toString());
+    QVERIFY(v2.toSymbol() != v1.toSymbol());
+    QCOMPARE(std::hash<Value>()(v3), std::hash<Value>()(v1));
+    QCOMPARE(Value("").toSymbol(), quint32(0));
+    QCOMPARE(Value(QString()).toString(), "");
 }
 
 QTEST_MAIN(TestValue)